@@ -40,6 +40,62 @@
 #   define KURLYK_ENABLE_JSON 0
 #endif
 
+/// \def KURLYK_HTTP_MAX_POOLED_HANDLES
+/// \brief Maximum number of idle CURL easy handles kept for reuse by the HTTP request manager.
+/// Set to 0 to create and destroy an easy handle for every request.
+#ifndef KURLYK_HTTP_MAX_POOLED_HANDLES
+#   define KURLYK_HTTP_MAX_POOLED_HANDLES 64
+#endif
+
+/// \def KURLYK_HTTP_SHARE_COOKIES
+/// \brief Shares cookies between all HTTP requests through the libcurl share object.
+/// Set to 1 to let cookies received by one request be sent by all others, or 0 to keep them per request.
+#ifndef KURLYK_HTTP_SHARE_COOKIES
+#   define KURLYK_HTTP_SHARE_COOKIES 0
+#endif
+
+/// \def KURLYK_ENABLE_METRICS
+/// \brief Enables the built-in metrics updated by the network worker, HTTP and WebSocket modules.
+/// Set to 0 to compile out all library instrumentation; the metrics registry remains available for user metrics.
+#ifndef KURLYK_ENABLE_METRICS
+#   define KURLYK_ENABLE_METRICS 1
+#endif
+
+/// \def KURLYK_ENABLE_TRACING
+/// \brief Records the lifecycle stages of every HTTP request in kurlyk::tracing::Tracer.
+/// Set to 1 to enable; with 0 the tracing hooks compile to nothing.
+#ifndef KURLYK_ENABLE_TRACING
+#   define KURLYK_ENABLE_TRACING 0
+#endif
+
+/// \def KURLYK_TRACE_BUFFER_SIZE
+/// \brief Maximum number of spans kept by kurlyk::tracing::Tracer; older spans are overwritten.
+#ifndef KURLYK_TRACE_BUFFER_SIZE
+#   define KURLYK_TRACE_BUFFER_SIZE 65536
+#endif
+
+/// \def KURLYK_HTTP_PRIORITY_AGING_MS
+/// \brief Time in milliseconds after which a queued HTTP request is promoted by one priority class.
+/// Promotion stops at RequestPriority::RP_HIGH. Set to 0 to disable aging.
+#ifndef KURLYK_HTTP_PRIORITY_AGING_MS
+#   define KURLYK_HTTP_PRIORITY_AGING_MS 1000
+#endif
+
+/// \def KURLYK_HTTP_CACHE_MAX_BYTES
+/// \brief Default size limit of the in-memory HTTP response cache, in bytes.
+/// Only requests with HttpRequest::use_cache set are cached.
+#ifndef KURLYK_HTTP_CACHE_MAX_BYTES
+#   define KURLYK_HTTP_CACHE_MAX_BYTES (64 * 1024 * 1024)
+#endif
+
+/// \def KURLYK_HTTP_WORKER_SHARDS
+/// \brief Number of threads performing HTTP transfers, each with its own libcurl multi handle.
+/// Requests are routed to a shard by their shard key or URL origin, and their callbacks run on that shard's thread.
+/// Set to 0 to perform all transfers on the NetworkWorker thread.
+#ifndef KURLYK_HTTP_WORKER_SHARDS
+#   define KURLYK_HTTP_WORKER_SHARDS 0
+#endif
+
 #ifdef __EMSCRIPTEN__
 #   define KURLYK_USE_EMSCRIPTEN    ///< Defines the use of Emscripten-specific WebSocket handling.
 #else
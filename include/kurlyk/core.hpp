@@ -11,11 +11,18 @@
 #include <string>
 #include <cstring>
 #include <functional>
+#include <limits>
+#include <fstream>
+#include <iterator>
 #include <future>
 #include <vector>
+#include <array>
 #include <list>
+#include <deque>
+#include <map>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <system_error>
 #include <memory>
 #include <atomic>
@@ -26,8 +33,13 @@
 // Internal modules
 #include "types.hpp"
 #include "utils.hpp"
+#include "metrics.hpp"
+#include "tracing.hpp"
 
 #include "core/INetworkTaskManager.hpp"
+#include "core/TimerQueue.hpp"
+#include "core/ICallbackExecutor.hpp"
 #include "core/NetworkWorker.hpp"
+#include "core/CallbackThreadPool.hpp"
 
 #endif // _KURLYK_CORE_HPP_INCLUDED
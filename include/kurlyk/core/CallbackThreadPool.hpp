@@ -0,0 +1,107 @@
+#pragma once
+#ifndef _KURLYK_CORE_CALLBACK_THREAD_POOL_HPP_INCLUDED
+#define _KURLYK_CORE_CALLBACK_THREAD_POOL_HPP_INCLUDED
+
+/// \file CallbackThreadPool.hpp
+/// \brief Defines a fixed-size thread pool that runs user callbacks with per-key ordering.
+
+namespace kurlyk::core {
+
+    /// \class CallbackThreadPool
+    /// \brief Fixed-size thread pool implementing ICallbackExecutor.
+    ///
+    /// Every thread owns a FIFO queue, and a task is queued to the thread selected by its key,
+    /// so tasks of one client always run sequentially and in order. A slow callback delays only
+    /// the clients mapped to the same thread, never the network worker.
+    class CallbackThreadPool final : public ICallbackExecutor {
+    public:
+
+        /// \brief Starts the pool.
+        /// \param thread_count Number of threads; 0 selects the number of hardware threads.
+        explicit CallbackThreadPool(std::size_t thread_count = 0) {
+            if (!thread_count) thread_count = std::thread::hardware_concurrency();
+            if (!thread_count) thread_count = 1;
+            for (std::size_t i = 0; i < thread_count; ++i) {
+#               if __cplusplus >= 201402L
+                m_lanes.push_back(std::make_unique<Lane>());
+#               else
+                m_lanes.push_back(std::unique_ptr<Lane>(new Lane()));
+#               endif
+            }
+            for (auto& lane : m_lanes) {
+                Lane* ptr = lane.get();
+                lane->thread = std::thread([ptr]() { run(*ptr); });
+            }
+        }
+
+        /// \brief Runs the tasks that are still queued and stops the threads.
+        ~CallbackThreadPool() override {
+            for (auto& lane : m_lanes) {
+                std::lock_guard<std::mutex> lock(lane->mutex);
+                lane->stop = true;
+                lane->condition.notify_one();
+            }
+            for (auto& lane : m_lanes) {
+                if (lane->thread.joinable()) lane->thread.join();
+            }
+        }
+
+        CallbackThreadPool(const CallbackThreadPool&) = delete;
+        CallbackThreadPool& operator=(const CallbackThreadPool&) = delete;
+
+        /// \brief Queues a task to the thread selected by the key.
+        /// \param key Ordering key.
+        /// \param task Task to execute.
+        void post(uint64_t key, std::function<void()> task) override {
+            Lane& lane = *m_lanes[std::hash<uint64_t>()(key) % m_lanes.size()];
+            std::lock_guard<std::mutex> lock(lane.mutex);
+            lane.tasks.push_back(std::move(task));
+            lane.condition.notify_one();
+        }
+
+        /// \brief Returns the number of threads in the pool.
+        /// \return Number of threads.
+        std::size_t size() const {
+            return m_lanes.size();
+        }
+
+    private:
+
+        /// \struct Lane
+        /// \brief Thread of the pool together with its task queue.
+        struct Lane {
+            std::mutex                          mutex;        ///< Mutex protecting the queue and the stop flag.
+            std::condition_variable             condition;    ///< Signalled when a task is queued or the pool stops.
+            std::deque<std::function<void()>>   tasks;        ///< Queued tasks in posting order.
+            bool                                stop = false; ///< Flag requesting the thread to exit once the queue is empty.
+            std::thread                         thread;       ///< Thread running the tasks.
+        };
+
+        std::vector<std::unique_ptr<Lane>> m_lanes; ///< Threads of the pool.
+
+        /// \brief Runs the tasks of a lane until the pool is destroyed.
+        /// \param lane Lane to serve.
+        static void run(Lane& lane) {
+            std::unique_lock<std::mutex> lock(lane.mutex);
+            for (;;) {
+                lane.condition.wait(lock, [&lane]() { return lane.stop || !lane.tasks.empty(); });
+                if (lane.tasks.empty()) return;
+                std::deque<std::function<void()>> tasks;
+                tasks.swap(lane.tasks);
+                lock.unlock();
+                for (auto& task : tasks) {
+                    try {
+                        if (task) task();
+                    } catch(...) {
+                        KURLYK_HANDLE_ERROR(std::current_exception(), "Exception in user callback");
+                    }
+                }
+                lock.lock();
+            }
+        }
+
+    }; // CallbackThreadPool
+
+} // namespace kurlyk::core
+
+#endif // _KURLYK_CORE_CALLBACK_THREAD_POOL_HPP_INCLUDED
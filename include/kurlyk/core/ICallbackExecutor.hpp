@@ -0,0 +1,28 @@
+#pragma once
+#ifndef _KURLYK_CORE_ICALLBACKEXECUTOR_HPP_INCLUDED
+#define _KURLYK_CORE_ICALLBACKEXECUTOR_HPP_INCLUDED
+
+/// \file ICallbackExecutor.hpp
+/// \brief Defines an interface for executors that run user callbacks off the network thread.
+
+namespace kurlyk::core {
+
+    /// \class ICallbackExecutor
+    /// \brief Interface for executors running HTTP completion and WebSocket event callbacks.
+    ///
+    /// Implementations must run tasks posted with the same key one at a time and in the order
+    /// they were posted. Tasks with different keys may run concurrently.
+    class ICallbackExecutor {
+    public:
+
+        /// \brief Schedules a task for execution. Must be safe to call from any thread and must not block for long.
+        /// \param key Ordering key; HTTP clients use their request ID, WebSocket clients their address.
+        /// \param task Task to execute.
+        virtual void post(uint64_t key, std::function<void()> task) = 0;
+
+        virtual ~ICallbackExecutor() = default;
+    };
+
+} // namespace kurlyk::core
+
+#endif // _KURLYK_CORE_ICALLBACKEXECUTOR_HPP_INCLUDED
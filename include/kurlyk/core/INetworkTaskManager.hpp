@@ -11,6 +11,8 @@ namespace kurlyk::core {
     /// \brief Interface for modules managed by NetworkWorker (e.g., HTTP, WebSocket).
     class INetworkTaskManager {
     public:
+        using duration_t = std::chrono::steady_clock::duration;
+
         /// \brief Called periodically to process tasks.
         virtual void process() = 0;
 
@@ -20,6 +22,28 @@ namespace kurlyk::core {
         /// \brief Indicates whether the module has pending or active work.
         virtual const bool is_loaded() const = 0;
 
+        /// \brief Returns how long the worker may sleep before the module must be processed again.
+        ///
+        /// The default implementation keeps the legacy 1 ms polling interval while the module is loaded.
+        /// \return Time until the next deadline, or `duration_t::max()` if only a notification can produce new work.
+        virtual duration_t get_wait_timeout() const {
+            if (is_loaded()) return std::chrono::milliseconds(1);
+            return duration_t::max();
+        }
+
+        /// \brief Blocks on the module's own I/O until activity, timeout or wakeup().
+        /// \param timeout Maximum time to block.
+        /// \return True if the module performed the wait; false if the worker must wait on its own.
+        virtual bool wait(duration_t timeout) {
+            (void)timeout;
+            return false;
+        }
+
+        /// \brief Interrupts a blocking wait(). Must be safe to call from any thread.
+        ///
+        /// A wakeup that arrives before wait() starts must make the next wait() return immediately.
+        virtual void wakeup() {}
+
         virtual ~INetworkTaskManager() = default;
     };
 
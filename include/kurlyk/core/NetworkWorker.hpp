@@ -86,14 +86,75 @@ namespace kurlyk::core {
         }
 
         /// \brief Adds a task to the queue and notifies the worker thread.
+        ///
+        /// The task is pushed to a lock-free queue, so concurrent callers never contend on a mutex.
         /// \param task A function or lambda with no arguments to be executed by the worker.
         void add_task(std::function<void()> task) {
-            std::unique_lock<std::mutex> lock(m_tasks_list_mutex);
-            m_tasks_list.push_back(std::move(task));
-            lock.unlock();
+#           if __cplusplus >= 201402L
+            m_tasks.push(std::make_unique<TaskNode>(std::move(task)));
+#           else
+            m_tasks.push(std::unique_ptr<TaskNode>(new TaskNode(std::move(task))));
+#           endif
             notify();
         }
 
+        /// \brief Schedules a callback to run on the worker thread after a delay.
+        ///
+        /// The worker sleeps no longer than the earliest pending timer, so the callback runs as soon as
+        /// the deadline is reached. Callbacks must not block.
+        /// \param delay Time to wait before invoking the callback.
+        /// \param callback Function to invoke on the worker thread.
+        /// \return Timer identifier that can be passed to cancel_timer().
+        TimerQueue::timer_id_t add_timer(TimerQueue::duration_t delay, TimerQueue::callback_t callback) {
+            return add_timer_at(TimerQueue::clock_t::now() + delay, std::move(callback));
+        }
+
+        /// \brief Schedules a callback to run on the worker thread at the specified time.
+        /// \param deadline Time at which the callback is invoked; a past time runs it on the next iteration.
+        /// \param callback Function to invoke on the worker thread.
+        /// \return Timer identifier that can be passed to cancel_timer().
+        TimerQueue::timer_id_t add_timer_at(TimerQueue::time_point_t deadline, TimerQueue::callback_t callback) {
+            const bool is_earliest = deadline < m_timers.next_deadline();
+            const auto id = m_timers.add_timer(deadline, std::move(callback));
+            if (is_earliest) notify();
+            return id;
+        }
+
+        /// \brief Cancels a timer scheduled with add_timer().
+        /// \param id Timer identifier.
+        /// \return True if the timer was pending and will not run.
+        bool cancel_timer(TimerQueue::timer_id_t id) {
+            return m_timers.cancel_timer(id);
+        }
+
+        /// \brief Sets the executor running HTTP completion and WebSocket event callbacks.
+        ///
+        /// Without an executor, callbacks run on the network thread, so a slow callback delays all transfers.
+        /// \param executor Executor to use, or nullptr to run callbacks on the network thread.
+        void set_callback_executor(std::shared_ptr<ICallbackExecutor> executor) {
+            std::lock_guard<std::mutex> lock(m_callback_executor_mutex);
+            m_callback_executor = std::move(executor);
+        }
+
+        /// \brief Returns the executor running user callbacks.
+        /// \return Executor, or nullptr if callbacks run on the network thread.
+        std::shared_ptr<ICallbackExecutor> get_callback_executor() {
+            std::lock_guard<std::mutex> lock(m_callback_executor_mutex);
+            return m_callback_executor;
+        }
+
+        /// \brief Runs a user callback through the callback executor, or immediately if none is set.
+        /// \param key Ordering key; callbacks with the same key run in posting order.
+        /// \param task Callback to run.
+        void post_callback(uint64_t key, std::function<void()> task) {
+            auto executor = get_callback_executor();
+            if (executor) {
+                executor->post(key, std::move(task));
+                return;
+            }
+            task();
+        }
+
         /// \brief Registers a network task manager to be managed by the NetworkWorker.
         /// \param manager Pointer to a manager implementing INetworkTaskManager. Must remain valid during its lifetime.
         void register_manager(INetworkTaskManager* manager) {
@@ -105,27 +166,40 @@ namespace kurlyk::core {
 
         /// \brief Processes all queued tasks and active HTTP and WebSocket requests.
         ///
-        /// Processes pending tasks in the task list and manages network requests in both HTTP and WebSocket managers.
+        /// Runs expired timers, then processes the registered managers and pending tasks in the task list.
         void process() {
+#           if KURLYK_ENABLE_METRICS
+            const auto start_time = std::chrono::steady_clock::now();
+#           endif
+            m_timers.process();
             std::unique_lock<std::mutex> lock(m_managers_mutex);
             for (auto* m : m_managers) m->process();
             lock.unlock();
             process_tasks();
+#           if KURLYK_ENABLE_METRICS
+            metrics::builtin().worker_loop_duration.observe(std::chrono::steady_clock::now() - start_time);
+#           endif
         }
 
         /// \brief Notifies the worker to begin processing requests or tasks.
         ///
         /// Signals the condition variable to wake up the worker thread if it is waiting, allowing tasks to be processed.
+        /// If the worker is blocked inside a manager's own I/O wait (e.g. `curl_multi_poll`), that wait is interrupted too.
         void notify() {
-            std::lock_guard<std::mutex> locker(m_notify_mutex);
-            m_notify_condition.notify_one();
+            std::unique_lock<std::mutex> locker(m_notify_mutex);
             m_notify = true;
+            m_notify_condition.notify_one();
+            locker.unlock();
+            if (INetworkTaskManager* manager = m_waiting_manager.load()) {
+                manager->wakeup();
+            }
         }
 
         /// \brief Starts the worker thread for asynchronous task processing.
         ///
         /// If `use_async` is true, the worker runs in a separate thread, continually processing tasks and network events
-        /// until `stop()` is called.
+        /// until `stop()` is called. Between iterations the thread sleeps until the next socket event, the nearest
+        /// deadline reported by the managers, or a call to `notify()`.
         /// \param use_async Indicates whether the worker should run asynchronously.
         void start(const bool use_async) {
             std::unique_lock<std::mutex> locker(m_is_worker_started_mutex);
@@ -138,40 +212,18 @@ namespace kurlyk::core {
                     std::launch::async,
                     [this] {
                 for (;;) {
-                    std::unique_lock<std::mutex> locker(m_notify_mutex);
-                    m_notify_condition.wait(locker, [this]() { return m_notify; });
-                    m_notify = false;
-                    locker.unlock();
-
                     if (m_shutdown) {
                         shutdown();
                         return;
                     }
 
-                    while (is_loaded()) {
-                        process();
-                        if (m_shutdown) {
-                            shutdown();
-                            return;
-                        }
-
-                        std::unique_lock<std::mutex> locker(m_notify_mutex);
-                        m_notify_condition.wait_for(locker, std::chrono::milliseconds(1), [this] {
-                            return m_notify || m_shutdown;
-                        });
-                        m_notify = false;
-                        locker.unlock();
-
-                        if (m_shutdown) {
-                            shutdown();
-                            return;
-                        }
-                    }
-
+                    process();
                     if (m_shutdown) {
                         shutdown();
                         return;
                     }
+
+                    wait_for_work();
                 }
             }).share();
         }
@@ -193,11 +245,12 @@ namespace kurlyk::core {
 
         /// \brief Shuts down the worker, clearing all active requests and pending tasks.
         ///
-        /// Stops both HTTP and WebSocket managers and processes any remaining tasks in the queue.
+        /// Stops both HTTP and WebSocket managers, drops pending timers and processes any remaining tasks in the queue.
         void shutdown() {
             std::unique_lock<std::mutex> lock(m_managers_mutex);
             for (auto* m : m_managers) m->shutdown();
             lock.unlock();
+            m_timers.clear();
             process_tasks();
         }
 
@@ -209,10 +262,21 @@ namespace kurlyk::core {
         bool                        m_notify = false;                   ///< Flag indicating whether a notification is pending.
         std::mutex                  m_is_worker_started_mutex;          ///< Mutex to control worker thread initialization.
         bool                        m_is_worker_started = false;        ///< Flag indicating if the worker thread is started.
-        mutable std::mutex          m_tasks_list_mutex;                 ///< Mutex for protecting access to the task list.
-        std::list<std::function<void()>> m_tasks_list;                  ///< List of tasks queued for processing by the worker.
+        /// \struct TaskNode
+        /// \brief Queued task linked into the lock-free task queue.
+        struct TaskNode : utils::MpscQueueNode {
+            std::function<void()> task; ///< Task to execute.
+
+            explicit TaskNode(std::function<void()> task) : task(std::move(task)) {}
+        };
+
+        utils::MpscQueue<TaskNode>  m_tasks;                            ///< Lock-free queue of tasks for processing by the worker.
         mutable std::mutex          m_managers_mutex;                   ///< Mutex protecting access to registered managers.
         std::vector<INetworkTaskManager*> m_managers;                   ///< List of registered network task managers.
+        std::atomic<INetworkTaskManager*> m_waiting_manager = ATOMIC_VAR_INIT(nullptr); ///< Manager currently blocking the worker in its own I/O wait.
+        TimerQueue                  m_timers;                           ///< One-shot timers run by the worker thread.
+        std::mutex                  m_callback_executor_mutex;          ///< Mutex guarding m_callback_executor.
+        std::shared_ptr<ICallbackExecutor> m_callback_executor;         ///< Executor running user callbacks; null to run them on the worker thread.
         std::mutex                  m_error_handlers_mutex;             ///< Mutex guarding the error handler list.
         std::vector<ErrorHandler>   m_error_handlers;                   ///< Collection of registered error handlers.
 
@@ -234,26 +298,23 @@ namespace kurlyk::core {
         /// \brief Deleted copy assignment operator to enforce the singleton pattern.
         NetworkWorker& operator=(const NetworkWorker&) = delete;
 
-        /// \brief Processes all tasks in the task list, then clears the list.
+        /// \brief Processes the tasks queued so far.
         ///
-        /// This method moves tasks from the task list to a local list, processes each one, and then clears the local list.
+        /// Tasks added while this method runs (including by the tasks themselves) are left for the next call.
+        /// Must only be called from one thread at a time.
         void process_tasks() {
-            std::unique_lock<std::mutex> lock(m_tasks_list_mutex);
-            if (m_tasks_list.empty()) return;
-            auto tasks_list = std::move(m_tasks_list);
-            m_tasks_list.clear();
-            lock.unlock();
-            for (auto &item : tasks_list) {
-                item();
+            std::size_t count = m_tasks.size();
+            while (count--) {
+                auto node = m_tasks.pop();
+                if (!node) break;
+                if (node->task) node->task();
             }
-            tasks_list.clear();
         }
 
-        /// \brief Checks if there are any pending tasks in the task list.
+        /// \brief Checks if there are any pending tasks in the task queue.
         /// \return True if there are pending tasks, otherwise false.
         const bool has_pending_tasks() const {
-            std::lock_guard<std::mutex> lock(m_tasks_list_mutex);
-            return !m_tasks_list.empty();
+            return !m_tasks.empty();
         }
 
         /// \brief Checks if the NetworkWorker has pending tasks or active network events.
@@ -266,7 +327,64 @@ namespace kurlyk::core {
                 if (m->is_loaded()) return true;
             }
             lock.unlock();
-            return has_pending_tasks();
+            return has_pending_tasks() || !m_timers.empty();
+        }
+
+        /// \brief Blocks the worker thread until there is something to process.
+        ///
+        /// The sleep ends on `notify()`, on the nearest timer or deadline reported by the registered managers,
+        /// or on socket activity when a manager (such as the HTTP manager) can block on its own I/O.
+        void wait_for_work() {
+            using duration_t = INetworkTaskManager::duration_t;
+
+            std::unique_lock<std::mutex> lock(m_managers_mutex);
+            std::vector<INetworkTaskManager*> managers = m_managers;
+            lock.unlock();
+
+            duration_t timeout = duration_t::max();
+            if (has_pending_tasks()) {
+                timeout = duration_t::zero();
+            } else {
+                timeout = m_timers.time_until_next();
+                for (auto* m : managers) {
+                    timeout = std::min(timeout, m->get_wait_timeout());
+                }
+            }
+
+            if (timeout > duration_t::zero()) {
+                for (auto* m : managers) {
+                    // Publish the waiting manager before checking the notify flag, so that a concurrent
+                    // notify() either is seen here or reaches the manager through wakeup().
+                    m_waiting_manager.store(m);
+                    std::unique_lock<std::mutex> locker(m_notify_mutex);
+                    if (m_notify || m_shutdown) {
+                        m_notify = false;
+                        locker.unlock();
+                        m_waiting_manager.store(nullptr);
+                        return;
+                    }
+                    locker.unlock();
+
+                    const bool waited = m->wait(timeout);
+                    m_waiting_manager.store(nullptr);
+                    if (waited) {
+                        std::lock_guard<std::mutex> locker(m_notify_mutex);
+                        m_notify = false;
+                        return;
+                    }
+                }
+            }
+
+            std::unique_lock<std::mutex> locker(m_notify_mutex);
+            auto predicate = [this] {
+                return m_notify || m_shutdown;
+            };
+            if (timeout == duration_t::max()) {
+                m_notify_condition.wait(locker, predicate);
+            } else if (timeout > duration_t::zero()) {
+                m_notify_condition.wait_for(locker, timeout, predicate);
+            }
+            m_notify = false;
         }
 
     }; // NetworkWorker
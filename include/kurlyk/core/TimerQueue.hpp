@@ -0,0 +1,147 @@
+#pragma once
+#ifndef _KURLYK_CORE_TIMER_QUEUE_HPP_INCLUDED
+#define _KURLYK_CORE_TIMER_QUEUE_HPP_INCLUDED
+
+/// \file TimerQueue.hpp
+/// \brief Defines a min-heap of one-shot timers used to schedule deferred work on the network worker.
+
+namespace kurlyk::core {
+
+    /// \class TimerQueue
+    /// \brief Thread-safe queue of one-shot timers ordered by deadline.
+    ///
+    /// Timers are kept in a binary min-heap, so scheduling and expiring a timer costs O(log n)
+    /// and processing only touches timers that have actually expired. Cancelled timers are
+    /// removed from the heap lazily when they reach the top or when the heap is compacted.
+    class TimerQueue {
+    public:
+        using clock_t      = std::chrono::steady_clock;
+        using time_point_t = clock_t::time_point;
+        using duration_t   = clock_t::duration;
+        using timer_id_t   = uint64_t;
+        using callback_t   = std::function<void()>;
+
+        /// \brief Schedules a callback to run once at the specified time.
+        /// \param deadline Time point at or after which the callback is invoked.
+        /// \param callback Function to invoke; it runs on the thread calling process().
+        /// \return Identifier of the timer, never 0.
+        timer_id_t add_timer(time_point_t deadline, callback_t callback) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const timer_id_t id = m_next_id++;
+            m_callbacks.emplace(id, std::move(callback));
+            m_heap.push_back(Entry{deadline, id});
+            std::push_heap(m_heap.begin(), m_heap.end(), EntryCompare());
+            return id;
+        }
+
+        /// \brief Cancels a timer that has not run yet.
+        /// \param id Identifier returned by add_timer().
+        /// \return True if the timer was pending and is now cancelled.
+        bool cancel_timer(timer_id_t id) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_callbacks.erase(id)) return false;
+            compact_locked();
+            return true;
+        }
+
+        /// \brief Runs callbacks of all timers whose deadline has passed.
+        /// \param now Current time.
+        /// \return Number of callbacks invoked.
+        std::size_t process(time_point_t now = clock_t::now()) {
+            std::vector<callback_t> expired;
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_heap.empty() && m_heap.front().deadline <= now) {
+                const timer_id_t id = m_heap.front().id;
+                std::pop_heap(m_heap.begin(), m_heap.end(), EntryCompare());
+                m_heap.pop_back();
+
+                auto it = m_callbacks.find(id);
+                if (it == m_callbacks.end()) continue;
+                expired.push_back(std::move(it->second));
+                m_callbacks.erase(it);
+            }
+            lock.unlock();
+
+            for (auto& callback : expired) {
+                if (callback) callback();
+            }
+            return expired.size();
+        }
+
+        /// \brief Returns the deadline of the earliest pending timer.
+        /// \return Deadline, or `time_point_t::max()` if there are no pending timers.
+        time_point_t next_deadline() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            drop_cancelled_top_locked();
+            if (m_heap.empty()) return time_point_t::max();
+            return m_heap.front().deadline;
+        }
+
+        /// \brief Returns the time left until the earliest pending timer expires.
+        /// \param now Current time.
+        /// \return Remaining time, zero if a timer has already expired, or `duration_t::max()` if there are no timers.
+        duration_t time_until_next(time_point_t now = clock_t::now()) {
+            const time_point_t deadline = next_deadline();
+            if (deadline == time_point_t::max()) return duration_t::max();
+            if (deadline <= now) return duration_t::zero();
+            return deadline - now;
+        }
+
+        /// \brief Checks whether there are pending timers.
+        /// \return True if no timers are pending.
+        bool empty() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_callbacks.empty();
+        }
+
+        /// \brief Cancels all pending timers without invoking them.
+        void clear() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_heap.clear();
+            m_callbacks.clear();
+        }
+
+    private:
+
+        /// \struct Entry
+        /// \brief Heap entry referencing a timer callback.
+        struct Entry {
+            time_point_t deadline; ///< Expiration time.
+            timer_id_t   id;       ///< Timer identifier.
+        };
+
+        /// \brief Orders entries so that the earliest deadline is at the top of the heap.
+        struct EntryCompare {
+            bool operator()(const Entry& a, const Entry& b) const {
+                if (a.deadline != b.deadline) return a.deadline > b.deadline;
+                return a.id > b.id;
+            }
+        };
+
+        mutable std::mutex                          m_mutex;       ///< Mutex protecting the heap and callbacks.
+        std::vector<Entry>                          m_heap;        ///< Min-heap of timer deadlines.
+        std::unordered_map<timer_id_t, callback_t>  m_callbacks;   ///< Callbacks of pending timers.
+        timer_id_t                                  m_next_id = 1; ///< Next timer identifier.
+
+        /// \brief Removes cancelled entries from the top of the heap.
+        void drop_cancelled_top_locked() {
+            while (!m_heap.empty() && !m_callbacks.count(m_heap.front().id)) {
+                std::pop_heap(m_heap.begin(), m_heap.end(), EntryCompare());
+                m_heap.pop_back();
+            }
+        }
+
+        /// \brief Rebuilds the heap when cancelled entries make up most of it.
+        void compact_locked() {
+            if (m_heap.size() < 64 || m_heap.size() < 2 * m_callbacks.size()) return;
+            m_heap.erase(std::remove_if(m_heap.begin(), m_heap.end(), [this](const Entry& entry) {
+                return !m_callbacks.count(entry.id);
+            }), m_heap.end());
+            std::make_heap(m_heap.begin(), m_heap.end(), EntryCompare());
+        }
+
+    }; // TimerQueue
+
+} // namespace kurlyk::core
+
+#endif // _KURLYK_CORE_TIMER_QUEUE_HPP_INCLUDED
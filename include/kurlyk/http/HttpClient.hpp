@@ -45,29 +45,28 @@ namespace kurlyk {
         /// \brief Cancels the active request associated with this client and waits for its completion.
         /// \note If no active request is associated or the ID is invalid, the method may have no effect.
         void cancel_requests() {
-            auto promise = std::make_shared<std::promise<void>>();
-            auto future = promise->get_future();
-            HttpRequestManager::get_instance().cancel_request_by_id(m_request.request_id, [promise](){
-                try {
-                    promise->set_value();
-                } catch (const std::future_error& e) {
-                    if (e.code() == std::make_error_condition(std::future_errc::promise_already_satisfied)) {
-                        KURLYK_HANDLE_ERROR(e, "Promise already satisfied in HttpClient::request callback");
-                    } else {
-                        KURLYK_HANDLE_ERROR(e, "Future error in HttpClient::request callback");
-                    }
-                } catch (const std::exception& e) {
-                    KURLYK_HANDLE_ERROR(e, "Unhandled exception in HttpClient::request callback");
-                } catch (...) {
-                    // Unknown fatal error in request callback
-                }
-            });
-            core::NetworkWorker::get_instance().notify();
-            try {
-                future.get();
-            } catch (const std::exception& e) {
-                KURLYK_HANDLE_ERROR(e, "cancel_requests() future.get() failed");
-            }
+            cancel_and_wait(m_request.request_id);
+        }
+
+        /// \brief Cancels one request sent by this client and waits for its completion.
+        /// \param submission_id ID returned by one of the callback-based request methods.
+        void cancel_request(uint64_t submission_id) {
+            if (!submission_id) return;
+            cancel_and_wait(submission_id);
+        }
+
+        /// \brief Sets the tags of subsequent requests sent by this client, replacing the previous ones.
+        ///
+        /// All requests in flight with a tag can be cancelled at once with kurlyk::cancel_requests_by_tag().
+        /// \param tags Tags, e.g. the strategy or the symbol the requests belong to.
+        void set_tags(std::vector<std::string> tags) {
+            m_request.set_tags(std::move(tags));
+        }
+
+        /// \brief Adds a tag to subsequent requests sent by this client.
+        /// \param tag Tag, e.g. the strategy or the symbol the requests belong to.
+        void add_tag(const std::string& tag) {
+            m_request.add_tag(tag);
         }
 
         /// \brief Sets the host URL for the HTTP client.
@@ -121,29 +120,45 @@ namespace kurlyk {
         /// \param requests_per_period The maximum number of requests allowed within the specified period.
         /// \param period_ms The duration of the period in milliseconds.
         /// \param type The type of rate limit (either general or specific).
+        /// \param algorithm Algorithm enforcing the limit.
+        /// \param burst Requests allowed back to back by RateLimitAlgorithm::RL_GCRA.
         void set_rate_limit(
                 long requests_per_period,
                 long period_ms,
-                RateLimitType type = RateLimitType::RL_GENERAL) {
+                RateLimitType type = RateLimitType::RL_GENERAL,
+                RateLimitAlgorithm algorithm = RateLimitAlgorithm::RL_FIXED_WINDOW,
+                long burst = 1) {
             auto& instance = HttpRequestManager::get_instance();
             switch (type) {
             case RateLimitType::RL_GENERAL:
                 if (is_general_limit_owned) {
                     instance.remove_limit(m_request.general_rate_limit_id);
                 }
-                m_request.general_rate_limit_id = instance.create_rate_limit(requests_per_period, period_ms);
+                m_request.general_rate_limit_id = instance.create_rate_limit(requests_per_period, period_ms, algorithm, burst);
                 is_general_limit_owned = true;
                 break;
             case RateLimitType::RL_SPECIFIC:
                 if (is_specific_limit_owned) {
                     instance.remove_limit(m_request.specific_rate_limit_id);
                 }
-                m_request.specific_rate_limit_id = instance.create_rate_limit(requests_per_period, period_ms);
+                m_request.specific_rate_limit_id = instance.create_rate_limit(requests_per_period, period_ms, algorithm, burst);
                 is_specific_limit_owned = true;
                 break;
             }
         }
 
+        /// \brief Makes the client's general or specific rate limit follow server response headers.
+        /// \param feedback Mapping of response headers onto the limit.
+        /// \param type The type of rate limit (either general or specific).
+        /// \return True if the feedback was set, false if the client has no such rate limit.
+        bool set_rate_limit_feedback(
+                RateLimitFeedback feedback,
+                RateLimitType type = RateLimitType::RL_GENERAL) {
+            const long limit_id = type == RateLimitType::RL_GENERAL ?
+                m_request.general_rate_limit_id : m_request.specific_rate_limit_id;
+            return HttpRequestManager::get_instance().set_rate_limit_feedback(limit_id, std::move(feedback));
+        }
+
         /// \brief Sets the rate limit based on requests per minute (RPM).
         /// \param requests_per_minute Maximum number of requests allowed per minute.
         /// \param type The type of rate limit (either general or specific).
@@ -298,6 +313,76 @@ namespace kurlyk {
             m_request.set_retry_attempts(retry_attempts, retry_delay_ms);
         }
 
+        /// \brief Adds a rate limit applied to all requests of this client together with the general and specific ones.
+        ///
+        /// The limit is not owned by the client; several clients may share it, e.g. for a per-IP or per-account limit.
+        /// \param limit_id ID of a limit created by kurlyk::create_rate_limit().
+        void add_rate_limit_id(long limit_id) {
+            m_request.add_rate_limit_id(limit_id);
+        }
+
+        /// \brief Sets the weight of requests sent by this client for rate limiting.
+        /// \param weight Units of each rate limit budget consumed by each request.
+        void set_rate_limit_weight(long weight) {
+            m_request.set_rate_limit_weight(weight);
+        }
+
+        /// \brief Sets the priority of requests sent by this client while they wait for their rate limits.
+        /// \param priority Priority class of the requests.
+        void set_priority(RequestPriority priority) {
+            m_request.set_priority(priority);
+        }
+
+        /// \brief Sets a deadline for requests sent by this client, relative to their submission.
+        ///
+        /// Requests that are still waiting for their rate limits or for a retry at the deadline are completed
+        /// with utils::ClientError::DeadlineExceeded without being sent.
+        /// \param ms Milliseconds after submission; 0 disables the deadline.
+        void set_deadline_ms(long ms) {
+            m_request.set_deadline_ms(ms);
+        }
+
+        /// \brief Sets the retry policy of requests sent by this client.
+        /// \param policy Policy deciding whether and when requests are retried; nullptr restores the fixed retries
+        ///        configured by set_retry_attempts().
+        void set_retry_policy(std::shared_ptr<HttpRetryPolicy> policy) {
+            m_request.set_retry_policy(std::move(policy));
+        }
+
+        /// \brief Sets the hedge policy of requests sent by this client.
+        /// \param policy Policy deciding when a second copy of a slow GET, HEAD or OPTIONS request is sent;
+        ///        nullptr disables hedging.
+        void set_hedge_policy(std::shared_ptr<HttpHedgePolicy> policy) {
+            m_request.set_hedge_policy(std::move(policy));
+        }
+
+        /// \brief Sets the circuit breaker policy of requests sent by this client.
+        ///
+        /// While the circuit of a host is open, requests to it are completed with
+        /// utils::ClientError::CircuitOpen instead of being sent.
+        /// \param policy Policy deciding when the circuit of a host opens; nullptr disables the circuit breaker.
+        void set_circuit_breaker(std::shared_ptr<HttpCircuitBreakerPolicy> policy) {
+            m_request.set_circuit_breaker(std::move(policy));
+        }
+
+        /// \brief Enables or disables single-flight coalescing of requests sent by this client.
+        /// \param enable True to let identical requests already in flight share one transfer and its response.
+        void set_coalesce(bool enable) {
+            m_request.set_coalesce(enable);
+        }
+
+        /// \brief Enables or disables the HTTP response cache for GET requests sent by this client.
+        /// \param enable True to serve fresh responses from the cache and revalidate stale ones.
+        void set_use_cache(bool enable) {
+            m_request.set_use_cache(enable);
+        }
+
+        /// \brief Sets the key used to route requests to an HTTP worker shard.
+        /// \param key Requests with the same key are executed by the same shard; if empty, the host is used.
+        void set_shard_key(const std::string& key) {
+            m_request.set_shard_key(key);
+        }
+
         /// \brief Adds a valid HTTP status code to the request.
         /// \param status The HTTP status code to allow.
         void add_valid_status(long status) {
@@ -376,8 +461,8 @@ namespace kurlyk {
         /// \param headers The HTTP headers.
         /// \param content The request body content.
         /// \param callback The callback function to be called when the request is completed.
-        /// \return true if the request was successfully added to the RequestManager; false otherwise.
-        bool request(
+        /// \return ID of the submission, which cancel_request() accepts, or 0 if the request was not added.
+        uint64_t request(
                 const std::string &method,
                 const std::string& path,
                 const QueryParams &query,
@@ -404,8 +489,8 @@ namespace kurlyk {
         /// \param content The request body content.
         /// \param specific_rate_limit_id The specific rate limit ID to be applied to this request.
         /// \param callback The callback function to be called when the request is completed.
-        /// \return true if the request was successfully added to the RequestManager; false otherwise.
-        bool request(
+        /// \return ID of the submission, which cancel_request() accepts, or 0 if the request was not added.
+        uint64_t request(
                 const std::string &method,
                 const std::string& path,
                 const QueryParams &query,
@@ -438,8 +523,8 @@ namespace kurlyk {
         /// \param query The query arguments.
         /// \param headers The HTTP headers.
         /// \param callback The callback function to be called when the request is completed.
-        /// \return true if the request was successfully added to the RequestManager; false otherwise.
-        bool get(
+        /// \return ID of the submission, which cancel_request() accepts, or 0 if the request was not added.
+        uint64_t get(
                 const std::string& path,
                 const QueryParams& query,
                 const Headers& headers,
@@ -453,8 +538,8 @@ namespace kurlyk {
         /// \param headers The HTTP headers.
         /// \param content The request body content.
         /// \param callback The callback function to be called when the request is completed.
-        /// \return true if the request was successfully added to the RequestManager; false otherwise.
-        bool post(
+        /// \return ID of the submission, which cancel_request() accepts, or 0 if the request was not added.
+        uint64_t post(
                 const std::string& path,
                 const QueryParams& query,
                 const Headers& headers,
@@ -469,8 +554,8 @@ namespace kurlyk {
         /// \param headers The HTTP headers.
         /// \param specific_rate_limit_id The specific rate limit ID to be applied to this request.
         /// \param callback The callback function to be called when the request is completed.
-        /// \return true if the request was successfully added to the RequestManager; false otherwise.
-        bool get(
+        /// \return ID of the submission, which cancel_request() accepts, or 0 if the request was not added.
+        uint64_t get(
                 const std::string& path,
                 const QueryParams& query,
                 const Headers& headers,
@@ -486,8 +571,8 @@ namespace kurlyk {
         /// \param content The request body content.
         /// \param specific_rate_limit_id The specific rate limit ID to be applied to this request.
         /// \param callback The callback function to be called when the request is completed.
-        /// \return true if the request was successfully added to the RequestManager; false otherwise.
-        bool post(
+        /// \return ID of the submission, which cancel_request() accepts, or 0 if the request was not added.
+        uint64_t post(
                 const std::string& path,
                 const QueryParams& query,
                 const Headers& headers,
@@ -643,13 +728,41 @@ namespace kurlyk {
         /// \brief Adds the request to the request manager and notifies the worker to process it.
         /// \param request_ptr The HTTP request to be sent.
         /// \param callback The callback function to be called when the request is completed.
-        /// \return true if the request was successfully added to the RequestManager; false otherwise.
-        bool request(
+        /// \return ID of the submission, or 0 if the request was not added.
+        uint64_t request(
                 std::unique_ptr<HttpRequest> request_ptr,
                 HttpResponseCallback callback) {
-            const bool status = HttpRequestManager::get_instance().add_request(std::move(request_ptr), std::move(callback));
+            const uint64_t submission_id = HttpRequestManager::get_instance().send_request(std::move(request_ptr), std::move(callback));
             core::NetworkWorker::get_instance().notify();
-            return status;
+            return submission_id;
+        }
+
+        /// \brief Cancels requests by ID and waits for the cancellation to complete.
+        /// \param request_id Request ID of the client or submission ID of one request.
+        void cancel_and_wait(uint64_t request_id) {
+            auto promise = std::make_shared<std::promise<void>>();
+            auto future = promise->get_future();
+            HttpRequestManager::get_instance().cancel_request_by_id(request_id, [promise](){
+                try {
+                    promise->set_value();
+                } catch (const std::future_error& e) {
+                    if (e.code() == std::make_error_condition(std::future_errc::promise_already_satisfied)) {
+                        KURLYK_HANDLE_ERROR(e, "Promise already satisfied in HttpClient::request callback");
+                    } else {
+                        KURLYK_HANDLE_ERROR(e, "Future error in HttpClient::request callback");
+                    }
+                } catch (const std::exception& e) {
+                    KURLYK_HANDLE_ERROR(e, "Unhandled exception in HttpClient::request callback");
+                } catch (...) {
+                    // Unknown fatal error in request callback
+                }
+            });
+            core::NetworkWorker::get_instance().notify();
+            try {
+                future.get();
+            } catch (const std::exception& e) {
+                KURLYK_HANDLE_ERROR(e, "HttpClient cancellation future.get() failed");
+            }
         }
 
         /// \brief Safely sets the response value on the given promise.
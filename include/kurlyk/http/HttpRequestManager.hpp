@@ -6,15 +6,33 @@
 /// \brief Manages and processes HTTP requests using a singleton pattern.
 
 #include "HttpRequestManager/HttpRequestContext.hpp"
+#include "HttpRequestManager/HttpRequestGroups.hpp"
+#include "HttpRequestManager/HttpCaBundle.hpp"
+#include "HttpRequestManager/HttpEasyHandlePool.hpp"
+#include "HttpRequestManager/HttpShareHandle.hpp"
+#include "HttpRequestManager/HttpRetryBudget.hpp"
+#include "HttpRequestManager/HttpCircuitBreaker.hpp"
 #include "HttpRequestManager/HttpRequestHandler.hpp"
 #include "HttpRequestManager/HttpRateLimiter.hpp"
+#include "HttpRequestManager/HttpPriorityQueue.hpp"
+#include "HttpRequestManager/HttpHostLatency.hpp"
+#include "HttpRequestManager/HttpHedgeGroup.hpp"
+#include "HttpRequestManager/HttpCoalesceGroup.hpp"
+#include "HttpRequestManager/HttpCacheEntry.hpp"
+#include "HttpRequestManager/HttpDiskCache.hpp"
+#include "HttpRequestManager/HttpResponseCache.hpp"
 #include "HttpRequestManager/HttpBatchRequestHandler.hpp"
-#include "HttpRequestManager/HttpRateLimiter.hpp"
+#include "HttpRequestManager/HttpWorkerShard.hpp"
 
 namespace kurlyk {
 
     /// \class HttpRequestManager
     /// \brief Manages and processes HTTP requests using a singleton pattern.
+    ///
+    /// Rate limiting, retries and cancellation always run on the NetworkWorker thread. Transfers run
+    /// on the worker thread as well, unless KURLYK_HTTP_WORKER_SHARDS is non-zero: then each request is
+    /// routed by its shard key (or URL origin) to one of several HttpWorkerShard threads, and its
+    /// callback is invoked on that shard's thread.
     class HttpRequestManager final : public core::INetworkTaskManager {
     public:
 
@@ -32,23 +50,62 @@ namespace kurlyk {
         const bool add_request(
                 std::unique_ptr<HttpRequest> request_ptr,
                 HttpResponseCallback callback) {
-            if (m_shutdown) return false;
-            std::lock_guard<std::mutex> lock(m_mutex);
-#           if __cplusplus >= 201402L
-            m_pending_requests.push_back(std::make_unique<HttpRequestContext>(std::move(request_ptr), std::move(callback)));
-#           else
-            m_pending_requests.push_back(std::unique_ptr<HttpRequestContext>(
-                new HttpRequestContext(std::move(request_ptr), std::move(callback))));
-#           endif
-            return true;
+            return send_request(std::move(request_ptr), std::move(callback)) != 0;
+        }
+
+        /// \brief Adds a new HTTP request to the manager and returns the ID of the submission.
+        ///
+        /// The request is pushed to a lock-free submission queue and moved to its pending queue by the worker.
+        /// A request with a hedge policy may be sent twice; see add_hedged_request(). A coalesced request may
+        /// share the transfer of an identical request, and a cached one may be answered without a transfer;
+        /// see add_coalesced_request() and prepare_cached_request().
+        ///
+        /// The submission ID cancels this request alone. The request ID it was sent with and each of its tags
+        /// cancel every request in flight sharing them; see cancel_request_by_id() and cancel_requests_by_tag().
+        /// \param request_ptr Unique pointer to the HTTP request object containing request details.
+        /// \param callback Callback function invoked when the request completes.
+        /// \return ID of the submission, or 0 if the manager is shutting down.
+        uint64_t send_request(
+                std::unique_ptr<HttpRequest> request_ptr,
+                HttpResponseCallback callback) {
+            if (m_shutdown) return 0;
+            const uint64_t submission_id = generate_request_id();
+            if (request_ptr &&
+                request_ptr->deadline == std::chrono::steady_clock::time_point() &&
+                request_ptr->deadline_ms > 0) {
+                request_ptr->deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(request_ptr->deadline_ms);
+            }
+            if (request_ptr && core::NetworkWorker::get_instance().get_callback_executor()) {
+                callback = make_executor_callback(request_ptr->request_id, std::move(callback));
+            }
+            if (request_ptr) {
+                callback = register_submission(*request_ptr, submission_id, std::move(callback));
+                request_ptr->request_id = submission_id;
+            }
+            if (request_ptr && is_cacheable(*request_ptr) &&
+                prepare_cached_request(request_ptr, callback)) {
+                return submission_id;
+            }
+            if (request_ptr && request_ptr->coalesce) {
+                add_coalesced_request(std::move(request_ptr), std::move(callback));
+                return submission_id;
+            }
+            dispatch_request(std::move(request_ptr), std::move(callback));
+            return submission_id;
         }
 
         /// \brief Creates a rate limit with specified parameters.
         /// \param requests_per_period Maximum number of requests allowed in the specified period.
         /// \param period_ms Time period in milliseconds during which the rate limit applies.
+        /// \param algorithm Algorithm enforcing the limit.
+        /// \param burst Requests allowed back to back by RateLimitAlgorithm::RL_GCRA.
         /// \return A unique identifier for the created rate limit.
-        const long create_rate_limit(long requests_per_period, long period_ms) {
-            return m_rate_limiter.create_limit(requests_per_period, period_ms);
+        const long create_rate_limit(
+                long requests_per_period,
+                long period_ms,
+                RateLimitAlgorithm algorithm = RateLimitAlgorithm::RL_FIXED_WINDOW,
+                long burst = 1) {
+            return m_rate_limiter.create_limit(requests_per_period, period_ms, algorithm, burst);
         }
 
         /// \brief Removes an existing rate limit with the specified identifier.
@@ -58,97 +115,1084 @@ namespace kurlyk {
             return m_rate_limiter.remove_limit(limit_id);
         }
 
+        /// \brief Makes a rate limit follow the quota reported in server response headers.
+        /// \param limit_id The unique identifier of the rate limit.
+        /// \param feedback Mapping of response headers onto the limit.
+        /// \return True if the feedback was set, false if the rate limit ID was not found.
+        bool set_rate_limit_feedback(long limit_id, RateLimitFeedback feedback) {
+            return m_rate_limiter.set_feedback(limit_id, std::move(feedback));
+        }
+
+        /// \brief Stops a rate limit from following server response headers.
+        /// \param limit_id The unique identifier of the rate limit.
+        /// \return True if the feedback was removed, false if none was set.
+        bool remove_rate_limit_feedback(long limit_id) {
+            return m_rate_limiter.remove_feedback(limit_id);
+        }
+
+        /// \brief Sets the size limit of the HTTP response cache.
+        /// \param max_bytes Maximum total size of the cached responses.
+        void set_response_cache_size(std::size_t max_bytes) {
+            m_response_cache.set_max_bytes(max_bytes);
+        }
+
+        /// \brief Sets the directory of the persistent tier of the HTTP response cache.
+        ///
+        /// The previous disk tier is closed first, which releases the lock of its directory.
+        /// \param directory Directory for the segment files; an empty string disables the disk tier.
+        /// \param max_bytes Maximum total size of the segment files.
+        /// \return True if the disk tier was opened or disabled, false if the directory could not be used,
+        /// e.g. because another process holds its lock.
+        bool set_response_disk_cache(const std::string& directory, std::size_t max_bytes) {
+            m_response_cache.set_disk_cache(nullptr);
+            if (directory.empty()) return true;
+            auto disk_cache = std::make_shared<HttpDiskCache>(directory, max_bytes);
+            if (!disk_cache->is_open()) return false;
+            m_response_cache.set_disk_cache(std::move(disk_cache));
+            return true;
+        }
+
+        /// \brief Removes all responses from the HTTP response cache, including the ones on disk.
+        void clear_response_cache() {
+            m_response_cache.clear();
+        }
+
         /// \brief Generates a new unique request ID.
         /// \return A new unique request ID.
         uint64_t generate_request_id() {
             return m_request_id_counter++;
         }
 
-        /// \brief Cancels a request by its unique identifier.
-        /// \param request_id The unique identifier of the request to cancel.
+        /// \brief Cancels requests by their unique identifier.
+        /// \param request_id A request ID, which cancels every request sent with it, a submission ID returned by
+        ///        send_request(), or the ID of a tag.
         /// \param callback An optional callback function to execute after cancellation.
         void cancel_request_by_id(uint64_t request_id, std::function<void()> callback) {
             if (m_shutdown) {
                 if (callback) callback();
                 return;
             }
+            if (callback && core::NetworkWorker::get_instance().get_callback_executor()) {
+                // Runs after the response callbacks already posted for the cancelled requests.
+                const auto order_keys = m_request_groups.get_order_keys(request_id);
+                std::function<void()> cancel_callback = std::move(callback);
+                callback = [order_keys, cancel_callback]() {
+                    auto remaining = std::make_shared<std::atomic<std::size_t>>(order_keys.size());
+                    for (uint64_t key : order_keys) {
+                        core::NetworkWorker::get_instance().post_callback(key, [remaining, cancel_callback]() {
+                            if (remaining->fetch_sub(1) == 1) cancel_callback();
+                        });
+                    }
+                };
+            }
             std::lock_guard<std::mutex> lock(m_mutex);
             m_requests_to_cancel[request_id].push_back(std::move(callback));
         }
 
+        /// \brief Cancels every request in flight with a tag.
+        /// \param tag Tag of the requests to cancel.
+        /// \param callback An optional callback function to execute after cancellation.
+        void cancel_requests_by_tag(const std::string& tag, std::function<void()> callback) {
+            const uint64_t tag_id = m_request_groups.find_tag(tag);
+            if (!tag_id) {
+                if (callback) callback();
+                return;
+            }
+            cancel_request_by_id(tag_id, std::move(callback));
+        }
+
         /// \brief Processes all requests in the manager.
         ///
-        /// Executes pending, active, and retry-eligible failed requests.
+        /// Executes pending and active requests. Failed requests are returned to the pending queues
+        /// by NetworkWorker timers once their retry delay has passed.
         void process() override {
+            process_opened_circuits();
             process_pending_requests();
             process_active_requests();
-            process_retry_failed_requests();
             process_cancel_requests();
         }
 
         /// \brief Shuts down the request manager, clearing all active and pending requests.
         /// Stops request processing and releases all resources tied to active and pending requests.
+        ///
+        /// May be called from another thread while the worker is blocked in wait(): the wait is interrupted
+        /// and the multi handle is cleared only after it returns.
         void shutdown() override {
             m_shutdown = true;
+            m_batch_handler->wakeup();
+            std::lock_guard<std::mutex> wait_lock(m_wait_mutex);
             cleanup_pending_requests();
             process_cancel_requests();
-            m_active_request_batches.clear();
+            for (auto& shard : m_shards) shard->stop();
+            drain_shard_failed_requests();
+            cleanup_pending_requests();
+            m_batch_handler->clear();
+        }
+
+        /// \brief Returns how long the worker may sleep before the manager must be processed again.
+        ///
+        /// Rate-limit releases and retry delays are scheduled as NetworkWorker timers, so only queued
+        /// cancellations, pending queues ready for dispatch and libcurl timeouts are considered here.
+        /// \return Time until the next deadline, or `duration_t::max()` if there is no HTTP work.
+        duration_t get_wait_timeout() const override {
+            using namespace std::chrono;
+            duration_t timeout = duration_t::max();
+
+            if (!m_submitted_requests.empty() ||
+                !m_shard_failed_requests.empty()) return duration_t::zero();
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!m_requests_to_cancel.empty() ||
+                !m_ready_queues.empty()) return duration_t::zero();
+            lock.unlock();
+
+            std::lock_guard<std::mutex> wait_lock(m_wait_mutex);
+            if (!m_shutdown && !m_batch_handler->empty()) {
+                const long timeout_ms = m_batch_handler->get_timeout_ms();
+                if (timeout_ms >= 0) {
+                    timeout = std::min<duration_t>(timeout, milliseconds(timeout_ms));
+                }
+            }
+            return timeout;
+        }
+
+        /// \brief Blocks in `curl_multi_poll` until socket activity, timeout or wakeup().
+        /// \param timeout Maximum time to block.
+        /// \return True if the wait was performed; false if there are no active transfers to poll or
+        /// `curl_multi_poll` failed, so that the worker waits on its own instead of spinning.
+        bool wait(duration_t timeout) override {
+            std::lock_guard<std::mutex> wait_lock(m_wait_mutex);
+            if (m_shutdown || m_batch_handler->empty()) return false;
+            return m_batch_handler->poll(to_poll_timeout_ms(timeout));
+        }
+
+        /// \brief Interrupts a blocking wait(), or makes the next wait() return immediately.
+        void wakeup() override {
+            m_batch_handler->wakeup();
         }
 
         /// \brief Checks if there are active, pending, or failed requests.
         /// \return True if there are requests still being managed, otherwise false.
         const bool is_loaded() const override {
             std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& shard : m_shards) {
+                if (shard->is_loaded()) return true;
+            }
             return
-                !m_pending_requests.empty() ||
-                !m_failed_requests.empty() ||
-                !m_active_request_batches.empty() ||
+                !m_submitted_requests.empty() ||
+                !m_shard_failed_requests.empty() ||
+                !m_pending_queues.empty() ||
+                !m_retry_requests.empty() ||
+                !m_batch_handler->empty() ||
                 !m_requests_to_cancel.empty();
         }
 
     private:
-        mutable std::mutex                                  m_mutex;                  ///< Mutex to protect access to the pending requests list and requests-to-cancel map.
-        std::list<std::unique_ptr<HttpRequestContext>>      m_pending_requests;       ///< List of pending HTTP requests awaiting processing.
-        std::list<std::unique_ptr<HttpRequestContext>>      m_failed_requests;        ///< List of failed HTTP requests for retrying.
-        std::list<std::unique_ptr<HttpBatchRequestHandler>> m_active_request_batches; ///< List of currently active HTTP request batches.
+        using context_ptr_t = std::unique_ptr<HttpRequestContext>;
+        using time_point_t = std::chrono::steady_clock::time_point;
+        using limit_key_t = std::vector<long>; ///< Sorted IDs of the rate limits applied to a request.
+        using timer_id_t = core::TimerQueue::timer_id_t;
+
+        /// \struct PendingQueue
+        /// \brief Pending requests sharing the same set of rate limits, ordered by priority.
+        ///
+        /// A non-empty queue is either listed in `m_ready_queues`, blocked by the rate limiter until its
+        /// release timer fires, or held in `m_held_queues` behind a blocked request with a higher priority
+        /// that shares one of its rate limits, so a throttled queue costs nothing per tick.
+        struct PendingQueue {
+            HttpPriorityQueue        requests;     ///< Requests by priority class, in submission order within a class.
+            timer_id_t               timer_id = 0; ///< Rate-limit release timer, or 0 if the queue is not blocked.
+        };
+
+        /// \struct RetryEntry
+        /// \brief Failed request waiting for its retry timer.
+        struct RetryEntry {
+            context_ptr_t context;      ///< Context of the failed request.
+            timer_id_t    timer_id = 0; ///< Timer returning the request to its pending queue.
+        };
+
+        utils::MpscQueue<HttpRequestContext>                m_submitted_requests;     ///< Lock-free queue of requests added by add_request().
+        mutable std::mutex                                  m_mutex;                  ///< Mutex to protect access to the pending queues and requests-to-cancel map.
+        std::map<limit_key_t, PendingQueue>                 m_pending_queues;         ///< Pending HTTP requests grouped by their rate limits.
+        std::vector<limit_key_t>                            m_ready_queues;           ///< Pending queues that may be able to dispatch requests.
+        std::set<limit_key_t>                               m_held_queues;            ///< Pending queues waiting until a blocked queue is released.
+        std::unordered_map<uint64_t, RetryEntry>            m_retry_requests;         ///< Failed HTTP requests waiting to be retried; used by the worker thread only.
+        std::unordered_map<uint64_t, std::unordered_set<uint64_t>> m_retry_keys;      ///< Keys of m_retry_requests by request ID; used by the worker thread only.
+        std::unordered_map<uint64_t, std::unordered_set<const HttpRequestContext*>> m_pending_contexts; ///< Requests in the pending queues by request ID.
+        uint64_t                                            m_next_retry_key = 1;     ///< Next key for m_retry_requests.
+        mutable std::mutex                                  m_wait_mutex;             ///< Mutex serializing wait() and get_wait_timeout() with shutdown().
+        std::unique_ptr<HttpBatchRequestHandler>            m_batch_handler;          ///< Persistent multi handle driving active requests when sharding is disabled.
+        std::vector<std::unique_ptr<HttpWorkerShard>>       m_shards;                 ///< Worker shards performing transfers; empty if sharding is disabled.
+        utils::MpscQueue<HttpRequestContext>                m_shard_failed_requests;  ///< Failed requests handed back by the shards for retry.
         using callback_list_t = std::list<std::function<void()>>;
         std::unordered_map<uint64_t, callback_list_t>       m_requests_to_cancel;     ///< Map of request IDs to their associated cancellation callbacks.
         HttpRateLimiter                                     m_rate_limiter;           ///< Rate limiter for controlling request frequency.
+        HttpHostLatency                                     m_host_latency;           ///< Recent latencies of hosts receiving hedged requests.
+        HttpRetryBudget                                     m_hedge_budget;           ///< Per-host budget of hedged copies.
+        HttpCircuitBreaker                                  m_circuit_breaker;        ///< Circuit states of hosts of requests with a circuit breaker policy.
+        std::vector<std::string>                            m_opened_circuits;        ///< Hosts whose circuit opened since the pending queues were last checked.
+        std::unordered_multimap<uint64_t, uint64_t>         m_hedge_ids;              ///< Request IDs of the copies of hedged requests by their original request ID.
+        std::mutex                                          m_coalesce_mutex;         ///< Mutex protecting m_coalesce_groups and m_coalesced_requests.
+        std::unordered_map<std::string, std::shared_ptr<HttpCoalesceGroup>> m_coalesce_groups; ///< In-flight coalesced transfers by coalescing key.
+        std::unordered_map<uint64_t, std::shared_ptr<HttpCoalesceGroup>> m_coalesced_requests; ///< Transfers by the request IDs attached to them.
+        HttpResponseCache                                   m_response_cache;         ///< Cached responses of requests with use_cache set.
+        HttpRequestGroups                                   m_request_groups;         ///< Submissions in flight by request ID and tag.
         std::atomic<uint64_t>                               m_request_id_counter = ATOMIC_VAR_INIT(1); ///< Atomic counter for unique request IDs.
         std::atomic<bool>                                   m_shutdown = ATOMIC_VAR_INIT(false); ///< Flag indicating if shutdown has been requested.
 
-        /// \brief Processes all pending requests, moving valid requests to active batches or marking them as failed.
+        /// \brief Pushes a request to the submission queue.
+        /// \param request_ptr Request to send.
+        /// \param callback Callback invoked with its responses.
+        /// \param is_hedge Whether the request is the hedged copy of another one.
+        /// \param on_dispatch Called once when the request first passes its rate limits; may be empty.
+        void submit_request(
+                std::unique_ptr<HttpRequest> request_ptr,
+                HttpResponseCallback callback,
+                bool is_hedge = false,
+                std::function<void()> on_dispatch = nullptr) {
+#           if KURLYK_ENABLE_TRACING
+            const auto submit_time = std::chrono::steady_clock::now();
+#           endif
+            if (request_ptr && m_rate_limiter.has_feedback()) {
+                callback = make_feedback_callback(make_limit_key(*request_ptr), std::move(callback));
+            }
+            if (request_ptr && request_ptr->circuit_breaker) {
+                callback = make_circuit_breaker_callback(
+                    utils::extract_origin(request_ptr->url), request_ptr->circuit_breaker, std::move(callback));
+            }
+#           if __cplusplus >= 201402L
+            auto context = std::make_unique<HttpRequestContext>(std::move(request_ptr), std::move(callback));
+#           else
+            auto context = std::unique_ptr<HttpRequestContext>(
+                new HttpRequestContext(std::move(request_ptr), std::move(callback)));
+#           endif
+#           if KURLYK_ENABLE_TRACING
+            context->trace_id = tracing::Tracer::get_instance().generate_trace_id();
+            context->trace_time = submit_time;
+#           endif
+            context->is_hedge = is_hedge;
+            context->on_dispatch = std::move(on_dispatch);
+            KURLYK_TRACE_STAGE(*context, "submit");
+            m_submitted_requests.push(std::move(context));
+#           if KURLYK_ENABLE_METRICS
+            metrics::builtin().http_requests.inc();
+#           endif
+        }
+
+        /// \brief Registers a submission in the groups of its request ID and tags.
+        /// \param request Request being submitted, still carrying its original request ID.
+        /// \param submission_id ID of the submission.
+        /// \param callback Callback of the request.
+        /// \return Callback unregistering the submission once its final response arrives.
+        HttpResponseCallback register_submission(
+                const HttpRequest& request,
+                uint64_t submission_id,
+                HttpResponseCallback callback) {
+            std::vector<uint64_t> group_ids;
+            group_ids.reserve(1 + request.tags.size());
+            if (request.request_id) group_ids.push_back(request.request_id);
+            m_request_groups.add(submission_id, request.request_id, std::move(group_ids), request.tags, [this]() {
+                return generate_request_id();
+            });
+            return [this, submission_id, callback](HttpResponsePtr response) {
+                if (response && response->ready) m_request_groups.remove(submission_id);
+                callback(std::move(response));
+            };
+        }
+
+        /// \brief Sends a request, hedging it if its policy allows.
+        /// \param request_ptr Request to send.
+        /// \param callback Callback invoked with its responses.
+        void dispatch_request(
+                std::unique_ptr<HttpRequest> request_ptr,
+                HttpResponseCallback callback) {
+            if (request_ptr && is_hedgeable(*request_ptr)) {
+                add_hedged_request(std::move(request_ptr), std::move(callback));
+                return;
+            }
+            submit_request(std::move(request_ptr), std::move(callback));
+        }
+
+        /// \brief Attaches a request to an identical transfer in flight, or starts a new shared transfer.
+        ///
+        /// The shared transfer gets a request ID of its own, so cancelling one of the attached requests only
+        /// detaches it; the transfer is cancelled once no requests remain attached.
+        /// \param request_ptr Request to send.
+        /// \param callback Callback invoked with a copy of the responses of the transfer.
+        void add_coalesced_request(
+                std::unique_ptr<HttpRequest> request_ptr,
+                HttpResponseCallback callback) {
+            std::string key = make_coalesce_key(*request_ptr);
+            const uint64_t request_id = request_ptr->request_id;
+            std::unique_lock<std::mutex> lock(m_coalesce_mutex);
+            auto it = m_coalesce_groups.find(key);
+            if (it != m_coalesce_groups.end() && it->second->add_waiter(request_id, callback)) {
+                m_coalesced_requests[request_id] = it->second;
+#               if KURLYK_ENABLE_METRICS
+                metrics::builtin().http_coalesced.inc();
+#               endif
+                return;
+            }
+            const uint64_t transfer_id = generate_request_id();
+            auto group = std::make_shared<HttpCoalesceGroup>(key, transfer_id);
+            group->add_waiter(request_id, std::move(callback));
+            m_coalesced_requests[request_id] = group;
+            m_coalesce_groups[std::move(key)] = group;
+            lock.unlock();
+
+            request_ptr->request_id = transfer_id;
+            dispatch_request(std::move(request_ptr), group->make_callback([this](
+                    const HttpCoalesceGroup& group,
+                    const std::list<HttpCoalesceGroup::Waiter>& waiters) {
+                std::lock_guard<std::mutex> lock(m_coalesce_mutex);
+                auto it = m_coalesce_groups.find(group.get_key());
+                if (it != m_coalesce_groups.end() && it->second.get() == &group) m_coalesce_groups.erase(it);
+                for (const auto& waiter : waiters) {
+                    m_coalesced_requests.erase(waiter.request_id);
+                }
+            }));
+        }
+
+        /// \brief Checks whether a request may use the response cache.
+        /// \param request Request to check.
+        /// \return True if the request opted in and is a GET request.
+        static bool is_cacheable(const HttpRequest& request) {
+            return request.use_cache && request.method == "GET" && !request.head_only;
+        }
+
+        /// \brief Answers a request from the response cache, or prepares it to revalidate and update the cache.
+        ///
+        /// A fresh cached response is passed to the callback on the worker thread. Otherwise a stale entry
+        /// with validators turns the request into a conditional one, and the callback is wrapped so that a
+        /// `304 Not Modified` is replaced by the cached response and a cacheable response is stored.
+        /// \param request_ptr Request to send; may receive conditional headers.
+        /// \param callback Callback of the request; wrapped if the request is sent.
+        /// \return True if the request was answered from the cache.
+        bool prepare_cached_request(
+                std::unique_ptr<HttpRequest>& request_ptr,
+                HttpResponseCallback& callback) {
+            HttpRequest& request = *request_ptr;
+            const std::string request_cache_control = HttpResponseCache::get_header(request.headers, "Cache-Control");
+            if (HttpResponseCache::has_directive(request_cache_control, "no-store")) return false;
+            const std::string key = make_request_fingerprint(request);
+            auto entry = m_response_cache.find(key);
+            if (entry &&
+                !HttpResponseCache::has_directive(request_cache_control, "no-cache") &&
+                HttpResponseCache::is_fresh(*entry, HttpResponseCache::clock_t::now())) {
+#               if KURLYK_ENABLE_METRICS
+                metrics::builtin().http_cache_hits.inc();
+#               endif
+                auto response = std::make_shared<HttpResponsePtr>(HttpResponseCache::make_response(*entry));
+                HttpResponseCallback cached_callback = std::move(callback);
+                core::NetworkWorker::get_instance().add_task([cached_callback, response]() {
+                    cached_callback(std::move(*response));
+                });
+                return true;
+            }
+#           if KURLYK_ENABLE_METRICS
+            metrics::builtin().http_cache_misses.inc();
+#           endif
+            if (entry && HttpResponseCache::has_validators(*entry)) {
+                if (!entry->etag.empty() && !request.headers.count("If-None-Match")) {
+                    request.headers.emplace("If-None-Match", entry->etag);
+                }
+                if (!entry->last_modified.empty() && !request.headers.count("If-Modified-Since")) {
+                    request.headers.emplace("If-Modified-Since", entry->last_modified);
+                }
+                request.valid_statuses.insert(304);
+            } else {
+                entry = nullptr;
+            }
+            callback = make_cache_callback(key, std::move(entry), std::move(callback));
+            return false;
+        }
+
+        /// \brief Wraps a response callback so that final responses update the response cache.
+        /// \param key Request fingerprint.
+        /// \param entry Entry being revalidated, or nullptr.
+        /// \param callback Callback to wrap.
+        /// \return Callback replacing a 304 by the cached response and storing cacheable responses.
+        HttpResponseCallback make_cache_callback(
+                std::string key,
+                HttpResponseCache::entry_ptr_t entry,
+                HttpResponseCallback callback) {
+            return [this, key, entry, callback](HttpResponsePtr response) {
+                if (response && response->ready && !response->error_code) {
+                    const auto now = HttpResponseCache::clock_t::now();
+                    const long NOT_MODIFIED = 304;
+                    const long OK = 200;
+                    if (entry && response->status_code == NOT_MODIFIED) {
+                        auto updated = HttpResponseCache::revalidate(*entry, *response, now);
+                        if (updated) m_response_cache.store(key, updated);
+                        else m_response_cache.erase(key);
+                        auto cached = HttpResponseCache::make_response(updated ? *updated : *entry);
+                        cached->retry_attempt      = response->retry_attempt;
+                        cached->namelookup_time    = response->namelookup_time;
+                        cached->connect_time       = response->connect_time;
+                        cached->appconnect_time    = response->appconnect_time;
+                        cached->pretransfer_time   = response->pretransfer_time;
+                        cached->starttransfer_time = response->starttransfer_time;
+                        cached->total_time         = response->total_time;
+                        response = std::move(cached);
+#                       if KURLYK_ENABLE_METRICS
+                        metrics::builtin().http_cache_revalidations.inc();
+#                       endif
+                    } else
+                    if (response->status_code == OK) {
+                        auto stored = HttpResponseCache::make_entry(*response, now);
+                        if (stored) m_response_cache.store(key, std::move(stored));
+                        else m_response_cache.erase(key);
+                    }
+                }
+                callback(std::move(response));
+            };
+        }
+
+        /// \brief Builds the fingerprint identifying identical requests for coalescing and caching.
+        ///
+        /// Besides the method, URL, headers and body, the fingerprint covers every setting that changes who
+        /// sends the request or how it reaches the server: client certificate, CA, proxy, network interface,
+        /// cookies and redirect handling. Requests made with different credentials or routes never share a
+        /// transfer or a cached response. Every field is length-prefixed so that values cannot run together.
+        /// \param request Request to describe.
+        /// \return String identifying the method, URL, headers, body and other fields affecting the response.
+        static std::string make_request_fingerprint(const HttpRequest& request) {
+            std::vector<std::string> headers;
+            headers.reserve(request.headers.size());
+            for (const auto& header : request.headers) {
+                headers.push_back(utils::to_lower_case(header.first) + ":" + header.second);
+            }
+            std::sort(headers.begin(), headers.end());
+            std::string key;
+            auto append = [&key](const std::string& value) {
+                key += std::to_string(value.size());
+                key += ':';
+                key += value;
+            };
+            append(request.method);
+            append(request.url);
+            append(request.head_only ? "1" : "0");
+            append(request.user_agent);
+            append(request.accept_encoding);
+            append(request.cookie);
+            append(request.cookie_file);
+            append(request.clear_cookie_file ? "1" : "0");
+            append(request.cert_file);
+            append(request.key_file);
+            append(request.ca_file);
+            append(request.ca_path);
+            append(request.proxy_server);
+            append(request.proxy_auth);
+            append(std::to_string(static_cast<int>(request.proxy_type)));
+            append(request.proxy_tunnel ? "1" : "0");
+            append(request.use_interface ? request.interface_name : std::string());
+            append(request.follow_location ? std::to_string(request.max_redirects) : std::string("-"));
+            append(request.auto_referer ? "1" : "0");
+            append(std::to_string(headers.size()));
+            for (const auto& header : headers) {
+                append(header);
+            }
+            append(request.content);
+            return key;
+        }
+
+        /// \brief Builds the key under which identical requests share a transfer.
+        ///
+        /// Extends make_request_fingerprint() with every setting that changes how the shared transfer is
+        /// queued, retried or completed: accepted statuses, timeouts and deadline, retry settings, rate limits
+        /// and their weight, priority, and the hedge and circuit breaker policies. A request attached to a
+        /// transfer therefore gets exactly the response it would have got alone. Policies are compared by
+        /// identity, since a derived retry policy may behave differently with the same field values.
+        /// \param request Request to describe.
+        /// \return Fingerprint of the request followed by its delivery settings.
+        static std::string make_coalesce_key(const HttpRequest& request) {
+            std::string key = make_request_fingerprint(request);
+            auto append = [&key](const std::string& value) {
+                key += std::to_string(value.size());
+                key += ':';
+                key += value;
+            };
+            auto append_policy = [&append](const void* policy) {
+                append(std::to_string(reinterpret_cast<std::uintptr_t>(policy)));
+            };
+            append(std::to_string(request.valid_statuses.size()));
+            for (long status : request.valid_statuses) {
+                append(std::to_string(status));
+            }
+            append(std::to_string(request.timeout));
+            append(std::to_string(request.connect_timeout));
+            append(std::to_string(request.deadline.time_since_epoch().count()));
+            append(std::to_string(request.retry_attempts));
+            append(std::to_string(request.retry_delay_ms));
+            append_policy(request.retry_policy.get());
+            const limit_key_t limits = make_limit_key(request);
+            append(std::to_string(limits.size()));
+            for (long id : limits) {
+                append(std::to_string(id));
+            }
+            append(std::to_string(request.rate_limit_weight));
+            append(std::to_string(static_cast<int>(request.priority)));
+            append_policy(request.hedge_policy.get());
+            append_policy(request.circuit_breaker.get());
+            return key;
+        }
+
+        /// \brief Detaches cancelled requests from coalesced transfers. Must be called with m_mutex held.
+        /// \param requests_to_cancel IDs of the requests to cancel; receives the IDs of abandoned transfers.
+        /// \param detached Receives the detached requests.
+        void detach_coalesced_requests(
+                std::unordered_map<uint64_t, callback_list_t>& requests_to_cancel,
+                std::vector<HttpCoalesceGroup::Waiter>& detached) {
+            std::lock_guard<std::mutex> lock(m_coalesce_mutex);
+            if (m_coalesced_requests.empty()) return;
+            std::vector<std::shared_ptr<HttpCoalesceGroup>> groups;
+            for (const auto& request : requests_to_cancel) {
+                auto it = m_coalesced_requests.find(request.first);
+                if (it == m_coalesced_requests.end()) continue;
+                if (std::find(groups.begin(), groups.end(), it->second) == groups.end()) groups.push_back(it->second);
+                m_coalesced_requests.erase(it);
+            }
+            for (const auto& group : groups) {
+                if (!group->remove_waiters(requests_to_cancel, detached)) continue;
+                requests_to_cancel[group->get_transfer_id()];
+                auto it = m_coalesce_groups.find(group->get_key());
+                if (it != m_coalesce_groups.end() && it->second == group) m_coalesce_groups.erase(it);
+            }
+        }
+
+        /// \brief Checks whether a request may be hedged.
+        /// \param request Request to check.
+        /// \return True if the request has a hedge policy and an idempotent method.
+        static bool is_hedgeable(const HttpRequest& request) {
+            if (!request.hedge_policy) return false;
+            return request.method == "GET" || request.method == "HEAD" || request.method == "OPTIONS";
+        }
+
+        /// \brief Sends a request and schedules a hedged copy of it.
+        ///
+        /// Both copies get request IDs of their own, so that the losing copy can be cancelled without
+        /// touching other requests sharing the original ID; cancelling the original ID cancels both copies.
+        /// The hedged copy is sent after the delay of the hedge policy if no copy has completed yet and the
+        /// hedge budget of the host allows it. The delay starts when the primary copy passes its rate limits,
+        /// so time spent throttled or queued behind other requests never triggers a hedge. Successful responses
+        /// update the latencies of the host, measured from that moment too, whichever copy wins.
+        /// \param request_ptr Request to send; must have a hedge policy.
+        /// \param callback Callback invoked with the selected response.
+        void add_hedged_request(
+                std::unique_ptr<HttpRequest> request_ptr,
+                HttpResponseCallback callback) {
+            const auto policy = request_ptr->hedge_policy;
+            const std::string host = utils::extract_origin(request_ptr->url);
+            const uint64_t original_id = request_ptr->request_id;
+            const uint64_t primary_id = generate_request_id();
+            const uint64_t hedge_id = generate_request_id();
+            request_ptr->request_id = primary_id;
+            if (original_id) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_hedge_ids.emplace(original_id, primary_id);
+                m_hedge_ids.emplace(original_id, hedge_id);
+            }
+
+            auto on_finish = [this, original_id](
+                    const HttpHedgeGroup& group,
+                    const HttpResponse& response,
+                    bool is_hedge_winner,
+                    uint64_t cancel_id) {
+                const auto dispatch_time = group.get_dispatch_time();
+                if (!response.error_code && dispatch_time != HttpHedgeGroup::time_point_t()) {
+                    const std::chrono::duration<double> latency = std::chrono::steady_clock::now() - dispatch_time;
+                    m_host_latency.record(group.get_host(), latency.count());
+                }
+#               if KURLYK_ENABLE_METRICS
+                if (is_hedge_winner) metrics::builtin().http_hedge_wins.inc();
+#               else
+                (void)is_hedge_winner;
+#               endif
+                if (cancel_id) cancel_request_by_id(cancel_id, nullptr);
+                if (!original_id) return;
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto range = m_hedge_ids.equal_range(original_id);
+                for (auto it = range.first; it != range.second;) {
+                    if (it->second == group.get_primary_id() || it->second == group.get_hedge_id()) {
+                        it = m_hedge_ids.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            };
+            auto group = std::make_shared<HttpHedgeGroup>(std::move(callback), host, primary_id, hedge_id, std::move(on_finish));
+
+            long delay_ms = policy->delay_ms;
+            if (delay_ms <= 0 &&
+                !m_host_latency.get_percentile_ms(host, policy->percentile, policy->min_samples, delay_ms)) {
+                delay_ms = 0;
+            }
+            std::shared_ptr<HttpRequest> hedge_request;
+            if (delay_ms > 0) {
+                m_hedge_budget.deposit(host, policy->budget_ratio, 0.0);
+                hedge_request = std::make_shared<HttpRequest>(*request_ptr);
+                hedge_request->request_id = hedge_id;
+                delay_ms = std::max(delay_ms, policy->min_delay_ms);
+            }
+            auto on_dispatch = [this, group, hedge_request, delay_ms]() {
+                group->set_dispatch_time(std::chrono::steady_clock::now());
+                if (!hedge_request) return;
+                core::NetworkWorker::get_instance().add_timer(std::chrono::milliseconds(delay_ms), [this, group, hedge_request]() {
+                    if (m_shutdown || group->is_done()) return;
+                    const double budget_ratio = hedge_request->hedge_policy->budget_ratio;
+                    if (!m_hedge_budget.try_withdraw(group->get_host(), budget_ratio, 0.0)) return;
+                    if (!group->try_start_hedge()) return;
+#                   if KURLYK_ENABLE_METRICS
+                    metrics::builtin().http_hedges.inc();
+#                   endif
+#                   if __cplusplus >= 201402L
+                    auto request_copy = std::make_unique<HttpRequest>(*hedge_request);
+#                   else
+                    auto request_copy = std::unique_ptr<HttpRequest>(new HttpRequest(*hedge_request));
+#                   endif
+                    submit_request(std::move(request_copy), group->make_callback(true), true);
+                });
+            };
+            submit_request(std::move(request_ptr), group->make_callback(false), false, std::move(on_dispatch));
+        }
+
+        /// \brief Wraps a response callback so that it runs on the callback executor.
+        ///
+        /// With tracing, the posted task records the `callback` span of a traced transfer.
+        /// \param key Ordering key; callbacks of one HttpClient share its request ID.
+        /// \param callback Callback to wrap.
+        /// \return Callback posting the original one to the executor.
+        static HttpResponseCallback make_executor_callback(uint64_t key, HttpResponseCallback callback) {
+            return [key, callback](HttpResponsePtr response) {
+                auto shared_response = std::make_shared<HttpResponsePtr>(std::move(response));
+#               if KURLYK_ENABLE_TRACING
+                auto& delivery = tracing::current_delivery();
+                delivery.posted = true;
+                const uint64_t trace_id = delivery.trace_id;
+                core::NetworkWorker::get_instance().post_callback(key, [callback, shared_response, trace_id]() {
+                    const auto start = std::chrono::steady_clock::now();
+                    callback(std::move(*shared_response));
+                    if (trace_id) {
+                        tracing::Tracer::get_instance().record("callback", trace_id, start, std::chrono::steady_clock::now());
+                    }
+                });
+#               else
+                core::NetworkWorker::get_instance().post_callback(key, [callback, shared_response]() {
+                    callback(std::move(*shared_response));
+                });
+#               endif
+            };
+        }
+
+        /// \brief Wraps a response callback so that every response updates the request's rate limits first.
+        /// \param key Rate limits of the request.
+        /// \param callback Callback to wrap.
+        /// \return Callback feeding the response headers back to the rate limiter.
+        HttpResponseCallback make_feedback_callback(limit_key_t key, HttpResponseCallback callback) {
+            return [this, key, callback](HttpResponsePtr response) {
+                if (response) m_rate_limiter.apply_feedback(key, *response);
+                callback(std::move(response));
+            };
+        }
+
+        /// \brief Wraps a response callback so that every attempt updates the circuit of the request's host first.
+        /// \param host Host key of the request.
+        /// \param policy Circuit breaker policy of the request.
+        /// \param callback Callback to wrap.
+        /// \return Callback recording the outcome of each attempt; cancelled and expired requests are ignored.
+        ///
+        /// When an outcome opens the circuit, the worker is woken up to fail the queued requests to the host.
+        HttpResponseCallback make_circuit_breaker_callback(
+                std::string host,
+                std::shared_ptr<HttpCircuitBreakerPolicy> policy,
+                HttpResponseCallback callback) {
+            return [this, host, policy, callback](HttpResponsePtr response) {
+                if (response && !(response->error_code && response->error_code.category() == utils::client_error_category())) {
+                    const bool is_opened = m_circuit_breaker.record(
+                        host, *policy, policy->is_failure(*response), std::chrono::steady_clock::now());
+                    if (is_opened) {
+#                       if KURLYK_ENABLE_METRICS
+                        metrics::builtin().http_circuit_opened.inc();
+#                       endif
+                        {
+                            std::lock_guard<std::mutex> lock(m_mutex);
+                            m_opened_circuits.push_back(host);
+                        }
+                        core::NetworkWorker::get_instance().notify();
+                    }
+                }
+                callback(std::move(response));
+            };
+        }
+
+        /// \brief Converts a wait timeout to the millisecond value expected by `curl_multi_poll`.
+        /// \param timeout Timeout to convert.
+        /// \return Timeout in milliseconds, rounded up and clamped to the range of int.
+        static int to_poll_timeout_ms(duration_t timeout) {
+            using namespace std::chrono;
+            const long long max_ms = (std::numeric_limits<int>::max)();
+            if (timeout >= duration_cast<duration_t>(milliseconds(max_ms))) return static_cast<int>(max_ms);
+            auto timeout_ms = duration_cast<milliseconds>(timeout);
+            if (timeout_ms < timeout) ++timeout_ms;
+            return static_cast<int>(timeout_ms.count());
+        }
+
+        /// \brief Adds a request to the pending queue of its rate limits. Must be called with m_mutex held.
+        /// \param context Context of the request to enqueue.
+        void enqueue_pending_request(context_ptr_t context) {
+            const limit_key_t key = context->request ? make_limit_key(*context->request) : limit_key_t();
+            auto& queue = m_pending_queues[key];
+            const bool is_idle = queue.requests.empty() && !queue.timer_id;
+            context->start_time = std::chrono::steady_clock::now();
+            if (context->request) m_pending_contexts[context->request->request_id].insert(context.get());
+            queue.requests.push(std::move(context));
+#           if KURLYK_ENABLE_METRICS
+            metrics::builtin().http_pending.inc();
+#           endif
+            if (is_idle) m_ready_queues.push_back(key);
+            // The new request may outrank the one its queue is held behind.
+            else if (m_held_queues.count(key)) release_held_queues();
+        }
+
+        /// \brief Removes the request returned by top() from a pending queue. Must be called with m_mutex held.
+        /// \param queue Queue holding the request.
+        /// \param context Reference returned by top().
+        /// \return Context of the removed request.
+        context_ptr_t pop_pending_request(PendingQueue& queue, context_ptr_t& context) {
+            if (context->request) remove_pending_context(context->request->request_id, context.get());
+            context_ptr_t result = std::move(context);
+            queue.requests.pop();
+            return result;
+        }
+
+        /// \brief Removes a request from the request ID index of the pending queues. Must be called with m_mutex held.
+        /// \param request_id ID of the request.
+        /// \param context Context of the request.
+        void remove_pending_context(uint64_t request_id, const HttpRequestContext* context) {
+            auto it = m_pending_contexts.find(request_id);
+            if (it == m_pending_contexts.end()) return;
+            it->second.erase(context);
+            if (it->second.empty()) m_pending_contexts.erase(it);
+        }
+
+        /// \brief Removes the requests with the given IDs from the pending queues. Must be called with m_mutex held.
+        /// \param request_ids IDs of the requests to remove.
+        /// \param removed Receives the removed requests.
+        void extract_pending_requests(
+                const std::unordered_map<uint64_t, callback_list_t>& request_ids,
+                std::vector<context_ptr_t>& removed) {
+            for (const auto& request : request_ids) {
+                auto it = m_pending_contexts.find(request.first);
+                if (it == m_pending_contexts.end()) continue;
+                const auto contexts = std::move(it->second);
+                m_pending_contexts.erase(it);
+                for (const HttpRequestContext* context : contexts) {
+                    auto queue_it = m_pending_queues.find(make_limit_key(*context->request));
+                    if (queue_it == m_pending_queues.end()) continue;
+                    auto& queue = queue_it->second;
+                    auto removed_context = queue.requests.erase(context);
+                    if (!removed_context) continue;
+                    removed.push_back(std::move(removed_context));
+                    if (queue.requests.empty() && !queue.timer_id) m_pending_queues.erase(queue_it);
+                }
+            }
+        }
+
+        /// \brief Builds the key of the pending queue for a request.
+        /// \param request Request whose rate limits are collected.
+        /// \return Sorted, unique, non-zero IDs of the general, specific and additional rate limits.
+        static limit_key_t make_limit_key(const HttpRequest& request) {
+            limit_key_t key;
+            key.reserve(2 + request.rate_limit_ids.size());
+            if (request.general_rate_limit_id) key.push_back(request.general_rate_limit_id);
+            if (request.specific_rate_limit_id) key.push_back(request.specific_rate_limit_id);
+            for (long id : request.rate_limit_ids) {
+                if (id) key.push_back(id);
+            }
+            std::sort(key.begin(), key.end());
+            key.erase(std::unique(key.begin(), key.end()), key.end());
+            return key;
+        }
+
+        /// \brief Moves requests from the submission queue to their pending queues. Must be called with m_mutex held.
+        void drain_submitted_requests() {
+            std::size_t count = m_submitted_requests.size();
+            while (count--) {
+                auto context = m_submitted_requests.pop();
+                if (!context) break;
+                KURLYK_TRACE_STAGE(*context, "pickup");
+                enqueue_pending_request(std::move(context));
+            }
+        }
+
+        /// \brief Marks a rate-limited queue as ready once its release timer fires.
+        /// \param key Rate limits of the queue.
+        void release_pending_queue(const limit_key_t& key) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_pending_queues.find(key);
+            if (it == m_pending_queues.end()) return;
+            it->second.timer_id = 0;
+            release_held_queues();
+            if (it->second.requests.empty()) {
+                m_pending_queues.erase(it);
+                return;
+            }
+            m_ready_queues.push_back(key);
+        }
+
+        /// \brief Marks the queues held behind blocked requests as ready again. Must be called with m_mutex held.
+        ///
+        /// Held queues are re-checked whenever a blocked queue is released; those still behind a blocked
+        /// request with a higher priority are held again.
+        void release_held_queues() {
+            for (const auto& key : m_held_queues) {
+                auto it = m_pending_queues.find(key);
+                if (it == m_pending_queues.end()) continue;
+                if (it->second.timer_id) {
+                    // Deadline timer of the held queue.
+                    core::NetworkWorker::get_instance().cancel_timer(it->second.timer_id);
+                    it->second.timer_id = 0;
+                }
+                if (it->second.requests.empty()) {
+                    m_pending_queues.erase(it);
+                    continue;
+                }
+                m_ready_queues.push_back(key);
+            }
+            m_held_queues.clear();
+        }
+
+        /// \brief Fails the pending requests to hosts whose circuit has opened.
+        ///
+        /// Without this, requests parked behind a rate-limit release timer would only be rejected once the
+        /// timer fires, which for a long throttling pause defeats failing fast.
+        void process_opened_circuits() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_opened_circuits.empty()) return;
+            const std::vector<std::string> hosts = std::move(m_opened_circuits);
+            m_opened_circuits.clear();
+            drain_submitted_requests();
+
+            const auto now = std::chrono::steady_clock::now();
+            std::vector<const HttpRequestContext*> contexts;
+            for (const auto& item : m_pending_contexts) {
+                for (const HttpRequestContext* context : item.second) {
+                    const auto& request = *context->request;
+                    if (!request.circuit_breaker) continue;
+                    const std::string host = utils::extract_origin(request.url);
+                    if (std::find(hosts.begin(), hosts.end(), host) == hosts.end()) continue;
+                    if (m_circuit_breaker.allow(host, *request.circuit_breaker, now)) continue;
+                    contexts.push_back(context);
+                }
+            }
+            std::vector<context_ptr_t> rejected_requests;
+            for (const HttpRequestContext* context : contexts) {
+                auto queue_it = m_pending_queues.find(make_limit_key(*context->request));
+                if (queue_it == m_pending_queues.end()) continue;
+                auto& queue = queue_it->second;
+                remove_pending_context(context->request->request_id, context);
+                auto removed_context = queue.requests.erase(context);
+                if (!removed_context) continue;
+                rejected_requests.push_back(std::move(removed_context));
+                if (queue.requests.empty() && !queue.timer_id) m_pending_queues.erase(queue_it);
+            }
+            lock.unlock();
+
+            for (const auto &context : rejected_requests) {
+#               if __cplusplus >= 201402L
+                auto response = std::make_unique<HttpResponse>();
+#               else
+                auto response = std::unique_ptr<HttpResponse>(new HttpResponse());
+#               endif
+                const long SERVICE_UNAVAILABLE = 503;
+                response->error_code = utils::make_error_code(utils::ClientError::CircuitOpen);
+                response->status_code = SERVICE_UNAVAILABLE;
+                response->retry_attempt = context->retry_attempt;
+                response->ready = true;
+                context->callback(std::move(response));
+#               if KURLYK_ENABLE_METRICS
+                metrics::builtin().http_pending.dec();
+                metrics::builtin().http_circuit_rejected.inc();
+#               endif
+            }
+        }
+
+        /// \brief Processes ready pending queues, adding allowed requests to the multi handle or marking invalid ones as failed.
+        ///
+        /// Ready queues dispatch one request at a time, always taking the request with the highest effective
+        /// priority among all of them (see HttpPriorityQueue), until every queue is empty or blocked by the rate
+        /// limiter. A blocked queue schedules a timer for the moment its limits allow its next request.
+        ///
+        /// A queue whose next request has a lower priority than the next request of a blocked queue sharing one
+        /// of its rate limits is held until a blocked queue is released. Otherwise a lighter request could take
+        /// the capacity the blocked one is waiting for, and keep taking it.
         void process_pending_requests() {
             std::unique_lock<std::mutex> lock(m_mutex);
-            if (m_pending_requests.empty()) return;
+            drain_submitted_requests();
+            if (m_ready_queues.empty()) return;
+
+            std::vector<context_ptr_t> pending_request;
+            std::vector<context_ptr_t> failed_requests;
+            std::vector<context_ptr_t> expired_requests;
+            std::vector<context_ptr_t> rejected_requests;
+
+            using queue_iterator_t = std::map<limit_key_t, PendingQueue>::iterator;
+            std::vector<queue_iterator_t> ready_queues;
+            ready_queues.reserve(m_ready_queues.size());
+            for (const auto& key : m_ready_queues) {
+                auto queue_it = m_pending_queues.find(key);
+                if (queue_it == m_pending_queues.end() || queue_it->second.timer_id) continue;
+                if (std::find(ready_queues.begin(), ready_queues.end(), queue_it) != ready_queues.end()) continue;
+                ready_queues.push_back(queue_it);
+            }
+            m_ready_queues.clear();
+
+            const auto now = std::chrono::steady_clock::now();
+#           if KURLYK_ENABLE_METRICS
+            auto& builtin = metrics::builtin();
+#           endif
+
+            // Next request of the blocked queues with the highest priority, by rate limit ID.
+            std::map<long, const HttpRequestContext*> blocked_limits;
+            auto block_limits = [&blocked_limits, now](const limit_key_t& key, const HttpRequestContext* head) {
+                for (long id : key) {
+                    const HttpRequestContext*& blocker = blocked_limits[id];
+                    if (!blocker || HttpPriorityQueue::is_before(*head, *blocker, now)) blocker = head;
+                }
+            };
+            auto is_held = [&blocked_limits, now](const limit_key_t& key, const HttpRequestContext& head) {
+                for (long id : key) {
+                    auto it = blocked_limits.find(id);
+                    if (it != blocked_limits.end() && HttpPriorityQueue::is_before(*it->second, head, now)) return true;
+                }
+                return false;
+            };
+            for (auto& item : m_pending_queues) {
+                if (!item.second.timer_id || item.second.requests.empty()) continue;
+                block_limits(item.first, item.second.requests.top(now).get());
+            }
 
-            std::vector<std::unique_ptr<HttpRequestContext>> pending_request;
-            std::vector<std::unique_ptr<HttpRequestContext>> failed_requests;
+            while (!ready_queues.empty()) {
+                // Pick the queue whose next request has the highest priority.
+                std::size_t best = 0;
+                for (std::size_t i = 1; i < ready_queues.size(); ++i) {
+                    if (HttpPriorityQueue::is_before(
+                            *ready_queues[i]->second.requests.top(now),
+                            *ready_queues[best]->second.requests.top(now), now)) {
+                        best = i;
+                    }
+                }
+                auto queue_it = ready_queues[best];
+                const limit_key_t& key = queue_it->first;
+                auto& queue = queue_it->second;
+                auto& context = queue.requests.top(now);
 
-            auto it = m_pending_requests.begin();
-            while (it != m_pending_requests.end()) {
-                auto& context = *it;
-                auto& request = context->request;
+                bool is_queue_done = false;
                 // Check if the request is valid.
-                if (!request) {
-                    failed_requests.push_back(std::move(context));
-                    it = m_pending_requests.erase(it);
-                    continue;
+                if (!context->request) {
+                    failed_requests.push_back(pop_pending_request(queue, context));
+#                   if KURLYK_ENABLE_METRICS
+                    builtin.http_pending.dec();
+#                   endif
+                } else
+                // Drop the request without consuming rate-limit budget if its deadline has passed.
+                if (is_deadline_passed(*context->request, now)) {
+                    expired_requests.push_back(pop_pending_request(queue, context));
+#                   if KURLYK_ENABLE_METRICS
+                    builtin.http_pending.dec();
+                    builtin.http_deadline_exceeded.inc();
+#                   endif
+                } else
+                // Fail fast without consuming rate-limit budget if the circuit of the host is open.
+                if (context->request->circuit_breaker &&
+                    !m_circuit_breaker.allow(utils::extract_origin(context->request->url), *context->request->circuit_breaker, now)) {
+                    rejected_requests.push_back(pop_pending_request(queue, context));
+#                   if KURLYK_ENABLE_METRICS
+                    builtin.http_pending.dec();
+                    builtin.http_circuit_rejected.inc();
+#                   endif
+                } else
+                // Wait behind a blocked request with a higher priority that shares a rate limit.
+                if (is_held(key, *context)) {
+                    m_held_queues.insert(key);
+                    if (context->request->deadline != time_point_t()) {
+                        // Wake up at the deadline to complete the request on time if it is still held.
+                        const limit_key_t timer_key = key;
+                        queue.timer_id = core::NetworkWorker::get_instance().add_timer_at(context->request->deadline, [this, timer_key]() {
+                            release_pending_queue(timer_key);
+                        });
+                    }
+                    is_queue_done = true;
+                } else {
+                    // Check if the request is allowed by the rate limiter.
+                    const long weight = context->request->rate_limit_weight;
+                    if (m_rate_limiter.allow_request(key, weight)) {
+                        if (context->request->circuit_breaker) {
+                            m_circuit_breaker.on_dispatch(utils::extract_origin(context->request->url));
+                        }
+#                       if KURLYK_ENABLE_METRICS
+                        builtin.http_pending.dec();
+                        builtin.http_queue_wait.observe(now - context->start_time);
+#                       endif
+                        KURLYK_TRACE_STAGE(*context, "rate_limit_wait");
+                        pending_request.push_back(pop_pending_request(queue, context));
+                    } else {
+                        auto allowed_time = m_rate_limiter.next_allowed_time(key, weight);
+                        if (context->request->deadline != time_point_t()) {
+                            // Wake up at the deadline to complete the request on time if it is still blocked.
+                            allowed_time = std::min(allowed_time, context->request->deadline);
+                        }
+                        const limit_key_t timer_key = key;
+                        queue.timer_id = core::NetworkWorker::get_instance().add_timer_at(allowed_time, [this, timer_key]() {
+                            release_pending_queue(timer_key);
+                        });
+                        block_limits(key, context.get());
+#                       if KURLYK_ENABLE_METRICS
+                        builtin.http_throttled.inc();
+#                       endif
+                        is_queue_done = true;
+                    }
                 }
 
-                // Check if the request is allowed by the rate limiter.
-                const bool allowed = m_rate_limiter.allow_request(
-                    request->general_rate_limit_id,
-                    request->specific_rate_limit_id);
-                if (!allowed) {
-                    ++it;
-                    continue;
+                if (queue.requests.empty()) {
+                    if (!queue.timer_id) m_pending_queues.erase(queue_it);
+                    is_queue_done = true;
+                }
+                if (is_queue_done) {
+                    ready_queues.erase(ready_queues.begin() + best);
                 }
-                pending_request.push_back(std::move(context));
-                it = m_pending_requests.erase(it);
             }
             lock.unlock();
 
+            // Complete expired requests without sending them.
+            for (const auto &context : expired_requests) {
+#               if __cplusplus >= 201402L
+                auto response = std::make_unique<HttpResponse>();
+#               else
+                auto response = std::unique_ptr<HttpResponse>(new HttpResponse());
+#               endif
+                const long REQUEST_TIMEOUT = 408;
+                response->error_code = utils::make_error_code(utils::ClientError::DeadlineExceeded);
+                response->status_code = REQUEST_TIMEOUT;
+                response->retry_attempt = context->retry_attempt;
+                response->ready = true;
+                context->callback(std::move(response));
+            }
+
+            // Complete requests to hosts with an open circuit without sending them.
+            for (const auto &context : rejected_requests) {
+#               if __cplusplus >= 201402L
+                auto response = std::make_unique<HttpResponse>();
+#               else
+                auto response = std::unique_ptr<HttpResponse>(new HttpResponse());
+#               endif
+                const long SERVICE_UNAVAILABLE = 503;
+                response->error_code = utils::make_error_code(utils::ClientError::CircuitOpen);
+                response->status_code = SERVICE_UNAVAILABLE;
+                response->retry_attempt = context->retry_attempt;
+                response->ready = true;
+                context->callback(std::move(response));
+            }
+
             // Handle failed requests by calling their callback with a 400 status.
             if (!failed_requests.empty()) {
                 for (const auto &context : failed_requests) {
@@ -166,88 +1210,220 @@ namespace kurlyk {
                 failed_requests.clear();
             }
 
-            // If there are ready requests, create a new HttpBatchRequestHandler to manage them.
+            // Add ready requests to the persistent multi handle so they can reuse cached connections.
             if (pending_request.empty()) return;
-#           if __cplusplus >= 201402L
-            m_active_request_batches.push_back(std::make_unique<HttpBatchRequestHandler>(pending_request));
-#           else
-            m_active_request_batches.push_back(std::unique_ptr<HttpBatchRequestHandler>(new HttpBatchRequestHandler(pending_request)));
-#           endif
+            for (auto& context : pending_request) {
+                if (!context->on_dispatch) continue;
+                auto on_dispatch = std::move(context->on_dispatch);
+                context->on_dispatch = nullptr;
+                on_dispatch();
+            }
+            if (m_shards.empty()) {
+                m_batch_handler->add_requests(pending_request);
+                return;
+            }
+            for (auto& context : pending_request) {
+                get_shard(*context->request).add_request(std::move(context));
+            }
+        }
+
+        /// \brief Checks whether the deadline of a request has passed.
+        /// \param request Request to check.
+        /// \param now Current time.
+        /// \return True if the request has a deadline and it is not later than `now`.
+        static bool is_deadline_passed(const HttpRequest& request, time_point_t now) {
+            return request.deadline != time_point_t() && request.deadline <= now;
+        }
+
+        /// \brief Selects the worker shard for a request.
+        ///
+        /// Requests with the same shard key, or with the same origin if no key is set, always go to the
+        /// same shard, so they keep their submission order and share that shard's connections.
+        /// \param request Request to route.
+        /// \return Reference to the selected shard.
+        HttpWorkerShard& get_shard(const HttpRequest& request) {
+            const std::string key = request.shard_key.empty() ? utils::extract_origin(request.url) : request.shard_key;
+            return *m_shards[std::hash<std::string>()(key) % m_shards.size()];
+        }
+
+        /// \brief Schedules retries for the failed requests handed back by the shards.
+        void drain_shard_failed_requests() {
+            std::size_t count = m_shard_failed_requests.size();
+            while (count--) {
+                auto context = m_shard_failed_requests.pop();
+                if (!context) break;
+                schedule_retry(std::move(context));
+            }
         }
 
-        /// \brief Processes active requests, moving failed ones to the failed requests list for retrying.
+        /// \brief Processes active requests, scheduling a retry timer for each failed one.
         void process_active_requests() {
-            auto it = m_active_request_batches.begin();
-            while (it != m_active_request_batches.end()) {
-                auto& request = *it;
-                if (!request->process()) {
-                    ++it;
-                    continue;
-                }
-                auto failed_requests = request->extract_failed_requests();
-                it = m_active_request_batches.erase(it);
-                for (auto& request : failed_requests) {
-                    m_failed_requests.push_back(std::move(request));
-                }
+            if (!m_shards.empty()) {
+                drain_shard_failed_requests();
+#               if KURLYK_ENABLE_METRICS
+                std::size_t active = 0;
+                for (const auto& shard : m_shards) active += shard->get_active_count();
+                metrics::builtin().http_active.set(static_cast<int64_t>(active));
+#               endif
+                return;
+            }
+            m_batch_handler->process();
+#           if KURLYK_ENABLE_METRICS
+            metrics::builtin().http_active.set(static_cast<int64_t>(m_batch_handler->size()));
+#           endif
+            auto failed_requests = m_batch_handler->extract_failed_requests();
+            for (auto& context : failed_requests) {
+                if (!context || !context->request) continue;
+                schedule_retry(std::move(context));
             }
         }
 
-        /// \brief Attempts to retry failed requests if their retry delay has passed.
-        void process_retry_failed_requests() {
-            auto it = m_failed_requests.begin();
-            while (it != m_failed_requests.end()) {
-                auto& request_context = *it;
-                if (!request_context || !request_context->request) {
-                    it = m_failed_requests.erase(it);
-                    continue;
-                }
+        /// \brief Keeps a failed request until its retry delay has passed, then returns it to its pending queue.
+        /// \param context Context of the failed request; `start_time` holds the time of the failure.
+        void schedule_retry(context_ptr_t context) {
+            const auto deadline = context->start_time + std::chrono::milliseconds(context->retry_delay_ms);
+            const auto now = std::chrono::steady_clock::now();
+            const auto delay = deadline > now ? deadline - now : core::TimerQueue::duration_t::zero();
 
-                const auto now = std::chrono::steady_clock::now();
-                const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - request_context->start_time);
-                const auto& retry_delay_ms = request_context->request->retry_delay_ms;
-                if (duration.count() >= retry_delay_ms) {
-                    std::unique_lock<std::mutex> lock(m_mutex);
-                    m_pending_requests.push_back(std::move(request_context));
-                    lock.unlock();
-                    it = m_failed_requests.erase(it);
-                    continue;
-                }
-                ++it;
-            }
+#           if KURLYK_ENABLE_METRICS
+            metrics::builtin().http_retries.inc();
+            metrics::builtin().http_retry_waiting.inc();
+#           endif
+            const uint64_t key = m_next_retry_key++;
+            m_retry_keys[context->request->request_id].insert(key);
+            RetryEntry& entry = m_retry_requests[key];
+            entry.context = std::move(context);
+            entry.timer_id = core::NetworkWorker::get_instance().add_timer(delay, [this, key]() {
+                auto it = m_retry_requests.find(key);
+                if (it == m_retry_requests.end()) return;
+                auto context = std::move(it->second.context);
+                m_retry_requests.erase(it);
+                remove_retry_key(context->request->request_id, key);
+#               if KURLYK_ENABLE_METRICS
+                metrics::builtin().http_retry_waiting.dec();
+#               endif
+                KURLYK_TRACE_STAGE(*context, "retry_wait");
+                std::lock_guard<std::mutex> lock(m_mutex);
+                enqueue_pending_request(std::move(context));
+            });
+        }
+
+        /// \brief Removes a key of m_retry_requests from the request ID index.
+        /// \param request_id ID of the request.
+        /// \param key Key of the request in m_retry_requests.
+        void remove_retry_key(uint64_t request_id, uint64_t key) {
+            auto it = m_retry_keys.find(request_id);
+            if (it == m_retry_keys.end()) return;
+            it->second.erase(key);
+            if (it->second.empty()) m_retry_keys.erase(it);
         }
 
         /// \brief Processes and cancels HTTP requests based on their IDs.
+        ///
+        /// Requests are found through indexes by request ID wherever they are: in the submission and
+        /// pending queues, waiting for a retry, or being transferred, so the cost does not depend on
+        /// the number of other requests in flight.
         void process_cancel_requests() {
             std::unique_lock<std::mutex> lock(m_mutex);
             if (m_requests_to_cancel.empty()) return;
 
             auto requests_to_cancel = std::move(m_requests_to_cancel);
             m_requests_to_cancel.clear();
+            drain_submitted_requests();
+            // Request IDs and tags cancel the submissions sent with them.
+            m_request_groups.expand(requests_to_cancel);
+            std::vector<HttpCoalesceGroup::Waiter> detached;
+            detach_coalesced_requests(requests_to_cancel, detached);
+            // Cancelling a hedged request cancels both of its copies.
+            std::vector<uint64_t> copy_ids;
+            for (const auto& request : requests_to_cancel) {
+                auto range = m_hedge_ids.equal_range(request.first);
+                for (auto it = range.first; it != range.second; ++it) copy_ids.push_back(it->second);
+            }
+            for (uint64_t id : copy_ids) requests_to_cancel[id];
+            std::vector<context_ptr_t> pending_requests;
+            extract_pending_requests(requests_to_cancel, pending_requests);
             lock.unlock();
 
-            for (const auto &request_context : m_failed_requests) {
-                if (!requests_to_cancel.count(request_context->request->request_id)) continue;
+            // With shards, the batch goes out before the retry-waiting requests are checked: a request failing
+            // on a shard meanwhile is either handed back before the shard sees the batch, and drained here, or
+            // completed as cancelled by the shard. Holding the batch delays its callbacks until this pass is done.
+            std::shared_ptr<HttpCancelBatch> batch;
+            if (!m_shards.empty()) {
+                batch = std::make_shared<HttpCancelBatch>(std::move(requests_to_cancel));
+                for (auto& shard : m_shards) shard->cancel_requests(batch);
+                drain_shard_failed_requests();
+            }
+            const auto& cancel_ids = batch ? batch->get_requests() : requests_to_cancel;
+
+            for (auto& context : pending_requests) {
 #               if __cplusplus >= 201402L
                 auto response = std::make_unique<HttpResponse>();
 #               else
                 auto response = std::unique_ptr<HttpResponse>(new HttpResponse());
 #               endif
                 const long CANCELED_REQUEST_CODE = 499;
-                response->error_code = utils::make_error_code(CURLE_OK);
+                response->error_code = utils::make_error_code(utils::ClientError::CancelledByUser);
                 response->status_code = CANCELED_REQUEST_CODE;
+                response->retry_attempt = context->retry_attempt;
                 response->ready = true;
-                request_context->callback(std::move(response));
+                context->callback(std::move(response));
+#               if KURLYK_ENABLE_METRICS
+                metrics::builtin().http_pending.dec();
+                metrics::builtin().http_cancellations.inc();
+#               endif
             }
 
-            m_failed_requests.remove_if([&](const std::unique_ptr<HttpRequestContext>& ctx) {
-                return ctx && ctx->request && requests_to_cancel.count(ctx->request->request_id) > 0;
-            });
-
+            for (auto& waiter : detached) {
+#               if __cplusplus >= 201402L
+                auto response = std::make_unique<HttpResponse>();
+#               else
+                auto response = std::unique_ptr<HttpResponse>(new HttpResponse());
+#               endif
+                const long CANCELED_REQUEST_CODE = 499;
+                response->error_code = utils::make_error_code(utils::ClientError::CancelledByUser);
+                response->status_code = CANCELED_REQUEST_CODE;
+                response->ready = true;
+                if (waiter.callback) waiter.callback(std::move(response));
+#               if KURLYK_ENABLE_METRICS
+                metrics::builtin().http_cancellations.inc();
+#               endif
+            }
 
-            for (const auto &handler : m_active_request_batches) {
-                handler->cancel_request_by_id(requests_to_cancel);
+            for (const auto& request : cancel_ids) {
+                auto keys_it = m_retry_keys.find(request.first);
+                if (keys_it == m_retry_keys.end()) continue;
+                const auto keys = std::move(keys_it->second);
+                m_retry_keys.erase(keys_it);
+                for (uint64_t key : keys) {
+                    auto it = m_retry_requests.find(key);
+                    if (it == m_retry_requests.end()) continue;
+                    const auto& request_context = it->second.context;
+                    core::NetworkWorker::get_instance().cancel_timer(it->second.timer_id);
+#                   if __cplusplus >= 201402L
+                    auto response = std::make_unique<HttpResponse>();
+#                   else
+                    auto response = std::unique_ptr<HttpResponse>(new HttpResponse());
+#                   endif
+                    const long CANCELED_REQUEST_CODE = 499;
+                    response->error_code = utils::make_error_code(utils::ClientError::CancelledByUser);
+                    response->status_code = CANCELED_REQUEST_CODE;
+                    response->retry_attempt = request_context->retry_attempt;
+                    response->ready = true;
+                    request_context->callback(std::move(response));
+                    m_retry_requests.erase(it);
+#                   if KURLYK_ENABLE_METRICS
+                    metrics::builtin().http_retry_waiting.dec();
+                    metrics::builtin().http_cancellations.inc();
+#                   endif
+                }
             }
 
+            // The callbacks of a batch run once the last shard has processed it.
+            if (batch) return;
+
+            m_batch_handler->cancel_request_by_id(requests_to_cancel);
+
             for (const auto &request : requests_to_cancel) {
                 for (const auto &callback : request.second) {
                     if (callback) callback();
@@ -255,46 +1431,84 @@ namespace kurlyk {
             }
         }
 
-        /// \brief Cleans up pending requests, marking each as failed and invoking its callback.
+        /// \brief Cleans up pending and retry-waiting requests, marking each as failed and invoking its callback.
         void cleanup_pending_requests() {
+            auto& worker = core::NetworkWorker::get_instance();
+            std::list<context_ptr_t> pending_requests;
             std::unique_lock<std::mutex> lock(m_mutex);
-            auto pending_requests = std::move(m_pending_requests);
-            m_pending_requests.clear();
+            drain_submitted_requests();
+            for (auto& item : m_pending_queues) {
+                if (item.second.timer_id) worker.cancel_timer(item.second.timer_id);
+                item.second.requests.splice_to(pending_requests);
+            }
+            m_pending_queues.clear();
+            m_ready_queues.clear();
+            m_held_queues.clear();
+            m_pending_contexts.clear();
             lock.unlock();
+#           if KURLYK_ENABLE_METRICS
+            metrics::builtin().http_pending.dec(static_cast<int64_t>(pending_requests.size()));
+            metrics::builtin().http_retry_waiting.dec(static_cast<int64_t>(m_retry_requests.size()));
+#           endif
 
-            for (const auto &request_context : pending_requests) {
-#               if __cplusplus >= 201402L
-                auto response = std::make_unique<HttpResponse>();
-#               else
-                auto response = std::unique_ptr<HttpResponse>(new HttpResponse());
-#               endif
-                const long CANCELED_REQUEST_CODE = 499;
-                response->error_code = utils::make_error_code(CURLE_OK);
-                response->status_code = CANCELED_REQUEST_CODE;
-                response->ready = true;
-                request_context->callback(std::move(response));
+            for (auto& item : m_retry_requests) {
+                worker.cancel_timer(item.second.timer_id);
+                pending_requests.push_back(std::move(item.second.context));
             }
-            for (const auto &request_context : m_failed_requests) {
+            m_retry_requests.clear();
+            m_retry_keys.clear();
+
+            for (const auto &request_context : pending_requests) {
 #               if __cplusplus >= 201402L
                 auto response = std::make_unique<HttpResponse>();
 #               else
                 auto response = std::unique_ptr<HttpResponse>(new HttpResponse());
 #               endif
                 const long CANCELED_REQUEST_CODE = 499;
-                response->error_code = utils::make_error_code(CURLE_OK);
+                response->error_code = utils::make_error_code(utils::ClientError::CancelledByUser);
                 response->status_code = CANCELED_REQUEST_CODE;
+                response->retry_attempt = request_context->retry_attempt;
                 response->ready = true;
                 request_context->callback(std::move(response));
             }
         }
 
-        /// \brief Private constructor to initialize global resources (e.g., cURL).
+        /// \brief Private constructor to initialize global resources (e.g., cURL) and the multi handle.
         HttpRequestManager() {
             curl_global_init(CURL_GLOBAL_ALL);
+#           if __cplusplus >= 201402L
+            m_batch_handler = std::make_unique<HttpBatchRequestHandler>();
+#           else
+            m_batch_handler = std::unique_ptr<HttpBatchRequestHandler>(new HttpBatchRequestHandler());
+#           endif
+            create_shards(KURLYK_HTTP_WORKER_SHARDS);
+        }
+
+        /// \brief Starts the worker shards.
+        ///
+        /// The shards share DNS results and TLS sessions, but each keeps its own connection cache,
+        /// since libcurl does not support sharing connections between concurrently used multi handles.
+        /// \param count Number of shards; 0 keeps all transfers on the NetworkWorker thread.
+        void create_shards(std::size_t count) {
+            if (!count) return;
+            auto share_handle = std::make_shared<HttpShareHandle>(false);
+            HttpWorkerShard::failed_handler_t on_failed = [this](context_ptr_t context) {
+                m_shard_failed_requests.push(std::move(context));
+                core::NetworkWorker::get_instance().notify();
+            };
+            for (std::size_t i = 0; i < count; ++i) {
+#               if __cplusplus >= 201402L
+                m_shards.push_back(std::make_unique<HttpWorkerShard>(share_handle, on_failed));
+#               else
+                m_shards.push_back(std::unique_ptr<HttpWorkerShard>(new HttpWorkerShard(share_handle, on_failed)));
+#               endif
+            }
         }
 
         /// \brief Private destructor to clean up global resources.
         virtual ~HttpRequestManager() {
+            m_shards.clear();
+            m_batch_handler.reset();
             curl_global_cleanup();
         }
 
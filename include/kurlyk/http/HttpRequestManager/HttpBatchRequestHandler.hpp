@@ -9,40 +9,58 @@ namespace kurlyk {
 
     /// \class HttpBatchRequestHandler
     /// \brief Handles multiple asynchronous HTTP requests using libcurl's multi interface.
+    ///
+    /// The handler owns a single long-lived multi handle. Requests are added incrementally and
+    /// removed as soon as they complete, so the multi handle's connection cache survives between
+    /// requests and keep-alive connections and HTTP/2 streams are reused. All easy handles are
+    /// attached to a common share object, so DNS results and TLS sessions are reused as well.
+    ///
+    /// Easy handles are indexed by request ID, so cancelling a request does not scan the active ones.
     class HttpBatchRequestHandler {
     public:
 
-        /// \brief Constructs a handler for managing multiple HTTP requests asynchronously.
+        /// \brief Constructs a handler with an empty multi handle.
+        /// \param share_handle Share object to attach easy handles to. If null, the handler creates its own
+        /// share object, which also shares the connection cache.
+        explicit HttpBatchRequestHandler(std::shared_ptr<HttpShareHandle> share_handle = nullptr)
+            : m_multi_handle(curl_multi_init()),
+              m_share_handle(std::move(share_handle)) {
+            if (!m_share_handle) m_share_handle = std::make_shared<HttpShareHandle>();
+            if (!m_multi_handle) return;
+            curl_multi_setopt(m_multi_handle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+        }
+
+        /// \brief Cleans up the multi handle and removes all request handles.
+        ~HttpBatchRequestHandler() {
+            clear();
+            if (m_multi_handle) curl_multi_cleanup(m_multi_handle);
+        }
+
+        /// \brief Adds requests to the multi handle.
         /// \param context_list List of unique pointers to HttpRequestContext objects.
-        explicit HttpBatchRequestHandler(std::vector<std::unique_ptr<HttpRequestContext>>& context_list)
-            : m_multi_handle(curl_multi_init()) {
+        void add_requests(std::vector<std::unique_ptr<HttpRequestContext>>& context_list) {
             for (auto& context : context_list) {
+                KURLYK_TRACE_STAGE(*context, "admission");
 #               if __cplusplus >= 201402L
-                auto handler = std::make_unique<HttpRequestHandler>(std::move(context));
+                auto handler = std::make_unique<HttpRequestHandler>(std::move(context), &m_handle_pool);
 #               else
-                auto handler = std::unique_ptr<HttpRequestHandler>(new HttpRequestHandler(std::move(context)));
+                auto handler = std::unique_ptr<HttpRequestHandler>(new HttpRequestHandler(std::move(context), &m_handle_pool));
 #               endif
                 CURL* curl = handler->get_curl();
-                if (!curl) continue;
-
-                curl_multi_add_handle(m_multi_handle, curl);
-                m_handlers.push_back(std::move(handler));
-            }
-        }
+                if (!curl || !m_multi_handle) continue;
+                m_share_handle->attach(curl);
 
-        /// \brief Cleans up the multi handle and removes all request handles.
-        ~HttpBatchRequestHandler() {
-            for (auto& handler : m_handlers) {
-                CURL* curl = handler->get_curl();
-                if (!curl) continue;
-                curl_multi_remove_handle(m_multi_handle, curl);
+                if (curl_multi_add_handle(m_multi_handle, curl) != CURLM_OK) continue;
+                m_request_handles[handler->get_request_id()].insert(curl);
+                m_handlers.emplace(curl, std::move(handler));
             }
-            curl_multi_cleanup(m_multi_handle);
         }
 
-        /// \brief Processes the requests within the handler.
-        /// \return True if all requests are completed, false otherwise.
+        /// \brief Performs transfers and handles completed requests.
+        /// \return True if no requests remain in the handler, false otherwise.
         bool process() {
+            if (m_handlers.empty()) return true;
+
             int still_running = 0;
             CURLMcode res = curl_multi_perform(m_multi_handle, &still_running);
             if (res != CURLM_OK) return false;
@@ -52,54 +70,114 @@ namespace kurlyk {
                 if (message->msg != CURLMSG_DONE) continue;
                 handle_completed_request(message);
             }
-            if (still_running == 0) {
-                m_handlers.clear();
-                return true;
+            return m_handlers.empty();
+        }
+
+        /// \brief Waits for activity on the active transfers.
+        /// \param timeout_ms Maximum time to block, in milliseconds.
+        /// \return True if the wait was performed, false on a libcurl error.
+        bool poll(int timeout_ms) {
+            return curl_multi_poll(m_multi_handle, nullptr, 0, timeout_ms, nullptr) == CURLM_OK;
+        }
+
+        /// \brief Interrupts a concurrent or the next call to poll(). Safe to call from any thread.
+        void wakeup() {
+            if (m_multi_handle) curl_multi_wakeup(m_multi_handle);
+        }
+
+        /// \brief Returns the time until libcurl needs to perform timeout handling.
+        /// \return Timeout in milliseconds, or -1 if libcurl has no timeout set.
+        long get_timeout_ms() {
+            long timeout_ms = -1;
+            if (curl_multi_timeout(m_multi_handle, &timeout_ms) != CURLM_OK) return 0;
+            return timeout_ms;
+        }
+
+        /// \brief Checks whether there are requests in progress.
+        /// \return True if no requests are attached to the multi handle.
+        bool empty() const {
+            return m_handlers.empty();
+        }
+
+        /// \brief Returns the number of requests in progress.
+        /// \return Number of requests attached to the multi handle.
+        std::size_t size() const {
+            return m_handlers.size();
+        }
+
+        /// \brief Removes all requests from the multi handle.
+        ///
+        /// Requests whose callback has not been called yet are completed with an abort error.
+        void clear() {
+            for (auto& item : m_handlers) {
+                curl_multi_remove_handle(m_multi_handle, item.first);
             }
-            return false;
+            m_handlers.clear();
+            m_request_handles.clear();
         }
 
         /// \brief Extracts the list of failed requests.
         /// \return A list of failed request contexts.
         std::list<std::unique_ptr<HttpRequestContext>> extract_failed_requests() {
-            return std::move(m_failed_requests);
+            auto failed_requests = std::move(m_failed_requests);
+            m_failed_requests.clear();
+            return failed_requests;
         }
 
         /// \brief Cancels HTTP requests based on their unique IDs.
         /// \param to_cancel A map of request IDs to their corresponding cancellation callbacks.
         void cancel_request_by_id(const std::unordered_map<uint64_t, std::list<std::function<void()>>>& to_cancel) {
-            auto it = m_handlers.begin();
-            while (it != m_handlers.end()) {
-                uint64_t id = (*it)->get_request_id();
-                if (!to_cancel.count(id)) {
-                    ++it;
-                    continue;
+            for (const auto& request : to_cancel) {
+                auto ids_it = m_request_handles.find(request.first);
+                if (ids_it == m_request_handles.end()) continue;
+                const auto handles = std::move(ids_it->second);
+                m_request_handles.erase(ids_it);
+                for (CURL* curl : handles) {
+                    auto it = m_handlers.find(curl);
+                    if (it == m_handlers.end()) continue;
+                    curl_multi_remove_handle(m_multi_handle, curl);
+                    it->second->cancel(); // Cancel the request.
+                    m_handlers.erase(it);
                 }
-                curl_multi_remove_handle(m_multi_handle, (*it)->get_curl());
-                (*it)->cancel(); // Cancel the request.
-                it = m_handlers.erase(it);
             }
         }
 
     private:
-        CURLM* m_multi_handle = nullptr; ///< libcurl multi handle.
-        std::vector<std::unique_ptr<HttpRequestHandler>> m_handlers; ///< Collection of active request handlers.
-        std::list<std::unique_ptr<HttpRequestContext>>   m_failed_requests; ///< List of failed request contexts.
+        using handler_map_t = std::unordered_map<CURL*, std::unique_ptr<HttpRequestHandler>>;
+        CURLM*                                         m_multi_handle = nullptr; ///< libcurl multi handle, kept for the lifetime of the handler.
+        std::shared_ptr<HttpShareHandle>               m_share_handle;           ///< Share object for DNS, TLS sessions and connections; must outlive all easy handles.
+        HttpEasyHandlePool                             m_handle_pool;            ///< Idle easy handles reused by new requests.
+        handler_map_t                                  m_handlers;               ///< Active request handlers keyed by their easy handle.
+        std::unordered_map<uint64_t, std::unordered_set<CURL*>> m_request_handles; ///< Easy handles of the active requests by request ID.
+        std::list<std::unique_ptr<HttpRequestContext>> m_failed_requests;        ///< List of failed request contexts.
 
         /// \brief Handles the completion of a single request.
         /// \param message CURLMsg structure containing the result of the completed request.
         void handle_completed_request(CURLMsg* message) {
             CURL* curl = message->easy_handle;
+            auto it = m_handlers.find(curl);
+            if (it == m_handlers.end()) {
+                curl_multi_remove_handle(m_multi_handle, curl);
+                return;
+            }
 
-            void* ptr = nullptr;
-            curl_easy_getinfo(curl, CURLINFO_PRIVATE, &ptr);
-            auto* handler = static_cast<HttpRequestHandler*>(ptr);
-            if (!handler) return;
-
+            auto& handler = it->second;
+            remove_request_handle(handler->get_request_id(), curl);
             if (!handler->handle_curl_message(message)) {
                 m_failed_requests.push_back(handler->get_request_context());
             }
             curl_multi_remove_handle(m_multi_handle, curl);
+            m_handlers.erase(it);
+        }
+
+        /// \brief Removes an easy handle from the request ID index.
+        /// \param request_id ID of the request.
+        /// \param curl Easy handle of the request.
+        void remove_request_handle(uint64_t request_id, CURL* curl) {
+            auto it = m_request_handles.find(request_id);
+            if (it == m_request_handles.end()) return;
+            it->second.erase(curl);
+            if (it->second.empty()) m_request_handles.erase(it);
         }
 
     }; // HttpBatchRequestHandler
@@ -0,0 +1,121 @@
+#pragma once
+#ifndef _KURLYK_HTTP_CA_BUNDLE_HPP_INCLUDED
+#define _KURLYK_HTTP_CA_BUNDLE_HPP_INCLUDED
+
+/// \file HttpCaBundle.hpp
+/// \brief Defines a process-wide in-memory cache of the default CA certificate bundle.
+
+namespace kurlyk {
+
+    /// \class HttpCaBundle
+    /// \brief Loads the default CA bundle once and hands it to every request that has no `ca_file`.
+    ///
+    /// By default the bundle is read from `curl-ca-bundle.crt` next to the executable. The file is
+    /// read on first use and kept in memory until reload() is called. Requests keep a reference
+    /// to the bundle they were configured with, so reloading never invalidates a running transfer.
+    ///
+    /// libcurl 7.87 and newer cache the store parsed from a CAINFO file in the multi handle, but not
+    /// one parsed from a CAINFO_BLOB. On those versions requests pass the bundle path until the first
+    /// reload. After it they pass the blob: a file rewritten in place keeps its path, so libcurl would
+    /// go on reusing connections and TLS sessions verified against the old certificates.
+    class HttpCaBundle {
+    public:
+        using bundle_ptr_t = std::shared_ptr<const std::string>;
+
+        /// \brief Get the singleton instance of HttpCaBundle.
+        /// \return Reference to the singleton instance.
+        static HttpCaBundle& get_instance() {
+            static HttpCaBundle* instance = new HttpCaBundle();
+            return *instance;
+        }
+
+        /// \brief Returns the cached CA bundle, loading it on first use.
+        /// \return Shared pointer to the PEM data, or nullptr if the bundle file could not be read.
+        bundle_ptr_t get() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_loaded) {
+                m_loaded = true;
+                m_bundle = load_file(get_path_locked());
+            }
+            return m_bundle;
+        }
+
+        /// \brief Returns the path of the bundle file.
+        /// \return Path in the encoding expected by libcurl (ANSI on Windows).
+        std::string get_path() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return get_path_locked();
+        }
+
+        /// \brief Re-reads the bundle, e.g. after certificate rotation.
+        /// \param path New bundle path in UTF-8; if empty, the current path is re-read.
+        /// \return True if the bundle was loaded; on failure the previous bundle is kept.
+        bool reload(const std::string& path = std::string()) {
+            std::string file_path;
+            if (!path.empty()) {
+#               if defined(_WIN32)
+                file_path = utils::utf8_to_ansi(path);
+#               else
+                file_path = path;
+#               endif
+            } else {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                file_path = get_path_locked();
+            }
+
+            bundle_ptr_t bundle = load_file(file_path);
+            if (!bundle) return false;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_path = std::move(file_path);
+            m_bundle = std::move(bundle);
+            m_loaded = true;
+            m_reloaded = true;
+            return true;
+        }
+
+        /// \brief Checks whether the bundle has been reloaded.
+        /// \return True if reload() has succeeded at least once.
+        bool is_reloaded() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_reloaded;
+        }
+
+    private:
+        std::mutex   m_mutex;            ///< Mutex protecting the bundle and its path.
+        std::string  m_path;             ///< Cached bundle path; resolved on first use.
+        bundle_ptr_t m_bundle;           ///< Cached PEM data.
+        bool         m_loaded = false;   ///< Indicates whether loading has been attempted.
+        bool         m_reloaded = false; ///< Indicates whether reload() has succeeded.
+
+        HttpCaBundle() = default;
+        HttpCaBundle(const HttpCaBundle&) = delete;
+        HttpCaBundle& operator=(const HttpCaBundle&) = delete;
+
+        /// \brief Resolves the default bundle path once. Must be called with the mutex held.
+        const std::string& get_path_locked() {
+            if (!m_path.empty()) return m_path;
+#           if defined(_WIN32)
+            m_path = utils::utf8_to_ansi(utils::get_exec_dir() + "\\curl-ca-bundle.crt");
+#           else
+            m_path = utils::get_exec_dir() + "/curl-ca-bundle.crt";
+#           endif
+            return m_path;
+        }
+
+        /// \brief Reads the whole bundle file.
+        /// \param path Path to the file.
+        /// \return File contents, or nullptr if the file is missing or empty.
+        static bundle_ptr_t load_file(const std::string& path) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file) return nullptr;
+            std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            if (data.empty()) return nullptr;
+            return std::make_shared<const std::string>(std::move(data));
+        }
+
+    }; // HttpCaBundle
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_CA_BUNDLE_HPP_INCLUDED
@@ -0,0 +1,23 @@
+#pragma once
+#ifndef _KURLYK_HTTP_CACHE_ENTRY_HPP_INCLUDED
+#define _KURLYK_HTTP_CACHE_ENTRY_HPP_INCLUDED
+
+/// \file HttpCacheEntry.hpp
+/// \brief Defines HttpCacheEntry, a response stored by the HTTP response cache.
+
+namespace kurlyk {
+
+    /// \struct HttpCacheEntry
+    /// \brief Cached response and its validators.
+    struct HttpCacheEntry {
+        long        status_code = 0; ///< HTTP status code of the response.
+        Headers     headers;         ///< Response headers.
+        std::string content;         ///< Response body.
+        std::string etag;            ///< Value of the `ETag` header, if any.
+        std::string last_modified;   ///< Value of the `Last-Modified` header, if any.
+        std::chrono::system_clock::time_point expires_at; ///< Time until which the entry may be used without revalidation.
+    }; // HttpCacheEntry
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_CACHE_ENTRY_HPP_INCLUDED
@@ -0,0 +1,139 @@
+#pragma once
+#ifndef _KURLYK_HTTP_CIRCUIT_BREAKER_HPP_INCLUDED
+#define _KURLYK_HTTP_CIRCUIT_BREAKER_HPP_INCLUDED
+
+/// \file HttpCircuitBreaker.hpp
+/// \brief Defines HttpCircuitBreaker, which tracks the failure rate of each host and opens its circuit.
+
+namespace kurlyk {
+
+    /// \class HttpCircuitBreaker
+    /// \brief Thread-safe circuit states of hosts, driven by HttpCircuitBreakerPolicy.
+    ///
+    /// A closed circuit counts responses in fixed windows and opens when a window reaches the failure rate
+    /// of the policy. An open circuit rejects requests until `open_ms` has passed, then turns half-open and
+    /// admits up to `probe_requests` requests. While half-open, any failure opens the circuit again and
+    /// `probe_requests` successes close it. If the probes never complete (e.g. they were cancelled),
+    /// new probes are admitted after another `open_ms`.
+    class HttpCircuitBreaker {
+    public:
+        using time_point_t = std::chrono::steady_clock::time_point;
+
+        /// \brief Checks whether a request to a host may be sent.
+        ///
+        /// Turns an open circuit whose open time has passed into a half-open one.
+        /// \param host Host key, e.g. the URL origin.
+        /// \param policy Policy of the request.
+        /// \param now Current time.
+        /// \return False if the request must fail fast.
+        bool allow(const std::string& host, const HttpCircuitBreakerPolicy& policy, time_point_t now) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_circuits.find(host);
+            if (it == m_circuits.end()) return true;
+            Circuit& circuit = it->second;
+            const auto open_time = std::chrono::milliseconds(policy.open_ms);
+            switch (circuit.state) {
+                case State::CLOSED:
+                    return true;
+                case State::OPEN:
+                    if (now - circuit.changed_at < open_time) return false;
+                    set_state(circuit, State::HALF_OPEN, now);
+                    return true;
+                case State::HALF_OPEN:
+                    if (circuit.probes_sent < policy.probe_requests) return true;
+                    if (now - circuit.changed_at < open_time) return false;
+                    set_state(circuit, State::HALF_OPEN, now);
+                    return true;
+            }
+            return true;
+        }
+
+        /// \brief Registers a request allowed by allow() as sent.
+        /// \param host Host key, e.g. the URL origin.
+        void on_dispatch(const std::string& host) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_circuits.find(host);
+            if (it == m_circuits.end() || it->second.state != State::HALF_OPEN) return;
+            ++it->second.probes_sent;
+        }
+
+        /// \brief Records the outcome of an attempt.
+        /// \param host Host key, e.g. the URL origin.
+        /// \param policy Policy of the request.
+        /// \param is_failure True if the attempt failed.
+        /// \param now Current time.
+        /// \return True if this outcome opened the circuit.
+        bool record(const std::string& host, const HttpCircuitBreakerPolicy& policy, bool is_failure, time_point_t now) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_circuits.find(host);
+            if (it == m_circuits.end()) {
+                if (!is_failure) return false;
+                it = m_circuits.emplace(host, Circuit()).first;
+                it->second.changed_at = now;
+            }
+            Circuit& circuit = it->second;
+            switch (circuit.state) {
+                case State::OPEN:
+                    return false;
+                case State::HALF_OPEN:
+                    if (is_failure) {
+                        set_state(circuit, State::OPEN, now);
+                        return true;
+                    }
+                    if (++circuit.successes >= std::max<std::size_t>(policy.probe_requests, 1)) {
+                        set_state(circuit, State::CLOSED, now);
+                    }
+                    return false;
+                case State::CLOSED:
+                    break;
+            }
+            if (now - circuit.changed_at >= std::chrono::milliseconds(policy.window_ms)) {
+                set_state(circuit, State::CLOSED, now);
+            }
+            if (is_failure) ++circuit.failures;
+            else ++circuit.successes;
+            const std::size_t total = circuit.failures + circuit.successes;
+            if (total < std::max<std::size_t>(policy.min_requests, 1) ||
+                static_cast<double>(circuit.failures) < policy.failure_rate * static_cast<double>(total)) {
+                return false;
+            }
+            set_state(circuit, State::OPEN, now);
+            return true;
+        }
+
+    private:
+
+        /// \enum State
+        /// \brief State of the circuit of a host.
+        enum class State {
+            CLOSED,     ///< Requests are sent and their outcomes counted.
+            OPEN,       ///< Requests fail fast.
+            HALF_OPEN,  ///< A limited number of probe requests are sent.
+        };
+
+        /// \struct Circuit
+        /// \brief Circuit of one host.
+        struct Circuit {
+            State        state = State::CLOSED; ///< Current state.
+            time_point_t changed_at;            ///< Start of the state, or of the counting window if closed.
+            std::size_t  successes = 0;         ///< Successful attempts since changed_at.
+            std::size_t  failures = 0;          ///< Failed attempts since changed_at.
+            std::size_t  probes_sent = 0;       ///< Probe requests sent while half-open.
+        };
+
+        std::mutex                               m_mutex;    ///< Mutex protecting m_circuits.
+        std::unordered_map<std::string, Circuit> m_circuits; ///< Circuits by host.
+
+        /// \brief Moves a circuit to a state and resets its counters.
+        static void set_state(Circuit& circuit, State state, time_point_t now) {
+            circuit.state = state;
+            circuit.changed_at = now;
+            circuit.successes = 0;
+            circuit.failures = 0;
+            circuit.probes_sent = 0;
+        }
+    }; // HttpCircuitBreaker
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_CIRCUIT_BREAKER_HPP_INCLUDED
@@ -0,0 +1,125 @@
+#pragma once
+#ifndef _KURLYK_HTTP_COALESCE_GROUP_HPP_INCLUDED
+#define _KURLYK_HTTP_COALESCE_GROUP_HPP_INCLUDED
+
+/// \file HttpCoalesceGroup.hpp
+/// \brief Defines HttpCoalesceGroup, which shares one HTTP transfer between identical requests.
+
+namespace kurlyk {
+
+    /// \class HttpCoalesceGroup
+    /// \brief Requests waiting for the same in-flight transfer.
+    ///
+    /// Every waiter receives its own copy of each response of the transfer. A waiter can leave the
+    /// group, e.g. when its request is cancelled; the transfer itself is cancelled only once no
+    /// waiters remain. The group is thread-safe.
+    class HttpCoalesceGroup : public std::enable_shared_from_this<HttpCoalesceGroup> {
+    public:
+
+        /// \struct Waiter
+        /// \brief Request attached to the transfer.
+        struct Waiter {
+            uint64_t             request_id = 0; ///< ID of the attached request.
+            HttpResponseCallback callback;       ///< Callback of the attached request.
+
+            Waiter() = default;
+
+            Waiter(uint64_t id, HttpResponseCallback on_response)
+                : request_id(id), callback(std::move(on_response)) {
+            }
+        };
+
+        /// \brief Constructs a group for a transfer.
+        /// \param key Coalescing key of the requests.
+        /// \param transfer_id Request ID of the shared transfer.
+        HttpCoalesceGroup(std::string key, uint64_t transfer_id)
+            : m_key(std::move(key)), m_transfer_id(transfer_id) {
+        }
+
+        /// \brief Attaches a request to the transfer.
+        /// \param request_id ID of the request.
+        /// \param callback Callback of the request.
+        /// \return False if the transfer has already completed or was abandoned.
+        bool add_waiter(uint64_t request_id, HttpResponseCallback callback) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_is_closed) return false;
+            m_waiters.emplace_back(request_id, std::move(callback));
+            return true;
+        }
+
+        /// \brief Detaches the requests with the given IDs.
+        /// \param request_ids IDs of the requests to detach.
+        /// \param removed Receives the detached requests.
+        /// \return True if no waiters remain, so the transfer should be cancelled.
+        template<class Map>
+        bool remove_waiters(const Map& request_ids, std::vector<Waiter>& removed) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_is_closed) return false;
+            auto it = m_waiters.begin();
+            while (it != m_waiters.end()) {
+                if (!request_ids.count(it->request_id)) {
+                    ++it;
+                    continue;
+                }
+                removed.push_back(std::move(*it));
+                it = m_waiters.erase(it);
+            }
+            if (!m_waiters.empty() || removed.empty()) return false;
+            m_is_closed = true;
+            return true;
+        }
+
+        /// \brief Creates the response callback of the shared transfer.
+        /// \param on_close Called with the waiters still attached once the final response arrives, before it is delivered.
+        /// \return Callback passing a copy of every response to every waiter.
+        HttpResponseCallback make_callback(std::function<void(const HttpCoalesceGroup&, const std::list<Waiter>&)> on_close) {
+            auto self = shared_from_this();
+            return [self, on_close](HttpResponsePtr response) {
+                if (!response) return;
+                std::unique_lock<std::mutex> lock(self->m_mutex);
+                std::list<Waiter> waiters;
+                if (response->ready) {
+                    self->m_is_closed = true;
+                    waiters.swap(self->m_waiters);
+                } else {
+                    waiters = self->m_waiters;
+                }
+                lock.unlock();
+                if (response->ready && on_close) on_close(*self, waiters);
+                deliver(waiters, std::move(response));
+            };
+        }
+
+        /// \brief Returns the coalescing key of the requests.
+        const std::string& get_key() const { return m_key; }
+
+        /// \brief Returns the request ID of the shared transfer.
+        uint64_t get_transfer_id() const { return m_transfer_id; }
+
+    private:
+        std::mutex        m_mutex;              ///< Mutex protecting the state below.
+        std::string       m_key;                ///< Coalescing key of the requests.
+        uint64_t          m_transfer_id = 0;    ///< Request ID of the shared transfer.
+        std::list<Waiter> m_waiters;            ///< Attached requests.
+        bool              m_is_closed = false;  ///< Whether the transfer completed or was abandoned.
+
+        /// \brief Passes a copy of a response to each waiter; the last one receives the original.
+        static void deliver(std::list<Waiter>& waiters, HttpResponsePtr response) {
+            for (auto it = waiters.begin(); it != waiters.end(); ++it) {
+                if (!it->callback) continue;
+                if (std::next(it) == waiters.end()) {
+                    it->callback(std::move(response));
+                    break;
+                }
+#               if __cplusplus >= 201402L
+                it->callback(std::make_unique<HttpResponse>(*response));
+#               else
+                it->callback(std::unique_ptr<HttpResponse>(new HttpResponse(*response)));
+#               endif
+            }
+        }
+    }; // HttpCoalesceGroup
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_COALESCE_GROUP_HPP_INCLUDED
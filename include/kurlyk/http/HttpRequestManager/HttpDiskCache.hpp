@@ -0,0 +1,394 @@
+#pragma once
+#ifndef _KURLYK_HTTP_DISK_CACHE_HPP_INCLUDED
+#define _KURLYK_HTTP_DISK_CACHE_HPP_INCLUDED
+
+/// \file HttpDiskCache.hpp
+/// \brief Defines HttpDiskCache, a persistent store of cached HTTP responses in memory-mapped segments.
+
+namespace kurlyk {
+
+    /// \class HttpDiskCache
+    /// \brief Append-only store of HttpCacheEntry records in memory-mapped segment files.
+    ///
+    /// Records are appended to the newest segment of a directory; a later record for the same request
+    /// fingerprint replaces an earlier one, and a tombstone record removes it. When the segments exceed the
+    /// size limit, the oldest segment is deleted with all the records in it. Each record carries the status,
+    /// headers (including the `ETag` / `Last-Modified` validators), body and expiry of the response, so after
+    /// a restart stale entries can be revalidated instead of downloaded again.
+    ///
+    /// Records are keyed by the SHA-256 digest of the request fingerprint rather than the fingerprint itself,
+    /// so the cookies and credentials it contains are never written to disk. A directory created by the store
+    /// and its segment files are accessible to their owner only.
+    ///
+    /// A store holds an exclusive lock on its directory for its lifetime. A second store on the same
+    /// directory, in this or another process, is not opened and neither reads nor writes records.
+    ///
+    /// On open, the segments are scanned to rebuild the in-memory index; scanning a segment stops at the first
+    /// record that is incomplete or fails its checksum, e.g. after a crash during a write. The class is thread-safe.
+    class HttpDiskCache {
+    public:
+        using Entry = HttpCacheEntry;
+
+        static constexpr std::size_t DEFAULT_MAX_BYTES     = 1024 * 1024 * 1024; ///< Default size limit of all segment files.
+        static constexpr std::size_t DEFAULT_SEGMENT_BYTES = 16 * 1024 * 1024;   ///< Default size of a segment file.
+
+        /// \brief Opens or creates a store.
+        /// \param directory Directory holding the segment files; created if missing.
+        /// \param max_bytes Maximum total size of the segment files.
+        /// \param segment_bytes Size of each segment file; larger entries are not stored.
+        HttpDiskCache(
+                std::string directory,
+                std::size_t max_bytes,
+                std::size_t segment_bytes = DEFAULT_SEGMENT_BYTES)
+            : m_directory(std::move(directory)),
+              m_segment_bytes(std::max<std::size_t>(segment_bytes, 4096)),
+              m_max_segments(std::max<std::size_t>(max_bytes / std::max<std::size_t>(segment_bytes, 4096), 1)) {
+            if (!utils::create_private_directories(m_directory)) return;
+            if (!m_lock.lock(get_file_path(LOCK_FILE_NAME))) return;
+            load();
+        }
+
+        HttpDiskCache(const HttpDiskCache&) = delete;
+        HttpDiskCache& operator=(const HttpDiskCache&) = delete;
+
+        /// \brief Checks whether the store can write records.
+        /// \return True if the directory is locked by this store and a segment file is open.
+        bool is_open() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return !m_segments.empty();
+        }
+
+        /// \brief Reads an entry.
+        /// \param key Request fingerprint.
+        /// \return The entry, or nullptr if there is none.
+        std::shared_ptr<Entry> find(const std::string& key) const {
+            const std::string digest = make_digest(key);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_index.find(digest);
+            if (it == m_index.end()) return nullptr;
+            auto segment_it = m_segments.find(it->second.segment_id);
+            if (segment_it == m_segments.end()) return nullptr;
+            return read_entry(segment_it->second->file.data() + it->second.offset);
+        }
+
+        /// \brief Appends an entry.
+        /// \param key Request fingerprint.
+        /// \param entry Entry to store; an entry larger than a segment is not stored.
+        void store(const std::string& key, const Entry& entry) {
+            std::string headers = serialize_headers(entry.headers);
+            const int64_t expires_at_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                entry.expires_at.time_since_epoch()).count();
+            const std::string digest = make_digest(key);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (append(digest, headers, entry.content, entry.status_code, expires_at_ms, 0)) {
+                m_index[digest] = m_last_location;
+            }
+        }
+
+        /// \brief Removes an entry by appending a tombstone.
+        /// \param key Request fingerprint.
+        void erase(const std::string& key) {
+            const std::string digest = make_digest(key);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_index.find(digest);
+            if (it == m_index.end()) return;
+            m_index.erase(it);
+            append(digest, std::string(), std::string(), 0, 0, FLAG_TOMBSTONE);
+        }
+
+        /// \brief Deletes all segment files.
+        void clear() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_lock.is_locked()) return;
+            while (!m_segments.empty()) drop_oldest_segment();
+            m_index.clear();
+        }
+
+    private:
+
+        /// \struct RecordHeader
+        /// \brief Fixed-size header preceding the key digest, headers and body of a record.
+        struct RecordHeader {
+            uint32_t magic;         ///< RECORD_MAGIC once the record is complete.
+            uint32_t checksum;      ///< FNV-1a hash of the rest of the record.
+            uint32_t key_size;      ///< Size of the key digest.
+            uint32_t headers_size;  ///< Size of the serialized headers.
+            uint64_t content_size;  ///< Size of the body.
+            int64_t  status_code;   ///< HTTP status code.
+            int64_t  expires_at_ms; ///< Expiry in milliseconds since the Unix epoch.
+            uint32_t flags;         ///< Record flags, e.g. FLAG_TOMBSTONE.
+            uint32_t reserved;      ///< Padding; always 0.
+        };
+
+        /// \struct Location
+        /// \brief Position of a record.
+        struct Location {
+            uint64_t    segment_id = 0; ///< Segment holding the record.
+            std::size_t offset = 0;     ///< Offset of the record in the segment.
+
+            Location() = default;
+
+            Location(uint64_t segment, std::size_t record_offset)
+                : segment_id(segment), offset(record_offset) {
+            }
+        };
+
+        /// \struct Segment
+        /// \brief Mapped segment file.
+        struct Segment {
+            utils::MappedFile file;     ///< Mapping of the file.
+            std::string       path;     ///< Path of the file.
+            std::size_t       used = 0; ///< Bytes taken by records.
+        };
+
+        static constexpr uint32_t RECORD_MAGIC   = 0x4B484332; ///< "KHC2".
+        static constexpr uint32_t FLAG_TOMBSTONE = 1;          ///< The record removes the entry for its key.
+        static constexpr std::size_t ALIGNMENT   = 8;          ///< Alignment of records in a segment.
+        static constexpr std::size_t DIGEST_SIZE = 32;         ///< Size of the key digest.
+        static constexpr const char* LOCK_FILE_NAME = "lock";  ///< File locked by the store that owns the directory.
+
+        mutable std::mutex                                   m_mutex;         ///< Mutex protecting the state below.
+        std::string                                          m_directory;     ///< Directory holding the segment files.
+        utils::FileLock                                      m_lock;          ///< Lock of the directory.
+        std::size_t                                          m_segment_bytes; ///< Size of each segment file.
+        std::size_t                                          m_max_segments;  ///< Number of segments kept.
+        std::map<uint64_t, std::unique_ptr<Segment>>         m_segments;      ///< Segments by ID, oldest first.
+        std::unordered_map<std::string, Location>            m_index;         ///< Latest record of each key digest.
+        Location                                             m_last_location; ///< Location of the last appended record.
+
+        /// \brief Returns the path of a file in the directory.
+        std::string get_file_path(const std::string& name) const {
+            if (!m_directory.empty() && (m_directory.back() == '/' || m_directory.back() == '\\')) return m_directory + name;
+            return m_directory + "/" + name;
+        }
+
+        /// \brief Returns the path of a segment file.
+        std::string get_segment_path(uint64_t segment_id) const {
+            return get_file_path("segment-" + std::to_string(segment_id) + ".bin");
+        }
+
+        /// \brief Rounds a size up to the record alignment.
+        static std::size_t align(std::size_t size) {
+            return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        }
+
+        /// \brief Computes the FNV-1a hash of the bytes after the magic and checksum fields.
+        static uint32_t compute_checksum(const char* record, std::size_t size) {
+            uint32_t hash = 2166136261u;
+            for (std::size_t i = 2 * sizeof(uint32_t); i < size; ++i) {
+                hash ^= static_cast<unsigned char>(record[i]);
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+
+        /// \brief Computes the digest that keys the records of a request fingerprint.
+        /// \return DIGEST_SIZE bytes of the SHA-256 digest of the key.
+        static std::string make_digest(const std::string& key) {
+            return utils::sha256(key);
+        }
+
+        /// \brief Serializes headers as length-prefixed names and values.
+        static std::string serialize_headers(const Headers& headers) {
+            std::string data;
+            for (const auto& header : headers) {
+                append_string(data, header.first);
+                append_string(data, header.second);
+            }
+            return data;
+        }
+
+        /// \brief Appends a length-prefixed string.
+        static void append_string(std::string& data, const std::string& value) {
+            const uint32_t size = static_cast<uint32_t>(value.size());
+            data.append(reinterpret_cast<const char*>(&size), sizeof(size));
+            data.append(value);
+        }
+
+        /// \brief Parses serialized headers.
+        /// \return False if the data is malformed.
+        static bool parse_headers(const char* data, std::size_t size, Headers& headers) {
+            std::size_t pos = 0;
+            std::string values[2];
+            while (pos < size) {
+                for (auto& value : values) {
+                    uint32_t length = 0;
+                    if (size - pos < sizeof(length)) return false;
+                    std::memcpy(&length, data + pos, sizeof(length));
+                    pos += sizeof(length);
+                    if (size - pos < length) return false;
+                    value.assign(data + pos, length);
+                    pos += length;
+                }
+                headers.emplace(values[0], values[1]);
+            }
+            return true;
+        }
+
+        /// \brief Decodes the record at the given address.
+        static std::shared_ptr<Entry> read_entry(const char* record) {
+            RecordHeader header;
+            std::memcpy(&header, record, sizeof(header));
+            const char* key = record + sizeof(header);
+            const char* headers = key + header.key_size;
+            const char* content = headers + header.headers_size;
+
+            auto entry = std::make_shared<Entry>();
+            entry->status_code = static_cast<long>(header.status_code);
+            if (!parse_headers(headers, header.headers_size, entry->headers)) return nullptr;
+            entry->content.assign(content, static_cast<std::size_t>(header.content_size));
+            auto find_header = [&entry](const char* name) {
+                auto it = entry->headers.find(name);
+                return it == entry->headers.end() ? std::string() : it->second;
+            };
+            entry->etag = find_header("ETag");
+            entry->last_modified = find_header("Last-Modified");
+            entry->expires_at = std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::milliseconds(header.expires_at_ms)));
+            return entry;
+        }
+
+        /// \brief Validates the record at an offset of a segment.
+        /// \return Size of the record including padding, or 0 if there is no valid record.
+        std::size_t check_record(const Segment& segment, std::size_t offset, RecordHeader& header) const {
+            const std::size_t capacity = segment.file.size();
+            if (capacity - offset < sizeof(header)) return 0;
+            const char* record = segment.file.data() + offset;
+            std::memcpy(&header, record, sizeof(header));
+            if (header.magic != RECORD_MAGIC) return 0;
+            const uint64_t size = sizeof(header) + static_cast<uint64_t>(header.key_size) + header.headers_size + header.content_size;
+            if (size > capacity - offset) return 0;
+            if (compute_checksum(record, static_cast<std::size_t>(size)) != header.checksum) return 0;
+            return align(static_cast<std::size_t>(size));
+        }
+
+        /// \brief Maps the existing segment files and rebuilds the index.
+        void load() {
+            std::vector<uint64_t> segment_ids;
+            for (const std::string& name : utils::list_directory(m_directory)) {
+                const std::string prefix = "segment-";
+                const std::string suffix = ".bin";
+                if (name.size() <= prefix.size() + suffix.size() ||
+                    name.compare(0, prefix.size(), prefix) != 0 ||
+                    name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) continue;
+                const std::string digits = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+                if (digits.find_first_not_of("0123456789") != std::string::npos) continue;
+                segment_ids.push_back(std::stoull(digits));
+            }
+            std::sort(segment_ids.begin(), segment_ids.end());
+
+            for (uint64_t segment_id : segment_ids) {
+                auto segment = open_segment(segment_id);
+                if (!segment) continue;
+                std::size_t offset = 0;
+                RecordHeader header;
+                while (std::size_t size = check_record(*segment, offset, header)) {
+                    const std::string key(segment->file.data() + offset + sizeof(header), header.key_size);
+                    if (header.flags & FLAG_TOMBSTONE) {
+                        m_index.erase(key);
+                    } else {
+                        m_index[key] = Location{segment_id, offset};
+                    }
+                    offset += size;
+                }
+                segment->used = offset;
+                m_segments.emplace(segment_id, std::move(segment));
+            }
+            while (m_segments.size() > m_max_segments) drop_oldest_segment();
+            if (m_segments.empty()) add_segment();
+        }
+
+        /// \brief Maps a segment file.
+        std::unique_ptr<Segment> open_segment(uint64_t segment_id) const {
+#           if __cplusplus >= 201402L
+            auto segment = std::make_unique<Segment>();
+#           else
+            auto segment = std::unique_ptr<Segment>(new Segment());
+#           endif
+            segment->path = get_segment_path(segment_id);
+            if (!segment->file.open(segment->path, m_segment_bytes)) return nullptr;
+            return segment;
+        }
+
+        /// \brief Starts a new segment, deleting the oldest ones beyond the limit. Must be called with m_mutex held.
+        /// \return True if the segment was created.
+        bool add_segment() {
+            const uint64_t segment_id = m_segments.empty() ? 1 : m_segments.rbegin()->first + 1;
+            auto segment = open_segment(segment_id);
+            if (!segment) return false;
+            // The file may be left over from an earlier run; start it empty.
+            std::memset(segment->file.data(), 0, sizeof(RecordHeader));
+            m_segments.emplace(segment_id, std::move(segment));
+            while (m_segments.size() > m_max_segments) drop_oldest_segment();
+            return true;
+        }
+
+        /// \brief Deletes the oldest segment and its index entries. Must be called with m_mutex held.
+        void drop_oldest_segment() {
+            auto it = m_segments.begin();
+            const uint64_t segment_id = it->first;
+            const std::string path = it->second->path;
+            m_segments.erase(it);
+            utils::remove_file(path);
+            for (auto index_it = m_index.begin(); index_it != m_index.end();) {
+                if (index_it->second.segment_id == segment_id) index_it = m_index.erase(index_it);
+                else ++index_it;
+            }
+        }
+
+        /// \brief Appends a record to the newest segment. Must be called with m_mutex held.
+        /// \param key Key digest.
+        /// \return True if the record was written; its location is stored in m_last_location. Always false
+        /// if the store does not hold the lock of the directory.
+        bool append(
+                const std::string& key,
+                const std::string& headers,
+                const std::string& content,
+                long status_code,
+                int64_t expires_at_ms,
+                uint32_t flags) {
+            if (!m_lock.is_locked()) return false;
+            const std::size_t record_size = sizeof(RecordHeader) + key.size() + headers.size() + content.size();
+            if (align(record_size) > m_segment_bytes) return false;
+            if (m_segments.empty() ||
+                m_segments.rbegin()->second->used + align(record_size) > m_segment_bytes) {
+                if (!m_segments.empty()) m_segments.rbegin()->second->file.flush_async();
+                if (!add_segment()) return false;
+            }
+            auto& last = *m_segments.rbegin();
+            Segment& segment = *last.second;
+            char* record = segment.file.data() + segment.used;
+
+            RecordHeader header{};
+            header.key_size      = static_cast<uint32_t>(key.size());
+            header.headers_size  = static_cast<uint32_t>(headers.size());
+            header.content_size  = content.size();
+            header.status_code   = status_code;
+            header.expires_at_ms = expires_at_ms;
+            header.flags         = flags;
+            std::memcpy(record, &header, sizeof(header));
+            char* data = record + sizeof(header);
+            std::memcpy(data, key.data(), key.size());
+            data += key.size();
+            std::memcpy(data, headers.data(), headers.size());
+            data += headers.size();
+            std::memcpy(data, content.data(), content.size());
+            // The magic is written last, so an interrupted write leaves no valid record behind.
+            header.checksum = compute_checksum(record, record_size);
+            header.magic = RECORD_MAGIC;
+            std::memcpy(record + sizeof(uint32_t), &header.checksum, sizeof(header.checksum));
+            std::memcpy(record, &header.magic, sizeof(header.magic));
+
+            m_last_location = Location{last.first, segment.used};
+            segment.used += align(record_size);
+            if (segment.used + sizeof(RecordHeader) <= m_segment_bytes) {
+                // Terminate the scan of the segment at the next record.
+                std::memset(segment.file.data() + segment.used, 0, sizeof(RecordHeader));
+            }
+            return true;
+        }
+    }; // HttpDiskCache
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_DISK_CACHE_HPP_INCLUDED
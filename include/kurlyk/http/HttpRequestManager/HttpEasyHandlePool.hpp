@@ -0,0 +1,79 @@
+#pragma once
+#ifndef _KURLYK_HTTP_EASY_HANDLE_POOL_HPP_INCLUDED
+#define _KURLYK_HTTP_EASY_HANDLE_POOL_HPP_INCLUDED
+
+/// \file HttpEasyHandlePool.hpp
+/// \brief Defines a pool of reusable CURL easy handles grouped by request origin.
+
+namespace kurlyk {
+
+    /// \class HttpEasyHandlePool
+    /// \brief Recycles CURL easy handles between requests instead of creating one per request.
+    ///
+    /// Released handles are reset with `curl_easy_reset`, which clears all options but keeps
+    /// the handle's TLS session ID cache, DNS cache and cookies. Idle handles are grouped by
+    /// origin so that a request prefers a handle that already talked to the same host.
+    /// The pool is not thread-safe; it is used only from the NetworkWorker thread.
+    class HttpEasyHandlePool {
+    public:
+
+        /// \brief Constructs a pool.
+        /// \param max_idle_handles Maximum total number of idle handles kept for reuse.
+        explicit HttpEasyHandlePool(std::size_t max_idle_handles = KURLYK_HTTP_MAX_POOLED_HANDLES)
+            : m_max_idle_handles(max_idle_handles) {}
+
+        /// \brief Cleans up all idle handles.
+        ~HttpEasyHandlePool() {
+            clear();
+        }
+
+        /// \brief Returns an easy handle for the given origin.
+        /// \param origin Request origin (scheme, host and port).
+        /// \return An idle handle used previously for the same origin, any other idle handle, or a new one.
+        CURL* acquire(const std::string& origin) {
+            auto it = m_idle_handles.find(origin);
+            if (it == m_idle_handles.end()) it = m_idle_handles.begin();
+            if (it == m_idle_handles.end()) return curl_easy_init();
+
+            CURL* curl = it->second.back();
+            it->second.pop_back();
+            if (it->second.empty()) m_idle_handles.erase(it);
+            --m_idle_count;
+            return curl;
+        }
+
+        /// \brief Returns a handle to the pool, or cleans it up if the pool is full.
+        /// \param origin Origin of the request the handle was used for.
+        /// \param curl Easy handle that is no longer attached to a multi handle.
+        void release(const std::string& origin, CURL* curl) {
+            if (!curl) return;
+            if (m_idle_count >= m_max_idle_handles) {
+                curl_easy_cleanup(curl);
+                return;
+            }
+            curl_easy_reset(curl);
+            m_idle_handles[origin].push_back(curl);
+            ++m_idle_count;
+        }
+
+        /// \brief Cleans up all idle handles.
+        void clear() {
+            for (auto& item : m_idle_handles) {
+                for (CURL* curl : item.second) {
+                    curl_easy_cleanup(curl);
+                }
+            }
+            m_idle_handles.clear();
+            m_idle_count = 0;
+        }
+
+    private:
+        std::unordered_map<std::string, std::vector<CURL*>> m_idle_handles;     ///< Idle handles grouped by origin.
+        std::size_t                                         m_idle_count = 0;   ///< Total number of idle handles.
+        std::size_t                                         m_max_idle_handles; ///< Maximum total number of idle handles.
+
+    }; // HttpEasyHandlePool
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_EASY_HANDLE_POOL_HPP_INCLUDED
@@ -0,0 +1,132 @@
+#pragma once
+#ifndef _KURLYK_HTTP_HEDGE_GROUP_HPP_INCLUDED
+#define _KURLYK_HTTP_HEDGE_GROUP_HPP_INCLUDED
+
+/// \file HttpHedgeGroup.hpp
+/// \brief Defines HttpHedgeGroup, which merges the responses of the copies of a hedged request.
+
+namespace kurlyk {
+
+    /// \class HttpHedgeGroup
+    /// \brief Shared state of the primary and hedged copies of one request.
+    ///
+    /// The first successful final response of either copy completes the group and is passed to the
+    /// callback; an error completes it only when no other copy is still in flight. Responses arriving
+    /// after completion are dropped. Intermediate responses of retried attempts are forwarded for the
+    /// primary copy only. The copies may complete on different threads.
+    class HttpHedgeGroup : public std::enable_shared_from_this<HttpHedgeGroup> {
+    public:
+        using time_point_t = std::chrono::steady_clock::time_point;
+
+        /// \brief Handler called once when the group completes, before the callback.
+        /// \param group The completed group.
+        /// \param response The selected response.
+        /// \param is_hedge_winner True if the response comes from the hedged copy.
+        /// \param cancel_id Request ID of the copy still in flight, or 0 if there is none.
+        using finish_handler_t = std::function<void(const HttpHedgeGroup& group, const HttpResponse& response, bool is_hedge_winner, uint64_t cancel_id)>;
+
+        /// \brief Constructs a group for a request.
+        /// \param callback Callback receiving the selected response.
+        /// \param host Host key of the request.
+        /// \param primary_id Request ID of the primary copy.
+        /// \param hedge_id Request ID reserved for the hedged copy.
+        /// \param on_finish Handler called when the group completes.
+        HttpHedgeGroup(
+                HttpResponseCallback callback,
+                std::string host,
+                uint64_t primary_id,
+                uint64_t hedge_id,
+                finish_handler_t on_finish)
+            : m_callback(std::move(callback)),
+              m_host(std::move(host)),
+              m_primary_id(primary_id),
+              m_hedge_id(hedge_id),
+              m_on_finish(std::move(on_finish)) {
+        }
+
+        /// \brief Creates the response callback of one copy.
+        /// \param is_hedge True for the hedged copy, false for the primary one.
+        /// \return Callback passing the responses of the copy to the group.
+        HttpResponseCallback make_callback(bool is_hedge) {
+            auto self = shared_from_this();
+            return [self, is_hedge](HttpResponsePtr response) {
+                self->on_response(is_hedge, std::move(response));
+            };
+        }
+
+        /// \brief Checks whether a response was already passed to the callback.
+        /// \return True if the group has completed.
+        bool is_done() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_is_done;
+        }
+
+        /// \brief Registers the hedged copy unless the group has already completed.
+        /// \return True if the hedged copy should be sent.
+        bool try_start_hedge() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_is_done || m_is_hedged) return false;
+            m_is_hedged = true;
+            ++m_in_flight;
+            return true;
+        }
+
+        /// \brief Records the time the primary copy passed its rate limits.
+        /// \param time Dispatch time of the primary copy.
+        void set_dispatch_time(time_point_t time) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_dispatch_time = time;
+        }
+
+        /// \brief Returns the time the primary copy passed its rate limits.
+        /// \return Dispatch time, or a default-constructed time point if the primary copy was never sent.
+        time_point_t get_dispatch_time() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_dispatch_time;
+        }
+
+        /// \brief Returns the host key of the request.
+        const std::string& get_host() const { return m_host; }
+
+        /// \brief Returns the request ID of the primary copy.
+        uint64_t get_primary_id() const { return m_primary_id; }
+
+        /// \brief Returns the request ID of the hedged copy.
+        uint64_t get_hedge_id() const { return m_hedge_id; }
+
+    private:
+        mutable std::mutex   m_mutex;             ///< Mutex protecting the state below.
+        HttpResponseCallback m_callback;          ///< Callback receiving the selected response.
+        std::string          m_host;              ///< Host key of the request.
+        uint64_t             m_primary_id = 0;    ///< Request ID of the primary copy.
+        uint64_t             m_hedge_id   = 0;    ///< Request ID of the hedged copy.
+        finish_handler_t     m_on_finish;         ///< Handler called when the group completes.
+        int                  m_in_flight  = 1;    ///< Copies without a final response.
+        bool                 m_is_hedged  = false; ///< Whether the hedged copy was sent.
+        bool                 m_is_done    = false; ///< Whether a response was passed to the callback.
+        time_point_t         m_dispatch_time;     ///< Time the primary copy passed its rate limits.
+
+        /// \brief Handles a response of one copy.
+        void on_response(bool is_hedge, HttpResponsePtr response) {
+            if (!response) return;
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_is_done) return;
+            if (!response->ready) {
+                lock.unlock();
+                if (!is_hedge) m_callback(std::move(response));
+                return;
+            }
+            --m_in_flight;
+            if (response->error_code && m_in_flight > 0) return;
+            m_is_done = true;
+            const uint64_t cancel_id = m_in_flight > 0 ? (is_hedge ? m_primary_id : m_hedge_id) : 0;
+            lock.unlock();
+
+            if (m_on_finish) m_on_finish(*this, *response, is_hedge, cancel_id);
+            m_callback(std::move(response));
+        }
+    }; // HttpHedgeGroup
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_HEDGE_GROUP_HPP_INCLUDED
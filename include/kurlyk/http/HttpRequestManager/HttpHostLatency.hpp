@@ -0,0 +1,71 @@
+#pragma once
+#ifndef _KURLYK_HTTP_HOST_LATENCY_HPP_INCLUDED
+#define _KURLYK_HTTP_HOST_LATENCY_HPP_INCLUDED
+
+/// \file HttpHostLatency.hpp
+/// \brief Defines HttpHostLatency, which keeps recent response latencies per host.
+
+namespace kurlyk {
+
+    /// \class HttpHostLatency
+    /// \brief Thread-safe window of the most recent response latencies of each host.
+    class HttpHostLatency {
+    public:
+
+        /// \brief Number of latencies kept per host.
+        static constexpr std::size_t WINDOW_SIZE = 128;
+
+        /// \brief Records the latency of a response.
+        /// \param host Host key, e.g. the URL origin.
+        /// \param seconds Time from the dispatch of the request to its response, in seconds.
+        void record(const std::string& host, double seconds) {
+            if (seconds < 0.0) return;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Window& window = m_windows[host];
+            if (window.samples.size() < WINDOW_SIZE) {
+                window.samples.push_back(seconds);
+            } else {
+                window.samples[window.next] = seconds;
+            }
+            window.next = (window.next + 1) % WINDOW_SIZE;
+        }
+
+        /// \brief Computes a latency percentile of a host.
+        /// \param host Host key, e.g. the URL origin.
+        /// \param percentile Percentile in the range [0, 1].
+        /// \param min_samples Latencies required for a result.
+        /// \param latency_ms Receives the percentile in milliseconds.
+        /// \return True if enough latencies were recorded for the host.
+        bool get_percentile_ms(const std::string& host, double percentile, std::size_t min_samples, long& latency_ms) const {
+            std::vector<double> samples;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_windows.find(host);
+                if (it == m_windows.end()) return false;
+                samples = it->second.samples;
+            }
+            if (samples.empty() || samples.size() < min_samples) return false;
+            percentile = std::min(std::max(percentile, 0.0), 1.0);
+            const std::size_t index = std::min(
+                static_cast<std::size_t>(percentile * static_cast<double>(samples.size())), samples.size() - 1);
+            std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+            latency_ms = static_cast<long>(std::ceil(samples[index] * 1000.0));
+            return true;
+        }
+
+    private:
+
+        /// \struct Window
+        /// \brief Ring buffer of the latencies of one host.
+        struct Window {
+            std::vector<double> samples;  ///< Latencies in seconds.
+            std::size_t         next = 0; ///< Index overwritten by the next sample once the window is full.
+        };
+
+        mutable std::mutex                      m_mutex;   ///< Mutex protecting m_windows.
+        std::unordered_map<std::string, Window> m_windows; ///< Latency windows by host.
+    }; // HttpHostLatency
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_HOST_LATENCY_HPP_INCLUDED
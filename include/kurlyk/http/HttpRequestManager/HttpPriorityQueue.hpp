@@ -0,0 +1,148 @@
+#pragma once
+#ifndef _KURLYK_HTTP_PRIORITY_QUEUE_HPP_INCLUDED
+#define _KURLYK_HTTP_PRIORITY_QUEUE_HPP_INCLUDED
+
+/// \file HttpPriorityQueue.hpp
+/// \brief Defines HttpPriorityQueue, a queue of pending HTTP requests ordered by priority class.
+
+namespace kurlyk {
+
+    /// \class HttpPriorityQueue
+    /// \brief Holds pending requests in one FIFO per RequestPriority class.
+    ///
+    /// The next request is the head of the bucket with the highest effective priority: the class of
+    /// the request plus one level per KURLYK_HTTP_PRIORITY_AGING_MS spent waiting, capped at RP_HIGH.
+    /// Ties go to the request that has waited longer. Selecting the next request only inspects the
+    /// bucket heads, so it costs O(number of classes). Any queued request can be removed in constant
+    /// time with erase(), e.g. when it is cancelled.
+    class HttpPriorityQueue {
+    public:
+        using context_ptr_t = std::unique_ptr<HttpRequestContext>;
+        using time_point_t  = std::chrono::steady_clock::time_point;
+
+        static constexpr std::size_t PRIORITY_COUNT = static_cast<std::size_t>(RequestPriority::RP_CRITICAL) + 1;
+
+        /// \brief Adds a request to the bucket of its priority class.
+        /// \param context Context of the request; its start_time must be set.
+        void push(context_ptr_t context) {
+            const std::size_t index = priority_of(*context);
+            const HttpRequestContext* key = context.get();
+            m_buckets[index].push_back(std::move(context));
+            m_positions[key] = Position{index, std::prev(m_buckets[index].end())};
+            ++m_size;
+        }
+
+        /// \brief Returns the request that should be sent next.
+        /// \param now Current time, used for aging.
+        /// \return Reference to the selected request; the queue must not be empty.
+        context_ptr_t& top(time_point_t now) {
+            std::size_t best = PRIORITY_COUNT;
+            for (std::size_t i = 0; i < PRIORITY_COUNT; ++i) {
+                if (m_buckets[i].empty()) continue;
+                if (best == PRIORITY_COUNT ||
+                    is_before(*m_buckets[i].front(), *m_buckets[best].front(), now)) {
+                    best = i;
+                }
+            }
+            m_top = best;
+            m_top_context = m_buckets[best].front().get();
+            return m_buckets[best].front();
+        }
+
+        /// \brief Removes the request returned by the last call to top().
+        void pop() {
+            m_positions.erase(m_top_context);
+            m_buckets[m_top].pop_front();
+            --m_size;
+        }
+
+        /// \brief Removes a queued request.
+        /// \param context Request to remove.
+        /// \return The removed request, or nullptr if it is not in the queue.
+        context_ptr_t erase(const HttpRequestContext* context) {
+            auto it = m_positions.find(context);
+            if (it == m_positions.end()) return nullptr;
+            context_ptr_t result = std::move(*it->second.it);
+            m_buckets[it->second.bucket].erase(it->second.it);
+            m_positions.erase(it);
+            --m_size;
+            return result;
+        }
+
+        /// \brief Checks whether the queue is empty.
+        /// \return True if no requests are queued.
+        bool empty() const {
+            return m_size == 0;
+        }
+
+        /// \brief Returns the number of queued requests.
+        /// \return Number of requests in all buckets.
+        std::size_t size() const {
+            return m_size;
+        }
+
+        /// \brief Moves all requests to a list, highest class first.
+        /// \param out List receiving the requests.
+        void splice_to(std::list<context_ptr_t>& out) {
+            for (std::size_t i = PRIORITY_COUNT; i-- > 0;) {
+                out.splice(out.end(), m_buckets[i]);
+            }
+            m_positions.clear();
+            m_size = 0;
+        }
+
+        /// \brief Checks whether one request should be sent before another.
+        /// \param a First request.
+        /// \param b Second request.
+        /// \param now Current time, used for aging.
+        /// \return True if `a` has a higher effective priority, or the same one and has waited longer.
+        static bool is_before(const HttpRequestContext& a, const HttpRequestContext& b, time_point_t now) {
+            const std::size_t level_a = effective_priority(a, now);
+            const std::size_t level_b = effective_priority(b, now);
+            if (level_a != level_b) return level_a > level_b;
+            return a.start_time < b.start_time;
+        }
+
+    private:
+        using list_t = std::list<context_ptr_t>;
+
+        /// \struct Position
+        /// \brief Location of a queued request.
+        struct Position {
+            std::size_t      bucket = 0; ///< Bucket holding the request.
+            list_t::iterator it;         ///< Element of the bucket holding the request.
+
+            Position() = default;
+
+            Position(std::size_t index, list_t::iterator element)
+                : bucket(index), it(element) {
+            }
+        };
+
+        std::array<list_t, PRIORITY_COUNT> m_buckets; ///< FIFO of requests per priority class.
+        std::unordered_map<const HttpRequestContext*, Position> m_positions; ///< Locations of the queued requests.
+        std::size_t m_size = 0;                       ///< Number of queued requests.
+        std::size_t m_top  = 0;                       ///< Bucket selected by the last call to top().
+        const HttpRequestContext* m_top_context = nullptr; ///< Request returned by the last call to top().
+
+        /// \brief Returns the bucket index of a request.
+        static std::size_t priority_of(const HttpRequestContext& context) {
+            if (!context.request) return static_cast<std::size_t>(RequestPriority::RP_NORMAL);
+            const std::size_t index = static_cast<std::size_t>(context.request->priority);
+            return std::min(index, PRIORITY_COUNT - 1);
+        }
+
+        /// \brief Returns the priority of a request including promotion for waiting time.
+        static std::size_t effective_priority(const HttpRequestContext& context, time_point_t now) {
+            const std::size_t priority = priority_of(context);
+            const std::size_t max_aged = static_cast<std::size_t>(RequestPriority::RP_HIGH);
+            if (KURLYK_HTTP_PRIORITY_AGING_MS <= 0 || priority >= max_aged || now <= context.start_time) return priority;
+            const auto waited_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - context.start_time).count();
+            const std::size_t promotion = static_cast<std::size_t>(waited_ms / KURLYK_HTTP_PRIORITY_AGING_MS);
+            return std::min(priority + promotion, max_aged);
+        }
+    }; // HttpPriorityQueue
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_PRIORITY_QUEUE_HPP_INCLUDED
@@ -11,25 +11,28 @@ namespace kurlyk {
     /// \brief Manages rate limits for HTTP requests, ensuring compliance with set limits.
     ///
     /// Each rate limit is assigned a unique identifier, allowing specific limits to be applied
-    /// to different request streams. This class controls the rate of requests by monitoring the
-    /// number of requests within a specified time window.
+    /// to different request streams. Every limit uses either a fixed window or the generic cell
+    /// rate algorithm (see utils::RateLimitState) and reports the exact time at which it allows
+    /// the next request, so the scheduler can sleep until then.
     class HttpRateLimiter {
     public:
+        using time_point_t = utils::RateLimitState::time_point_t;
 
         /// \brief Creates a new rate limit with specified parameters.
         /// This method initializes a new rate limit and returns its unique identifier.
         /// \param requests_per_period Maximum number of requests allowed within the time period. A value of 0 means no limit is applied.
         /// \param period_ms Duration of the time period in milliseconds.
+        /// \param algorithm Algorithm enforcing the limit.
+        /// \param burst Requests allowed back to back by RateLimitAlgorithm::RL_GCRA.
         /// \return Unique identifier for the created rate limit.
-        long create_limit(long requests_per_period, long period_ms) {
+        long create_limit(
+                long requests_per_period,
+                long period_ms,
+                RateLimitAlgorithm algorithm = RateLimitAlgorithm::RL_FIXED_WINDOW,
+                long burst = 1) {
             std::lock_guard<std::mutex> lock(m_mutex);
             long id = m_next_id++;
-            m_limits[id] = LimitData{
-                requests_per_period,
-                period_ms,
-                0,
-                std::chrono::steady_clock::now()
-            };
+            m_limits[id] = utils::RateLimitState(requests_per_period, period_ms, algorithm, burst);
             return id;
         }
 
@@ -39,52 +42,130 @@ namespace kurlyk {
         /// \return True if the rate limit was removed successfully, false if the ID was not found.
         bool remove_limit(long limit_id) {
             std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_feedback.erase(limit_id)) m_has_feedback = !m_feedback.empty();
             return m_limits.erase(limit_id) > 0;
         }
 
+        /// \brief Makes a rate limit follow the quota reported in server response headers.
+        /// \param limit_id The unique identifier of the rate limit.
+        /// \param feedback Mapping of response headers onto the limit.
+        /// \return True if the feedback was set, false if the ID was not found.
+        bool set_feedback(long limit_id, RateLimitFeedback feedback) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_limits.count(limit_id)) return false;
+            m_feedback[limit_id] = std::move(feedback);
+            m_has_feedback = true;
+            return true;
+        }
+
+        /// \brief Stops a rate limit from following server response headers.
+        /// \param limit_id The unique identifier of the rate limit.
+        /// \return True if the feedback was removed, false if none was set.
+        bool remove_feedback(long limit_id) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_feedback.erase(limit_id)) return false;
+            m_has_feedback = !m_feedback.empty();
+            return true;
+        }
+
+        /// \brief Checks whether any rate limit follows server response headers.
+        /// \return True if at least one limit has feedback set.
+        bool has_feedback() const {
+            return m_has_feedback.load(std::memory_order_relaxed);
+        }
+
+        /// \brief Updates the rate limits of a request from the headers and status of its response.
+        ///
+        /// Only limits with feedback set (see set_feedback()) are affected.
+        /// \param rate_limit_ids IDs of the rate limits applied to the request.
+        /// \param response Response received for the request.
+        void apply_feedback(const std::vector<long>& rate_limit_ids, const HttpResponse& response) {
+            if (!has_feedback() || response.headers.empty()) return;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto now = std::chrono::steady_clock::now();
+            for (long id : rate_limit_ids) {
+                auto feedback_it = m_feedback.find(id);
+                if (feedback_it == m_feedback.end()) continue;
+                auto limit_it = m_limits.find(id);
+                if (limit_it == m_limits.end()) continue;
+                const RateLimitFeedback& feedback = feedback_it->second;
+                utils::RateLimitState& limit = limit_it->second;
+
+                long remaining = 0;
+                if (feedback.parse_remaining(response.headers, limit.requests_per_period, remaining)) {
+                    time_point_t reset_time;
+                    feedback.parse_reset_time(response.headers, now, reset_time);
+                    limit.set_remaining(remaining, reset_time, now);
+                }
+                if (feedback.pause_statuses.count(response.status_code)) {
+                    time_point_t retry_time = now + std::chrono::milliseconds(limit.period_ms);
+                    RateLimitFeedback::parse_retry_after(response.headers, now, retry_time);
+                    limit.pause_until(retry_time);
+                }
+            }
+        }
+
         /// \brief Checks if a request is allowed under the specified general and specific rate limits.
         /// This method checks both the general and specific rate limits without updating their counters
         /// unless the request is allowed under both limits. If the request is allowed, it updates the
         /// counters accordingly.
         /// \param general_rate_limit_id Unique identifier for the general rate limit.
         /// \param specific_rate_limit_id Unique identifier for the specific rate limit.
+        /// \param weight Units of each limit's budget the request consumes.
         /// \return True if the request is allowed under both limits, false otherwise.
-        bool allow_request(long general_rate_limit_id, long specific_rate_limit_id) {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            auto general_it = m_limits.find(general_rate_limit_id);
-            auto specific_it = m_limits.find(specific_rate_limit_id);
-            if (general_it == m_limits.end() &&
-                specific_it == m_limits.end()) return true;
-
-            auto now = std::chrono::steady_clock::now();
-            bool general_limit_allowed = true;
-            bool specific_limit_allowed = true;
+        bool allow_request(long general_rate_limit_id, long specific_rate_limit_id, long weight = 1) {
+            return allow_request(std::vector<long>{general_rate_limit_id, specific_rate_limit_id}, weight);
+        }
 
-            if (general_it != m_limits.end()) {
-                auto& limit_data = general_it->second;
-                general_limit_allowed = check_limit(limit_data, now);
+        /// \brief Checks if a request is allowed under all of the specified rate limits.
+        /// The limits are checked and updated atomically: either every limit records the request,
+        /// or none does. IDs of unknown limits are ignored and repeated IDs are counted once.
+        /// \param rate_limit_ids IDs of the rate limits applied to the request.
+        /// \param weight Units of each limit's budget the request consumes.
+        /// \return True if the request is allowed under all limits, false otherwise.
+        bool allow_request(const std::vector<long>& rate_limit_ids, long weight = 1) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto now = std::chrono::steady_clock::now();
+            for (long id : rate_limit_ids) {
+                auto it = m_limits.find(id);
+                if (it != m_limits.end() && !it->second.check(now, weight)) {
+                    // Request is not allowed under one or more limits
+                    return false;
+                }
             }
 
-            if (specific_it != m_limits.end()) {
-                auto& limit_data = specific_it->second;
-                specific_limit_allowed = check_limit(limit_data, now);
+            // All limits allow the request, now update them
+            for (auto id_it = rate_limit_ids.begin(); id_it != rate_limit_ids.end(); ++id_it) {
+                if (std::find(rate_limit_ids.begin(), id_it, *id_it) != id_it) continue;
+                auto it = m_limits.find(*id_it);
+                if (it != m_limits.end()) it->second.consume(now, weight);
             }
+            return true;
+        }
 
-            if (general_limit_allowed && specific_limit_allowed) {
-                // All limits allow the request, now update counts
-                if (general_it != m_limits.end()) {
-                    auto& limit_data = general_it->second;
-                    update_limit(limit_data, now);
-                }
-                if (specific_it != m_limits.end()) {
-                    auto& limit_data = specific_it->second;
-                    update_limit(limit_data, now);
-                }
-                return true;
-            }
+        /// \brief Returns the earliest time at which both rate limits allow a request.
+        /// \param general_rate_limit_id ID of the general rate limit.
+        /// \param specific_rate_limit_id ID of the specific rate limit.
+        /// \param weight Units of each limit's budget the request consumes.
+        /// \return The current time if the request is allowed now, otherwise the exact future instant.
+        time_point_t next_allowed_time(long general_rate_limit_id, long specific_rate_limit_id, long weight = 1) const {
+            return next_allowed_time(std::vector<long>{general_rate_limit_id, specific_rate_limit_id}, weight);
+        }
 
-            // Request is not allowed under one or more limits
-            return false;
+        /// \brief Returns the earliest time at which all of the specified rate limits allow a request.
+        /// \param rate_limit_ids IDs of the rate limits applied to the request.
+        /// \param weight Units of each limit's budget the request consumes.
+        /// \return The current time if the request is allowed now, otherwise the exact future instant.
+        time_point_t next_allowed_time(const std::vector<long>& rate_limit_ids, long weight = 1) const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto now = std::chrono::steady_clock::now();
+            time_point_t allowed_time = now;
+            for (long id : rate_limit_ids) {
+                auto it = m_limits.find(id);
+                if (it == m_limits.end()) continue;
+                allowed_time = std::max(allowed_time, it->second.next_allowed_time(now, weight));
+            }
+            return allowed_time;
         }
 
         /// \brief Calculates the delay until the next request is allowed under the specified rate limits.
@@ -95,24 +176,12 @@ namespace kurlyk {
         /// \tparam Duration Duration type (e.g., std::chrono::milliseconds, std::chrono::microseconds).
         /// \param general_rate_limit_id ID of the general rate limit.
         /// \param specific_rate_limit_id ID of the specific rate limit.
-        /// \return Duration to wait before the request is safe to perform. Zero if already allowed by both limits.
+        /// \param weight Units of each limit's budget the request consumes.
+        /// \return Duration to wait before the request is safe to perform, rounded up. Zero if already allowed by both limits.
         template<typename Duration = std::chrono::milliseconds>
-        Duration time_until_next_allowed(long general_rate_limit_id, long specific_rate_limit_id) {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            auto now = std::chrono::steady_clock::now();
-            Duration max_delay{0};
-
-            auto it = m_limits.find(general_rate_limit_id);
-            if (it != m_limits.end()) {
-                max_delay = std::max(max_delay, time_until_limit_allows<Duration>(it->second, now));
-            }
-
-            it = m_limits.find(specific_rate_limit_id);
-            if (it != m_limits.end()) {
-                max_delay = std::max(max_delay, time_until_limit_allows<Duration>(it->second, now));
-            }
-
-            return max_delay;
+        Duration time_until_next_allowed(long general_rate_limit_id, long specific_rate_limit_id, long weight = 1) const {
+            const auto delay = next_allowed_time(general_rate_limit_id, specific_rate_limit_id, weight) - std::chrono::steady_clock::now();
+            return ceil_duration<Duration>(delay);
         }
 
         /// \brief Finds the shortest delay among all active rate limits.
@@ -123,15 +192,14 @@ namespace kurlyk {
         /// \tparam Duration The chrono duration type (e.g., std::chrono::milliseconds, std::chrono::microseconds).
         /// \return The shortest wait duration among all limits. Zero if no wait is required.
         template<typename Duration = std::chrono::milliseconds>
-        Duration time_until_any_limit_allows() {
+        Duration time_until_any_limit_allows() const {
             std::lock_guard<std::mutex> lock(m_mutex);
             auto now = std::chrono::steady_clock::now();
 
             Duration min_delay = Duration::max();
 
             for (const auto& pair : m_limits) {
-                const auto& limit = pair.second;
-                Duration delay = time_until_limit_allows<Duration>(limit, now);
+                Duration delay = ceil_duration<Duration>(pair.second.time_until_allowed(now));
                 if (delay.count() > 0 && delay < min_delay) {
                     min_delay = delay;
                 }
@@ -141,75 +209,22 @@ namespace kurlyk {
         }
 
     private:
-        using time_point_t = std::chrono::steady_clock::time_point;
-
-        /// \struct LimitData
-        /// \brief Stores data for an individual rate limit.
-        struct LimitData {
-            long requests_per_period;   ///< Max requests allowed in the period.
-            long period_ms;             ///< Duration of the period in milliseconds.
-            long count;                 ///< Requests made in the current period.
-            time_point_t start_time;    ///< Start time of the current rate period.
-        };
-
-        std::mutex m_mutex;             ///< Mutex to protect shared data.
+        mutable std::mutex m_mutex;     ///< Mutex to protect shared data.
         long m_next_id = 1;             ///< Next available unique ID for rate limits.
-        std::unordered_map<long, LimitData> m_limits; ///< Map storing rate limit configurations.
-
-        /// \brief Checks if a request is allowed under the specified rate limit without updating the count.
-        /// \param limit_data Reference to the LimitData for the rate limit.
-        /// \param now The current time point.
-        /// \return True if the request is allowed, false otherwise.
-        bool check_limit(LimitData& limit_data, const time_point_t& now) {
-            auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(now - limit_data.start_time);
-
-            // If period has elapsed, the count will reset upon update
-            if (elapsed_time.count() >= limit_data.period_ms) {
-                return true; // Period elapsed, limit can be reset
-            }
-
-            // Check if under limit or if no limit is set (0 requests per period means unlimited)
-            if (limit_data.count < limit_data.requests_per_period ||
-                limit_data.requests_per_period == 0) {
-                return true;
-            }
-            return false;
-        }
-
-        /// \brief Updates the request count for the specified rate limit.
-        /// \param limit_data Reference to the LimitData for the rate limit.
-        /// \param now The current time point.
-        void update_limit(LimitData& limit_data, const time_point_t& now) {
-            auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(now - limit_data.start_time);
-
-            // Reset count if period has elapsed
-            if (elapsed_time.count() >= limit_data.period_ms) {
-                limit_data.start_time = now;
-                limit_data.count = 0;
-            }
-
-            ++limit_data.count;
-        }
-
-        /// \brief Calculates the delay required before a request is allowed under a single rate limit.
-        ///
-        /// If the request exceeds the allowed number within the configured period, returns the remaining time
-        /// until the rate limit resets. Otherwise returns zero. The time unit is determined by the template argument.
-        ///
-        /// \tparam Duration Duration type (e.g., std::chrono::milliseconds, std::chrono::microseconds).
-        /// \param limit_data Internal data for the rate limit being evaluated.
-        /// \param now Current timestamp to compare against the rate period start time.
-        /// \return Duration to wait until the rate limit allows a request. Zero if already allowed.
+        std::unordered_map<long, utils::RateLimitState> m_limits; ///< Map storing rate limit states.
+        std::unordered_map<long, RateLimitFeedback> m_feedback;   ///< Server header mappings of limits following server feedback.
+        std::atomic<bool> m_has_feedback = ATOMIC_VAR_INIT(false); ///< True if m_feedback is not empty.
+
+        /// \brief Converts a delay to the requested duration type, rounding up.
+        /// \tparam Duration Target duration type.
+        /// \param delay Delay to convert; negative values yield zero.
+        /// \return Converted delay, never shorter than the original one.
         template<typename Duration>
-        Duration time_until_limit_allows(const LimitData& limit_data, const time_point_t& now) const {
-            if (limit_data.requests_per_period == 0) return Duration{0};
-            auto elapsed = std::chrono::duration_cast<Duration>(now - limit_data.start_time);
-            auto period_duration = std::chrono::duration_cast<Duration>(std::chrono::milliseconds(limit_data.period_ms));
-            if (elapsed >= period_duration ||
-                limit_data.count < limit_data.requests_per_period) {
-                return Duration{0};
-            }
-            return period_duration - elapsed;
+        static Duration ceil_duration(utils::RateLimitState::duration_t delay) {
+            if (delay <= utils::RateLimitState::duration_t::zero()) return Duration{0};
+            Duration result = std::chrono::duration_cast<Duration>(delay);
+            if (result < delay) ++result;
+            return result;
         }
     }; // HttpRateLimiter
 
@@ -9,7 +9,9 @@ namespace kurlyk {
 
     /// \class HttpRequestContext
     /// \brief Represents the context of an HTTP request, including the request object, callback function, retry attempts, and timing.
-    class HttpRequestContext {
+    ///
+    /// Derives from utils::MpscQueueNode so that submitted requests can be queued without extra allocations.
+    class HttpRequestContext : public utils::MpscQueueNode {
     public:
         using time_point_t = std::chrono::steady_clock::time_point;
 
@@ -17,6 +19,13 @@ namespace kurlyk {
         HttpResponseCallback         callback;      ///< Callback function to be invoked when the request completes.
         long                         retry_attempt; ///< Number of retry attempts made for this request.
         time_point_t                 start_time;    ///< Time when the request was initially created or last retried.
+        long                         retry_delay_ms = 0; ///< Delay before the next attempt, set when an attempt fails.
+        bool                         is_hedge = false; ///< Whether this is the hedged copy of a request.
+        std::function<void()>        on_dispatch;   ///< Called once when the request first passes its rate limits, if set.
+#       if KURLYK_ENABLE_TRACING
+        uint64_t                     trace_id = 0;  ///< Identifier of this submission in kurlyk::tracing::Tracer.
+        time_point_t                 trace_time;    ///< Start of the current lifecycle stage.
+#       endif
 
         /// \brief Constructs a HttpRequestContext with the specified request and callback.
         /// \param request_ptr A unique pointer to the HTTP request object.
@@ -30,6 +39,16 @@ namespace kurlyk {
         }
         
         HttpRequestContext() = default;
+
+#       if KURLYK_ENABLE_TRACING
+        /// \brief Records the current lifecycle stage as ending now and starts the next one.
+        /// \param name Stage name as a string literal.
+        void trace_stage(const char* name) {
+            const auto now = std::chrono::steady_clock::now();
+            tracing::Tracer::get_instance().record(name, trace_id, trace_time, now);
+            trace_time = now;
+        }
+#       endif
     }; // HttpRequestContext
 
 } // namespace kurlyk
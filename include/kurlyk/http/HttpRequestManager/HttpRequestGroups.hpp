@@ -0,0 +1,141 @@
+#pragma once
+#ifndef _KURLYK_HTTP_REQUEST_GROUPS_HPP_INCLUDED
+#define _KURLYK_HTTP_REQUEST_GROUPS_HPP_INCLUDED
+
+/// \file HttpRequestGroups.hpp
+/// \brief Defines HttpRequestGroups, which maps request IDs and tags to the submissions in flight.
+
+namespace kurlyk {
+
+    /// \class HttpRequestGroups
+    /// \brief Thread-safe membership of in-flight submissions in cancellation groups.
+    ///
+    /// Every submission has an ID of its own and belongs to the group of the request ID it was sent with
+    /// (e.g. the ID shared by all requests of an HttpClient) and to one group per tag. Cancelling a group
+    /// cancels its members, found without scanning other requests. A tag gets an ID from the same sequence as
+    /// requests when a submission uses it while none is in flight, and loses it when its last submission
+    /// completes, so only the tags of requests in flight are kept.
+    class HttpRequestGroups {
+    public:
+
+        /// \brief Registers a submission.
+        /// \param submission_id ID of the submission.
+        /// \param order_key Key ordering the callbacks of the submission, i.e. its original request ID.
+        /// \param group_ids IDs of the groups the submission belongs to, besides the groups of its tags.
+        /// \param tags Tags of the submission.
+        /// \param generate_id Function returning a new ID for a tag that has none.
+        void add(
+                uint64_t submission_id,
+                uint64_t order_key,
+                std::vector<uint64_t> group_ids,
+                const std::vector<std::string>& tags,
+                const std::function<uint64_t()>& generate_id) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& tag : tags) {
+                auto tag_it = m_tag_ids.find(tag);
+                if (tag_it == m_tag_ids.end()) {
+                    tag_it = m_tag_ids.emplace(tag, generate_id()).first;
+                    m_tag_names.emplace(tag_it->second, tag);
+                }
+                group_ids.push_back(tag_it->second);
+            }
+            for (uint64_t group_id : group_ids) {
+                m_groups[group_id].insert(submission_id);
+            }
+            Member& member = m_members[submission_id];
+            member.order_key = order_key;
+            member.group_ids = std::move(group_ids);
+        }
+
+        /// \brief Unregisters a completed submission.
+        /// \param submission_id ID of the submission.
+        void remove(uint64_t submission_id) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_members.find(submission_id);
+            if (it == m_members.end()) return;
+            for (uint64_t group_id : it->second.group_ids) {
+                auto group_it = m_groups.find(group_id);
+                if (group_it == m_groups.end()) continue;
+                group_it->second.erase(submission_id);
+                if (!group_it->second.empty()) continue;
+                m_groups.erase(group_it);
+                auto name_it = m_tag_names.find(group_id);
+                if (name_it == m_tag_names.end()) continue;
+                m_tag_ids.erase(name_it->second);
+                m_tag_names.erase(name_it);
+            }
+            m_members.erase(it);
+        }
+
+        /// \brief Adds the members of the listed groups to a map of IDs to cancel.
+        /// \param requests Map keyed by request, submission or group ID; receives the member submissions.
+        template<class Map>
+        void expand(Map& requests) const {
+            std::vector<uint64_t> member_ids;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (const auto& request : requests) {
+                    auto it = m_groups.find(request.first);
+                    if (it == m_groups.end()) continue;
+                    member_ids.insert(member_ids.end(), it->second.begin(), it->second.end());
+                }
+            }
+            for (uint64_t id : member_ids) requests[id];
+        }
+
+        /// \brief Returns the callback ordering keys of the submissions an ID refers to.
+        /// \param id Request, submission or group ID.
+        /// \return Distinct ordering keys of the members; `id` itself if it is unknown.
+        std::vector<uint64_t> get_order_keys(uint64_t id) const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto member_it = m_members.find(id);
+            if (member_it != m_members.end()) return {member_it->second.order_key};
+            std::vector<uint64_t> keys;
+            auto group_it = m_groups.find(id);
+            if (group_it != m_groups.end()) {
+                for (uint64_t submission_id : group_it->second) {
+                    auto it = m_members.find(submission_id);
+                    if (it != m_members.end()) keys.push_back(it->second.order_key);
+                }
+                std::sort(keys.begin(), keys.end());
+                keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+            }
+            if (keys.empty()) keys.push_back(id);
+            return keys;
+        }
+
+        /// \brief Returns the group ID of a tag.
+        /// \param tag Tag name.
+        /// \return ID of the tag, or 0 if no request with it is in flight.
+        uint64_t find_tag(const std::string& tag) const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_tag_ids.find(tag);
+            return it == m_tag_ids.end() ? 0 : it->second;
+        }
+
+        /// \brief Returns the number of tags with requests in flight.
+        /// \return Number of tags holding an ID.
+        std::size_t get_tag_count() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_tag_ids.size();
+        }
+
+    private:
+
+        /// \struct Member
+        /// \brief Submission in flight.
+        struct Member {
+            uint64_t              order_key = 0; ///< Key ordering the callbacks of the submission.
+            std::vector<uint64_t> group_ids;     ///< Groups the submission belongs to.
+        };
+
+        mutable std::mutex                                          m_mutex;     ///< Mutex protecting the maps below.
+        std::unordered_map<uint64_t, Member>                        m_members;   ///< Submissions in flight by ID.
+        std::unordered_map<uint64_t, std::unordered_set<uint64_t>>  m_groups;    ///< Submission IDs by group ID.
+        std::unordered_map<std::string, uint64_t>                   m_tag_ids;   ///< Group IDs of tags in flight.
+        std::unordered_map<uint64_t, std::string>                   m_tag_names; ///< Tags by group ID.
+    }; // HttpRequestGroups
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_REQUEST_GROUPS_HPP_INCLUDED
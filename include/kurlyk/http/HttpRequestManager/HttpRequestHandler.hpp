@@ -14,8 +14,11 @@ namespace kurlyk {
 
         /// \brief Constructs an HttpRequestHandler with the specified request context.
         /// \param context Unique pointer to the HttpRequestContext object.
-        explicit HttpRequestHandler(std::unique_ptr<HttpRequestContext> context)
-            : m_request_context(std::move(context)) {
+        /// \param pool Optional pool to take the CURL handle from and return it to; must outlive the handler.
+        explicit HttpRequestHandler(
+                std::unique_ptr<HttpRequestContext> context,
+                HttpEasyHandlePool* pool = nullptr)
+            : m_request_context(std::move(context)), m_pool(pool) {
             std::fill(m_error_buffer, m_error_buffer + CURL_ERROR_SIZE, '\0');
 #           if __cplusplus >= 201402L
             m_response = std::make_unique<HttpResponse>();
@@ -28,10 +31,12 @@ namespace kurlyk {
         /// \brief Destructor for HttpRequestHandler, handling cleanup of CURL and headers.
         ///
         /// If the callback has not been called yet, this indicates the request was incomplete,
-        /// and an error response is passed to the callback.
+        /// and an error response is passed to the callback. The CURL handle is returned to the
+        /// pool if one was provided, so it must already be removed from its multi handle.
         ~HttpRequestHandler() {
             if (m_curl) {
-                curl_easy_cleanup(m_curl);
+                if (m_pool) m_pool->release(m_origin, m_curl);
+                else curl_easy_cleanup(m_curl);
                 curl_slist_free_all(m_headers);
             }
             if (!m_callback_called && m_response && m_request_context) {
@@ -91,24 +96,24 @@ namespace kurlyk {
                 m_response->error_code = {};
             }
 
-            const auto& valid_statuses = m_request_context->request->valid_statuses;
-            long retry_attempts = m_request_context->request->retry_attempts;
-            long& retry_attempt = m_request_context->retry_attempt;
-            ++retry_attempt;
-
-            m_response->retry_attempt = retry_attempt;
-            if (!retry_attempts ||
-                valid_statuses.count(m_response->status_code) ||
-                retry_attempt >= retry_attempts) {
+            ++m_request_context->retry_attempt;
+            m_response->retry_attempt = m_request_context->retry_attempt;
+            if (!should_retry(message->data.result)) {
                 fill_response_timings();
+#               if KURLYK_ENABLE_METRICS
+                auto& builtin = metrics::builtin();
+                builtin.http_responses.inc();
+                if (m_response->error_code) builtin.http_failures.inc();
+                builtin.http_request_duration.observe(m_response->total_time);
+#               endif
                 m_response->ready = true;
-                m_request_context->callback(std::move(m_response));
-                m_callback_called = true;
+                KURLYK_TRACE_STAGE(*m_request_context, "transfer");
+                invoke_callback();
                 return true;
             }
             m_request_context->start_time = std::chrono::steady_clock::now();
-            m_request_context->callback(std::move(m_response));
-            m_callback_called = true;
+            KURLYK_TRACE_STAGE(*m_request_context, "transfer");
+            invoke_callback();
             return false;
         }
 
@@ -127,6 +132,9 @@ namespace kurlyk {
         /// \brief Marks the request as cancelled.
         void cancel() {
             if (!m_callback_called) {
+#               if KURLYK_ENABLE_METRICS
+                metrics::builtin().http_cancellations.inc();
+#               endif
                 m_response->error_code = utils::make_error_code(utils::ClientError::CancelledByUser);
                 m_response->status_code = 499; // Client closed request
                 m_response->ready = true;
@@ -141,16 +149,66 @@ namespace kurlyk {
         std::unique_ptr<HttpRequestContext> m_request_context;  ///< Context for the current request.
         std::unique_ptr<HttpResponse>       m_response;         ///< Response object.
         CURL*                               m_curl = nullptr;   ///< CURL handle for the request.
+        HttpEasyHandlePool*                 m_pool = nullptr;   ///< Pool owning idle CURL handles, if any.
+        std::string                         m_origin;           ///< Request origin used as the pool key.
         struct curl_slist*                  m_headers = nullptr; ///< CURL headers list.
         char                                m_error_buffer[CURL_ERROR_SIZE]; ///< Buffer for CURL error messages.
         bool                                m_callback_called = false; ///< Indicates if the callback was called.
-        mutable std::string                 m_ca_file; ///< Cached CA file path.
+        std::string                         m_ca_file; ///< Default CA file path, used when the bundle is not cached.
+        HttpCaBundle::bundle_ptr_t          m_ca_bundle; ///< Cached CA bundle referenced by CURLOPT_CAINFO_BLOB.
+
+        /// \brief Decides whether the completed attempt is retried and sets the delay before the retry.
+        /// \param result libcurl result of the attempt.
+        /// \return True if the request should be retried.
+        bool should_retry(CURLcode result) {
+            const auto& request = m_request_context->request;
+            const long attempt = m_request_context->retry_attempt;
+            const auto& policy = request->retry_policy;
+            if (!policy) {
+                if (!request->retry_attempts ||
+                    request->valid_statuses.count(m_response->status_code) ||
+                    attempt >= request->retry_attempts) return false;
+                m_request_context->retry_delay_ms = request->retry_delay_ms;
+                return !is_retry_past_deadline();
+            }
+
+            auto& budget = HttpRetryBudget::get_instance();
+            const std::string host = m_origin.empty() ? utils::extract_origin(request->url) : m_origin;
+            if (attempt == 1) budget.deposit(host, policy->retry_budget_ratio, policy->retry_budget_min_per_second);
+            if (request->valid_statuses.count(m_response->status_code) ||
+                attempt >= policy->max_attempts ||
+                !policy->should_retry(*m_response, result)) return false;
+            m_request_context->retry_delay_ms = policy->get_retry_delay_ms(attempt, *m_response);
+            if (is_retry_past_deadline()) return false;
+            if (!budget.try_withdraw(host, policy->retry_budget_ratio, policy->retry_budget_min_per_second)) {
+#               if KURLYK_ENABLE_METRICS
+                metrics::builtin().http_retry_budget_exhausted.inc();
+#               endif
+                return false;
+            }
+            return true;
+        }
+
+        /// \brief Checks whether a retry could only start after the request deadline.
+        /// \return True if the request has a deadline that passes before its retry delay elapses.
+        bool is_retry_past_deadline() const {
+            const auto& request = m_request_context->request;
+            if (request->deadline == std::chrono::steady_clock::time_point()) return false;
+            const auto retry_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_request_context->retry_delay_ms);
+            return retry_time >= request->deadline;
+        }
 
         /// \brief Initializes CURL options for the request, setting headers, method, SSL, timeouts, and other parameters.
         void init_curl() {
             if (!m_request_context) return;
             const auto& request = m_request_context->request;
-            m_curl = curl_easy_init();
+            if (m_pool) {
+                // Pooled handles come back reset, so every option below must be set again.
+                m_origin = utils::extract_origin(request->url);
+                m_curl = m_pool->acquire(m_origin);
+            } else {
+                m_curl = curl_easy_init();
+            }
             if (!m_curl) return;
 
             curl_easy_setopt(m_curl, CURLOPT_URL, request->url.c_str());
@@ -160,6 +218,9 @@ namespace kurlyk {
                 curl_easy_setopt(m_curl, CURLOPT_NOBODY, 1L);
             }
             curl_easy_setopt(m_curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_0);
+            // Prefer waiting for a connection that can multiplex over opening a new one,
+            // except for a hedged copy, which must not queue behind the copy it races.
+            curl_easy_setopt(m_curl, CURLOPT_PIPEWAIT, m_request_context->is_hedge ? 0L : 1L);
 
             set_ssl_options(*request);
             set_request_options(*request);
@@ -192,7 +253,7 @@ namespace kurlyk {
             if (!request.ca_file.empty()) {
                 curl_easy_setopt(m_curl, CURLOPT_CAINFO, request.ca_file.c_str());
             } else {
-                curl_easy_setopt(m_curl, CURLOPT_CAINFO, get_ca_file_path());
+                set_default_ca_options();
             }
             if (!request.ca_path.empty()) {
                 curl_easy_setopt(m_curl, CURLOPT_CAPATH, request.ca_path.c_str());
@@ -279,16 +340,55 @@ namespace kurlyk {
             }
         }
 
-        /// \brief Gets the full path to the CA certificate file.
-        const char* get_ca_file_path() const {
-#           if defined(_WIN32)
-            m_ca_file = utils::get_exec_dir() + "\\curl-ca-bundle.crt";
-            m_ca_file = utils::utf8_to_ansi(m_ca_file);
+        /// \brief Passes the response of the transfer to the request callback.
+        ///
+        /// With tracing, the time spent in the callback is the `callback` stage. If the user callback was
+        /// posted to the callback executor instead, this time is the `dispatch` stage, and the executor task
+        /// records the `callback` span itself.
+        void invoke_callback() {
+#           if KURLYK_ENABLE_TRACING
+            auto& delivery = tracing::current_delivery();
+            delivery.trace_id = m_request_context->trace_id;
+            delivery.posted = false;
+            m_request_context->callback(std::move(m_response));
+            m_request_context->trace_stage(delivery.posted ? "dispatch" : "callback");
+            delivery = tracing::TraceDelivery();
 #           else
-            m_ca_file = utils::get_exec_dir() + "/curl-ca-bundle.crt";
+            m_request_context->callback(std::move(m_response));
 #           endif
-            return m_ca_file.c_str();
+            m_callback_called = true;
+        }
+
+        /// \brief Sets the default CA bundle, passing the cached PEM data from memory when possible.
+        ///
+        /// libcurl 7.87+ reuses the store parsed from a CAINFO file across connections, while a blob
+        /// is parsed again for every connection, so there the path is passed until the bundle is reloaded.
+        void set_default_ca_options() {
+            auto& ca_bundle = HttpCaBundle::get_instance();
+#           if LIBCURL_VERSION_NUM >= 0x075700
+            if (ca_bundle.is_reloaded() && set_ca_blob(ca_bundle)) return;
+#           elif LIBCURL_VERSION_NUM >= 0x074D00
+            if (set_ca_blob(ca_bundle)) return;
+#           endif
+            m_ca_file = ca_bundle.get_path();
+            curl_easy_setopt(m_curl, CURLOPT_CAINFO, m_ca_file.c_str());
+        }
+
+#       if LIBCURL_VERSION_NUM >= 0x074D00
+        /// \brief Passes the cached CA bundle through CURLOPT_CAINFO_BLOB.
+        /// \return True if the blob was set.
+        bool set_ca_blob(HttpCaBundle& ca_bundle) {
+            m_ca_bundle = ca_bundle.get();
+            if (!m_ca_bundle) return false;
+            struct curl_blob blob;
+            blob.data = const_cast<char*>(m_ca_bundle->data());
+            blob.len = m_ca_bundle->size();
+            blob.flags = CURL_BLOB_NOCOPY; // m_ca_bundle keeps the data alive.
+            if (curl_easy_setopt(m_curl, CURLOPT_CAINFO_BLOB, &blob) == CURLE_OK) return true;
+            m_ca_bundle.reset();
+            return false;
         }
+#       endif
     }; // HttpRequestHandler
 
 } // namespace kurlyk
@@ -0,0 +1,324 @@
+#pragma once
+#ifndef _KURLYK_HTTP_RESPONSE_CACHE_HPP_INCLUDED
+#define _KURLYK_HTTP_RESPONSE_CACHE_HPP_INCLUDED
+
+/// \file HttpResponseCache.hpp
+/// \brief Defines HttpResponseCache, an in-memory LRU cache of HTTP responses.
+
+#include <cctype>
+
+namespace kurlyk {
+
+    /// \class HttpResponseCache
+    /// \brief Thread-safe LRU cache of successful HTTP responses, bounded by the bytes it holds.
+    ///
+    /// Entries keep the response together with its validators (`ETag`, `Last-Modified`) and the time until
+    /// which it is fresh, computed from `Cache-Control: max-age`, `Expires` or, for responses that only have
+    /// `Last-Modified`, the usual heuristic of 10% of their age. Responses with `Cache-Control: no-store` or
+    /// `Vary: *` are not stored; `no-cache` responses are stored but always revalidated.
+    ///
+    /// An optional HttpDiskCache below the memory tier keeps entries across restarts: stores are written
+    /// through to it, and a memory miss that is found on disk is loaded back into memory.
+    class HttpResponseCache {
+    public:
+        using clock_t      = std::chrono::system_clock;
+        using time_point_t = clock_t::time_point;
+
+        using Entry       = HttpCacheEntry;
+        using entry_ptr_t = std::shared_ptr<const Entry>;
+
+        /// \brief Constructs a cache.
+        /// \param max_bytes Maximum total size of the entries.
+        explicit HttpResponseCache(std::size_t max_bytes = KURLYK_HTTP_CACHE_MAX_BYTES)
+            : m_max_bytes(max_bytes) {
+        }
+
+        /// \brief Sets the maximum total size of the entries, evicting the least recently used ones.
+        /// \param max_bytes Size in bytes; 0 disables caching.
+        void set_max_bytes(std::size_t max_bytes) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_max_bytes = max_bytes;
+            evict();
+        }
+
+        /// \brief Sets the disk tier below the memory cache.
+        /// \param disk_cache Persistent store, or nullptr to keep entries in memory only.
+        void set_disk_cache(std::shared_ptr<HttpDiskCache> disk_cache) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_disk_cache = std::move(disk_cache);
+        }
+
+        /// \brief Returns the total size of the entries.
+        /// \return Size in bytes.
+        std::size_t get_size_bytes() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_size_bytes;
+        }
+
+        /// \brief Looks up an entry and marks it as most recently used.
+        /// \param key Request fingerprint.
+        /// \return The entry, or nullptr if there is none.
+        entry_ptr_t find(const std::string& key) {
+            std::shared_ptr<HttpDiskCache> disk_cache;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_slots.find(key);
+                if (it != m_slots.end()) {
+                    m_lru.splice(m_lru.begin(), m_lru, it->second.lru_it);
+                    return it->second.entry;
+                }
+                disk_cache = m_disk_cache;
+            }
+            if (!disk_cache) return nullptr;
+            entry_ptr_t entry = disk_cache->find(key);
+            if (!entry) return nullptr;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            insert(key, entry);
+            return entry;
+        }
+
+        /// \brief Adds or replaces an entry.
+        /// \param key Request fingerprint.
+        /// \param entry Entry to store; an entry larger than the cache is not stored.
+        void store(const std::string& key, entry_ptr_t entry) {
+            if (!entry) return;
+            std::unique_lock<std::mutex> lock(m_mutex);
+            insert(key, entry);
+            auto disk_cache = m_disk_cache;
+            lock.unlock();
+            if (disk_cache) disk_cache->store(key, *entry);
+        }
+
+        /// \brief Removes an entry.
+        /// \param key Request fingerprint.
+        void erase(const std::string& key) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            remove(key);
+            auto disk_cache = m_disk_cache;
+            lock.unlock();
+            if (disk_cache) disk_cache->erase(key);
+        }
+
+        /// \brief Removes all entries, including the ones on disk.
+        void clear() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_slots.clear();
+            m_lru.clear();
+            m_size_bytes = 0;
+            auto disk_cache = m_disk_cache;
+            lock.unlock();
+            if (disk_cache) disk_cache->clear();
+        }
+
+        /// \brief Checks whether an entry may be used without revalidation.
+        /// \param entry Entry to check.
+        /// \param now Current time.
+        /// \return True if the entry is fresh.
+        static bool is_fresh(const Entry& entry, time_point_t now) {
+            return now < entry.expires_at;
+        }
+
+        /// \brief Checks whether an entry can be revalidated with a conditional request.
+        /// \param entry Entry to check.
+        /// \return True if the entry has an `ETag` or `Last-Modified` validator.
+        static bool has_validators(const Entry& entry) {
+            return !entry.etag.empty() || !entry.last_modified.empty();
+        }
+
+        /// \brief Creates an entry from a response.
+        /// \param response Successful response.
+        /// \param now Time the response was received.
+        /// \return The entry, or nullptr if the response must not be stored or would never be reused.
+        static entry_ptr_t make_entry(const HttpResponse& response, time_point_t now) {
+            auto entry = std::make_shared<Entry>();
+            entry->status_code = response.status_code;
+            entry->headers = response.headers;
+            entry->content = response.content;
+            if (!update_validity(*entry, now)) return nullptr;
+            return entry;
+        }
+
+        /// \brief Creates the entry refreshed by a `304 Not Modified` response.
+        /// \param entry Revalidated entry.
+        /// \param response The 304 response; its headers replace the stored ones.
+        /// \param now Time the response was received.
+        /// \return The refreshed entry, or nullptr if it must no longer be stored.
+        static entry_ptr_t revalidate(const Entry& entry, const HttpResponse& response, time_point_t now) {
+            auto updated = std::make_shared<Entry>(entry);
+            for (const auto& header : response.headers) {
+                updated->headers.erase(header.first);
+            }
+            for (const auto& header : response.headers) {
+                updated->headers.emplace(header.first, header.second);
+            }
+            if (!update_validity(*updated, now)) return nullptr;
+            return updated;
+        }
+
+        /// \brief Creates a response from an entry.
+        /// \param entry Cached entry.
+        /// \return Ready response with the cached status, headers and body.
+        static HttpResponsePtr make_response(const Entry& entry) {
+#           if __cplusplus >= 201402L
+            auto response = std::make_unique<HttpResponse>();
+#           else
+            auto response = std::unique_ptr<HttpResponse>(new HttpResponse());
+#           endif
+            response->status_code = entry.status_code;
+            response->headers = entry.headers;
+            response->content = entry.content;
+            response->ready = true;
+            return response;
+        }
+
+        /// \brief Checks a `Cache-Control` value for a directive.
+        /// \param cache_control Comma-separated directives.
+        /// \param name Directive name in lower case.
+        /// \param value Receives the numeric argument of the directive, if present and requested.
+        /// \return True if the directive is present.
+        static bool has_directive(const std::string& cache_control, const char* name, long* value = nullptr) {
+            const std::string lower = utils::to_lower_case(cache_control);
+            const std::size_t name_size = std::strlen(name);
+            std::size_t pos = 0;
+            while (pos < lower.size()) {
+                std::size_t end = lower.find(',', pos);
+                if (end == std::string::npos) end = lower.size();
+                std::size_t begin = lower.find_first_not_of(" \t", pos);
+                if (begin < end && lower.compare(begin, name_size, name) == 0) {
+                    std::size_t next = begin + name_size;
+                    if (next == end || lower[next] == '=' || lower[next] == ' ' || lower[next] == '\t') {
+                        if (value) {
+                            *value = -1;
+                            const std::size_t eq = lower.find('=', next);
+                            if (eq < end) {
+                                std::size_t digits = lower.find_first_not_of(" \t\"", eq + 1);
+                                if (digits < end && std::isdigit(static_cast<unsigned char>(lower[digits]))) {
+                                    *value = std::strtol(lower.c_str() + digits, nullptr, 10);
+                                }
+                            }
+                        }
+                        return true;
+                    }
+                }
+                pos = end + 1;
+            }
+            return false;
+        }
+
+        /// \brief Returns all values of a header joined with commas.
+        /// \param headers Headers to search.
+        /// \param name Header name.
+        /// \return Joined values, or an empty string if the header is absent.
+        static std::string get_header(const Headers& headers, const std::string& name) {
+            std::string result;
+            auto range = headers.equal_range(name);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (!result.empty()) result += ", ";
+                result += it->second;
+            }
+            return result;
+        }
+
+    private:
+
+        /// \struct Slot
+        /// \brief Entry with its size and position in the LRU list.
+        struct Slot {
+            entry_ptr_t                      entry;    ///< Cached entry.
+            std::size_t                      size = 0; ///< Size accounted for the entry.
+            std::list<std::string>::iterator lru_it;   ///< Position of the key in m_lru.
+        };
+
+        mutable std::mutex                    m_mutex;          ///< Mutex protecting the state below.
+        std::unordered_map<std::string, Slot> m_slots;          ///< Entries by request fingerprint.
+        std::list<std::string>                m_lru;            ///< Keys from the most to the least recently used.
+        std::size_t                           m_max_bytes = 0;  ///< Maximum total size of the entries.
+        std::size_t                           m_size_bytes = 0; ///< Total size of the entries.
+        std::shared_ptr<HttpDiskCache>        m_disk_cache;     ///< Persistent tier, if any.
+
+        /// \brief Adds or replaces an entry in memory. Must be called with m_mutex held.
+        void insert(const std::string& key, entry_ptr_t entry) {
+            const std::size_t size = get_entry_size(key, *entry);
+            remove(key);
+            if (size > m_max_bytes) return;
+            m_lru.push_front(key);
+            Slot& slot = m_slots[key];
+            slot.entry = std::move(entry);
+            slot.size = size;
+            slot.lru_it = m_lru.begin();
+            m_size_bytes += size;
+            evict();
+        }
+
+        /// \brief Removes an entry. Must be called with m_mutex held.
+        void remove(const std::string& key) {
+            auto it = m_slots.find(key);
+            if (it == m_slots.end()) return;
+            m_size_bytes -= it->second.size;
+            m_lru.erase(it->second.lru_it);
+            m_slots.erase(it);
+        }
+
+        /// \brief Evicts the least recently used entries until the size limit is met. Must be called with m_mutex held.
+        void evict() {
+            while (m_size_bytes > m_max_bytes && !m_lru.empty()) {
+                const std::string key = m_lru.back();
+                remove(key);
+            }
+        }
+
+        /// \brief Returns the size accounted for an entry.
+        static std::size_t get_entry_size(const std::string& key, const Entry& entry) {
+            std::size_t size = sizeof(Entry) + key.size() + entry.content.size();
+            for (const auto& header : entry.headers) {
+                size += header.first.size() + header.second.size();
+            }
+            return size;
+        }
+
+        /// \brief Parses an HTTP date.
+        /// \return True if the value is a valid date.
+        static bool parse_date(const std::string& value, time_point_t& time) {
+            if (value.empty()) return false;
+            const time_t seconds = curl_getdate(value.c_str(), nullptr);
+            if (seconds < 0) return false;
+            time = clock_t::from_time_t(seconds);
+            return true;
+        }
+
+        /// \brief Updates the validators and freshness of an entry from its headers.
+        /// \return False if the entry must not be stored or would never be reused.
+        static bool update_validity(Entry& entry, time_point_t now) {
+            const std::string cache_control = get_header(entry.headers, "Cache-Control");
+            if (has_directive(cache_control, "no-store")) return false;
+            if (get_header(entry.headers, "Vary").find('*') != std::string::npos) return false;
+            entry.etag = get_header(entry.headers, "ETag");
+            entry.last_modified = get_header(entry.headers, "Last-Modified");
+
+            entry.expires_at = now;
+            if (!has_directive(cache_control, "no-cache")) {
+                time_point_t date;
+                if (!parse_date(get_header(entry.headers, "Date"), date)) date = now;
+                clock_t::duration lifetime = clock_t::duration::zero();
+                long max_age = -1;
+                time_point_t time;
+                if (has_directive(cache_control, "max-age", &max_age) && max_age >= 0) {
+                    lifetime = std::chrono::duration_cast<clock_t::duration>(std::chrono::seconds(max_age));
+                } else
+                if (parse_date(get_header(entry.headers, "Expires"), time)) {
+                    if (time > date) lifetime = time - date;
+                } else
+                if (parse_date(entry.last_modified, time) && date > time) {
+                    lifetime = (date - time) / 10;
+                }
+                const long age = std::strtol(get_header(entry.headers, "Age").c_str(), nullptr, 10);
+                if (age > 0) lifetime -= std::chrono::duration_cast<clock_t::duration>(std::chrono::seconds(age));
+                if (lifetime > clock_t::duration::zero()) entry.expires_at = now + lifetime;
+            }
+            return is_fresh(entry, now) || has_validators(entry);
+        }
+    }; // HttpResponseCache
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_RESPONSE_CACHE_HPP_INCLUDED
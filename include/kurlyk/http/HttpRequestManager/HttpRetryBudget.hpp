@@ -0,0 +1,100 @@
+#pragma once
+#ifndef _KURLYK_HTTP_RETRY_BUDGET_HPP_INCLUDED
+#define _KURLYK_HTTP_RETRY_BUDGET_HPP_INCLUDED
+
+/// \file HttpRetryBudget.hpp
+/// \brief Defines HttpRetryBudget, which caps retries per host as a fraction of the traffic to it.
+
+namespace kurlyk {
+
+    /// \class HttpRetryBudget
+    /// \brief Thread-safe token buckets limiting retries per host.
+    ///
+    /// Every request completing its first attempt deposits `ratio` tokens into the bucket of its host, and
+    /// every retry withdraws one token. The bucket also refills at `min_per_second` tokens per second so a
+    /// host with little traffic can still be retried. The balance is capped, so an idle period does not
+    /// build up a burst of retries.
+    ///
+    /// The same buckets also limit hedged requests: HttpRequestManager keeps a separate instance, into which
+    /// every hedged request deposits and from which every hedge withdraws.
+    class HttpRetryBudget {
+    public:
+        using time_point_t = std::chrono::steady_clock::time_point;
+
+        HttpRetryBudget() = default;
+
+        /// \brief Returns the budget shared by all HTTP requests.
+        /// \return Reference to the singleton instance.
+        static HttpRetryBudget& get_instance() {
+            static HttpRetryBudget* instance = new HttpRetryBudget();
+            return *instance;
+        }
+
+        /// \brief Records a request sent to a host.
+        /// \param host Host key, e.g. the URL origin.
+        /// \param ratio Tokens added per request.
+        /// \param min_per_second Refill rate independent of traffic.
+        void deposit(const std::string& host, double ratio, double min_per_second) {
+            if (ratio <= 0.0) return;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Bucket& bucket = get_bucket(host, std::chrono::steady_clock::now(), ratio, min_per_second);
+            bucket.tokens = std::min(bucket.tokens + ratio, capacity(ratio, min_per_second));
+        }
+
+        /// \brief Takes a token for a retry if the budget of the host allows it.
+        /// \param host Host key, e.g. the URL origin.
+        /// \param ratio Tokens added per request.
+        /// \param min_per_second Refill rate independent of traffic.
+        /// \return True if the retry is allowed.
+        bool try_withdraw(const std::string& host, double ratio, double min_per_second) {
+            if (ratio <= 0.0) return true;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Bucket& bucket = get_bucket(host, std::chrono::steady_clock::now(), ratio, min_per_second);
+            if (bucket.tokens < 1.0) return false;
+            bucket.tokens -= 1.0;
+            return true;
+        }
+
+        /// \brief Forgets the state of all hosts.
+        void clear() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_buckets.clear();
+        }
+
+    private:
+
+        /// \struct Bucket
+        /// \brief Token balance of one host.
+        struct Bucket {
+            double       tokens = 0.0;  ///< Retries currently allowed.
+            time_point_t update_time;   ///< Time of the last refill.
+        };
+
+        std::mutex                              m_mutex;   ///< Mutex protecting m_buckets.
+        std::unordered_map<std::string, Bucket> m_buckets; ///< Buckets by host.
+
+        /// \brief Returns the maximum balance of a bucket.
+        static double capacity(double ratio, double min_per_second) {
+            return std::max(1.0, ratio * 10.0 + min_per_second);
+        }
+
+        /// \brief Returns the bucket of a host after applying the time-based refill. Must be called with m_mutex held.
+        Bucket& get_bucket(const std::string& host, time_point_t now, double ratio, double min_per_second) {
+            auto it = m_buckets.find(host);
+            if (it == m_buckets.end()) {
+                Bucket bucket;
+                bucket.tokens = capacity(ratio, min_per_second);
+                bucket.update_time = now;
+                return m_buckets.emplace(host, bucket).first->second;
+            }
+            Bucket& bucket = it->second;
+            const double elapsed = std::chrono::duration<double>(now - bucket.update_time).count();
+            bucket.tokens = std::min(bucket.tokens + elapsed * min_per_second, capacity(ratio, min_per_second));
+            bucket.update_time = now;
+            return bucket;
+        }
+    }; // HttpRetryBudget
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_RETRY_BUDGET_HPP_INCLUDED
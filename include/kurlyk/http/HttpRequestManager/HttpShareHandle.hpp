@@ -0,0 +1,87 @@
+#pragma once
+#ifndef _KURLYK_HTTP_SHARE_HANDLE_HPP_INCLUDED
+#define _KURLYK_HTTP_SHARE_HANDLE_HPP_INCLUDED
+
+/// \file HttpShareHandle.hpp
+/// \brief Defines a RAII wrapper around a libcurl share object used by all HTTP requests.
+
+namespace kurlyk {
+
+    /// \class HttpShareHandle
+    /// \brief Owns a `CURLSH` object that shares DNS, TLS sessions, connections and optionally cookies.
+    ///
+    /// Every easy handle attached to the share reuses cached name resolutions and can resume
+    /// TLS sessions negotiated by other handles. Access to each kind of shared data is
+    /// serialized by its own mutex, so the share may be used from several threads.
+    class HttpShareHandle {
+    public:
+
+        /// \brief Creates the share object.
+        /// \param share_connections Whether to share the connection cache. libcurl does not support
+        /// using a shared connection cache from several threads at once, so only enable this when
+        /// all attached handles are driven by the same thread.
+        /// \param share_cookies Whether to share cookies between all attached handles.
+        explicit HttpShareHandle(
+                bool share_connections = true,
+                bool share_cookies = KURLYK_HTTP_SHARE_COOKIES)
+            : m_share(curl_share_init()) {
+            if (!m_share) return;
+            curl_share_setopt(m_share, CURLSHOPT_LOCKFUNC, lock_callback);
+            curl_share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, unlock_callback);
+            curl_share_setopt(m_share, CURLSHOPT_USERDATA, this);
+            curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#           if LIBCURL_VERSION_NUM >= 0x073900
+            if (share_connections) {
+                curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+            }
+#           else
+            (void)share_connections;
+#           endif
+            if (share_cookies) {
+                curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
+            }
+        }
+
+        /// \brief Releases the share object. All easy handles must be detached or cleaned up first.
+        ~HttpShareHandle() {
+            if (m_share) curl_share_cleanup(m_share);
+        }
+
+        HttpShareHandle(const HttpShareHandle&) = delete;
+        HttpShareHandle& operator=(const HttpShareHandle&) = delete;
+
+        /// \brief Attaches an easy handle to the share.
+        /// \param curl Easy handle to attach.
+        void attach(CURL* curl) const {
+            if (m_share && curl) curl_easy_setopt(curl, CURLOPT_SHARE, m_share);
+        }
+
+        /// \brief Returns the underlying share object.
+        /// \return Pointer to the `CURLSH` object, or nullptr if it could not be created.
+        CURLSH* get() const noexcept { return m_share; }
+
+    private:
+        CURLSH*    m_share = nullptr;                  ///< libcurl share object.
+        std::mutex m_mutexes[CURL_LOCK_DATA_LAST];     ///< One mutex per kind of shared data.
+
+        /// \brief Locks the mutex guarding the requested kind of shared data.
+        static void lock_callback(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr) {
+            (void)handle;
+            (void)access;
+            if (data < 0 || data >= CURL_LOCK_DATA_LAST) return;
+            static_cast<HttpShareHandle*>(userptr)->m_mutexes[data].lock();
+        }
+
+        /// \brief Unlocks the mutex guarding the requested kind of shared data.
+        static void unlock_callback(CURL* handle, curl_lock_data data, void* userptr) {
+            (void)handle;
+            if (data < 0 || data >= CURL_LOCK_DATA_LAST) return;
+            static_cast<HttpShareHandle*>(userptr)->m_mutexes[data].unlock();
+        }
+
+    }; // HttpShareHandle
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_SHARE_HANDLE_HPP_INCLUDED
@@ -0,0 +1,239 @@
+#pragma once
+#ifndef _KURLYK_HTTP_WORKER_SHARD_HPP_INCLUDED
+#define _KURLYK_HTTP_WORKER_SHARD_HPP_INCLUDED
+
+/// \file HttpWorkerShard.hpp
+/// \brief Defines HttpWorkerShard, a thread driving its own libcurl multi handle.
+
+namespace kurlyk {
+
+    /// \class HttpCancelBatch
+    /// \brief Set of request IDs to cancel, shared by all worker shards.
+    ///
+    /// The cancellation callbacks run when the last shard releases the batch, i.e. after every
+    /// shard has removed the matching requests from its multi handle.
+    class HttpCancelBatch {
+    public:
+        using callback_list_t = std::list<std::function<void()>>;
+        using cancel_map_t    = std::unordered_map<uint64_t, callback_list_t>;
+
+        /// \brief Constructs a batch from request IDs and their cancellation callbacks.
+        /// \param requests Map of request IDs to their cancellation callbacks.
+        explicit HttpCancelBatch(cancel_map_t requests)
+            : m_requests(std::move(requests)) {
+        }
+
+        /// \brief Invokes the cancellation callbacks.
+        ~HttpCancelBatch() {
+            for (const auto& request : m_requests) {
+                for (const auto& callback : request.second) {
+                    if (callback) callback();
+                }
+            }
+        }
+
+        HttpCancelBatch(const HttpCancelBatch&) = delete;
+        HttpCancelBatch& operator=(const HttpCancelBatch&) = delete;
+
+        /// \brief Returns the request IDs to cancel.
+        /// \return Map of request IDs to their cancellation callbacks.
+        const cancel_map_t& get_requests() const {
+            return m_requests;
+        }
+
+    private:
+        cancel_map_t m_requests; ///< Request IDs and their cancellation callbacks.
+    }; // HttpCancelBatch
+
+    /// \class HttpWorkerShard
+    /// \brief Runs a persistent HttpBatchRequestHandler on a dedicated thread.
+    ///
+    /// The shard performs transfers and invokes completion callbacks on its own thread. Requests
+    /// are submitted through a lock-free queue; requests that fail and may be retried are handed
+    /// back through the failure handler, which is called on the shard thread. A failed request listed
+    /// in a cancel batch the shard has not processed yet is completed as cancelled instead.
+    class HttpWorkerShard {
+    public:
+        using context_ptr_t   = std::unique_ptr<HttpRequestContext>;
+        using failed_handler_t = std::function<void(context_ptr_t)>;
+
+        /// \brief Constructs a shard and starts its thread.
+        /// \param share_handle Share object used by the shard's easy handles.
+        /// \param on_failed Handler receiving failed requests that may be retried.
+        HttpWorkerShard(
+                std::shared_ptr<HttpShareHandle> share_handle,
+                failed_handler_t on_failed)
+            : m_batch_handler(std::move(share_handle)),
+              m_on_failed(std::move(on_failed)) {
+            m_thread = std::thread([this]() { run(); });
+        }
+
+        /// \brief Stops the shard thread.
+        ~HttpWorkerShard() {
+            stop();
+        }
+
+        HttpWorkerShard(const HttpWorkerShard&) = delete;
+        HttpWorkerShard& operator=(const HttpWorkerShard&) = delete;
+
+        /// \brief Submits a request to the shard. Safe to call from any thread.
+        /// \param context Context of the request to perform.
+        void add_request(context_ptr_t context) {
+            m_active_requests.fetch_add(1, std::memory_order_relaxed);
+            m_submitted_requests.push(std::move(context));
+            m_batch_handler.wakeup();
+        }
+
+        /// \brief Cancels the shard's requests listed in the batch. Safe to call from any thread.
+        /// \param batch Shared set of request IDs to cancel.
+        void cancel_requests(std::shared_ptr<HttpCancelBatch> batch) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cancel_batches.push_back(std::move(batch));
+            lock.unlock();
+            m_batch_handler.wakeup();
+        }
+
+        /// \brief Stops the shard thread and completes its remaining requests with an abort error.
+        ///
+        /// Requests that have not been started yet are completed with the 499 status code and
+        /// utils::ClientError::CancelledByUser.
+        void stop() {
+            if (!m_thread.joinable()) return;
+            m_stop = true;
+            m_batch_handler.wakeup();
+            m_thread.join();
+
+            while (auto context = m_submitted_requests.pop()) {
+#               if __cplusplus >= 201402L
+                auto response = std::make_unique<HttpResponse>();
+#               else
+                auto response = std::unique_ptr<HttpResponse>(new HttpResponse());
+#               endif
+                const long CANCELED_REQUEST_CODE = 499;
+                response->error_code = utils::make_error_code(utils::ClientError::CancelledByUser);
+                response->status_code = CANCELED_REQUEST_CODE;
+                response->ready = true;
+                context->callback(std::move(response));
+            }
+            m_batch_handler.clear();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_cancel_batches.clear();
+            m_active_requests = 0;
+        }
+
+        /// \brief Returns the number of submitted requests that have not completed yet.
+        /// \return Number of queued and active requests.
+        std::size_t get_active_count() const {
+            return m_active_requests.load(std::memory_order_relaxed);
+        }
+
+        /// \brief Checks whether the shard has submitted or active requests.
+        /// \return True if requests are still being performed.
+        bool is_loaded() const {
+            return m_active_requests.load(std::memory_order_relaxed) != 0;
+        }
+
+    private:
+        using cancel_batch_list_t = std::vector<std::shared_ptr<HttpCancelBatch>>;
+
+        HttpBatchRequestHandler              m_batch_handler;       ///< Multi handle owned by the shard; used by the shard thread only.
+        failed_handler_t                     m_on_failed;           ///< Receives failed requests that may be retried.
+        utils::MpscQueue<HttpRequestContext> m_submitted_requests;  ///< Lock-free queue of requests to start.
+        std::mutex                           m_mutex;               ///< Mutex protecting m_cancel_batches.
+        cancel_batch_list_t                  m_cancel_batches;      ///< Pending cancellations.
+        std::atomic<std::size_t>             m_active_requests = ATOMIC_VAR_INIT(0); ///< Submitted requests not yet completed.
+        std::atomic<bool>                    m_stop = ATOMIC_VAR_INIT(false);        ///< Flag requesting the thread to exit.
+        std::thread                          m_thread;              ///< Shard thread.
+
+        /// \brief Upper bound for a single wait, so a lost wakeup can never stall the shard.
+        static constexpr int MAX_POLL_TIMEOUT_MS = 1000;
+
+        /// \brief Main loop of the shard thread.
+        void run() {
+            std::size_t tracked = 0; // Requests counted in m_active_requests and owned by m_batch_handler.
+            while (!m_stop) {
+                std::vector<context_ptr_t> new_requests;
+                std::size_t count = m_submitted_requests.size();
+                while (count--) {
+                    auto context = m_submitted_requests.pop();
+                    if (!context) break;
+                    new_requests.push_back(std::move(context));
+                }
+                tracked += new_requests.size();
+                if (!new_requests.empty()) m_batch_handler.add_requests(new_requests);
+
+                std::unique_lock<std::mutex> lock(m_mutex);
+                cancel_batch_list_t cancel_batches;
+                cancel_batches.swap(m_cancel_batches);
+                lock.unlock();
+                for (const auto& batch : cancel_batches) {
+                    m_batch_handler.cancel_request_by_id(batch->get_requests());
+                }
+                cancel_batches.clear();
+
+                try {
+                    m_batch_handler.process();
+                } catch(...) {
+                    KURLYK_HANDLE_ERROR(std::current_exception(), "Exception in HttpWorkerShard");
+                }
+                auto failed_requests = m_batch_handler.extract_failed_requests();
+                if (!failed_requests.empty()) hand_back_failed_requests(failed_requests);
+
+                const std::size_t active = m_batch_handler.size();
+                m_active_requests.fetch_sub(tracked - active, std::memory_order_relaxed);
+                tracked = active;
+
+                if (!m_submitted_requests.empty()) continue;
+                long timeout_ms = m_batch_handler.get_timeout_ms();
+                if (timeout_ms < 0 || timeout_ms > MAX_POLL_TIMEOUT_MS) timeout_ms = MAX_POLL_TIMEOUT_MS;
+                if (timeout_ms > 0) m_batch_handler.poll(static_cast<int>(timeout_ms));
+            }
+        }
+
+        /// \brief Passes failed requests to the failure handler, completing the cancelled ones instead.
+        ///
+        /// The check and the hand-off happen under m_mutex, so a cancel batch queued concurrently either
+        /// is seen here or is queued after the request reached the manager, which checks it there.
+        /// \param failed_requests Requests that failed and may be retried.
+        void hand_back_failed_requests(std::list<context_ptr_t>& failed_requests) {
+            std::vector<context_ptr_t> cancelled_requests;
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (auto& context : failed_requests) {
+                if (!context || !context->request) continue;
+                const uint64_t request_id = context->request->request_id;
+                const bool is_cancelled = std::any_of(m_cancel_batches.begin(), m_cancel_batches.end(),
+                    [request_id](const std::shared_ptr<HttpCancelBatch>& batch) {
+                        return batch->get_requests().count(request_id) != 0;
+                    });
+                if (is_cancelled) {
+                    cancelled_requests.push_back(std::move(context));
+                } else
+                if (m_on_failed) {
+                    m_on_failed(std::move(context));
+                }
+            }
+            lock.unlock();
+
+            for (auto& context : cancelled_requests) {
+#               if __cplusplus >= 201402L
+                auto response = std::make_unique<HttpResponse>();
+#               else
+                auto response = std::unique_ptr<HttpResponse>(new HttpResponse());
+#               endif
+                const long CANCELED_REQUEST_CODE = 499;
+                response->error_code = utils::make_error_code(utils::ClientError::CancelledByUser);
+                response->status_code = CANCELED_REQUEST_CODE;
+                response->retry_attempt = context->retry_attempt;
+                response->ready = true;
+                context->callback(std::move(response));
+#               if KURLYK_ENABLE_METRICS
+                metrics::builtin().http_cancellations.inc();
+#               endif
+            }
+        }
+
+    }; // HttpWorkerShard
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_WORKER_SHARD_HPP_INCLUDED
@@ -7,5 +7,9 @@
 
 #include "data/HttpRequest.hpp"
 #include "data/HttpResponse.hpp"
+#include "data/RateLimitFeedback.hpp"
+#include "data/HttpRetryPolicy.hpp"
+#include "data/HttpHedgePolicy.hpp"
+#include "data/HttpCircuitBreakerPolicy.hpp"
 
 #endif // _KURLYK_HTTP_DATA_HPP_INCLUDED
@@ -0,0 +1,48 @@
+#pragma once
+#ifndef _KURLYK_HTTP_CIRCUIT_BREAKER_POLICY_HPP_INCLUDED
+#define _KURLYK_HTTP_CIRCUIT_BREAKER_POLICY_HPP_INCLUDED
+
+/// \file HttpCircuitBreakerPolicy.hpp
+/// \brief Defines HttpCircuitBreakerPolicy, which decides when requests to a failing host fail fast.
+
+namespace kurlyk {
+
+    /// \class HttpCircuitBreakerPolicy
+    /// \brief Settings of the per-host circuit breaker.
+    ///
+    /// The responses of requests with a policy are counted per host (URL origin) in windows of `window_ms`.
+    /// Once a window has at least `min_requests` responses and the share of failures reaches `failure_rate`,
+    /// the circuit of the host opens: for `open_ms`, requests to the host that are about to be sent are
+    /// completed with utils::ClientError::CircuitOpen instead. The circuit then becomes half-open and lets
+    /// `probe_requests` requests through; it closes after as many successes and opens again on a failure.
+    ///
+    /// Every attempt of a retried request is counted. Cancelled and expired requests are not.
+    class HttpCircuitBreakerPolicy {
+    public:
+        double      failure_rate   = 0.5;   ///< Share of failed responses in a window that opens the circuit.
+        std::size_t min_requests   = 20;    ///< Responses in a window needed before the circuit may open.
+        long        window_ms      = 10000; ///< Length of the window in which responses are counted, in milliseconds.
+        long        open_ms        = 5000;  ///< Time the circuit stays open before probe requests are sent, in milliseconds.
+        std::size_t probe_requests = 1;     ///< Requests sent while half-open, and successes needed to close the circuit.
+
+        /// \brief HTTP statuses counted as failures of the host.
+        std::set<long> failure_statuses = {500, 502, 503, 504};
+
+        virtual ~HttpCircuitBreakerPolicy() = default;
+
+        /// \brief Decides whether a response counts as a failure of the host.
+        /// \param response Response of one attempt.
+        /// \return True for libcurl errors (e.g. connection failures and timeouts) and for `failure_statuses`.
+        virtual bool is_failure(const HttpResponse& response) const {
+            static const std::error_category& curl_category = utils::make_error_code(CURLE_OK).category();
+            if (response.error_code && response.error_code.category() == curl_category) return true;
+            return failure_statuses.count(response.status_code) != 0;
+        }
+    }; // HttpCircuitBreakerPolicy
+
+    /// \brief Shared pointer to a circuit breaker policy; one policy may be used by many requests.
+    using HttpCircuitBreakerPolicyPtr = std::shared_ptr<HttpCircuitBreakerPolicy>;
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_CIRCUIT_BREAKER_POLICY_HPP_INCLUDED
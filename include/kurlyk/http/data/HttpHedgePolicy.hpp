@@ -0,0 +1,34 @@
+#pragma once
+#ifndef _KURLYK_HTTP_HEDGE_POLICY_HPP_INCLUDED
+#define _KURLYK_HTTP_HEDGE_POLICY_HPP_INCLUDED
+
+/// \file HttpHedgePolicy.hpp
+/// \brief Defines HttpHedgePolicy, which controls when a second copy of a slow HTTP request is sent.
+
+namespace kurlyk {
+
+    /// \class HttpHedgePolicy
+    /// \brief Settings of hedged requests.
+    ///
+    /// When a request with a hedge policy has not completed within the hedge delay, a second copy of it is
+    /// sent. The first successful response is passed to the callback and the other copy is cancelled; an error
+    /// is passed only if no copy succeeds. Only idempotent methods (GET, HEAD, OPTIONS) are hedged.
+    ///
+    /// The delay is `delay_ms` if set, otherwise the `percentile` of the latencies recently observed for the
+    /// host of the request. A host is not hedged until `min_samples` latencies have been observed. Hedges are
+    /// limited per host to `budget_ratio` of the requests sent to it.
+    class HttpHedgePolicy {
+    public:
+        long        delay_ms     = 0;    ///< Fixed hedge delay in milliseconds; 0 uses the observed latency percentile.
+        double      percentile   = 0.95; ///< Latency percentile of the host used as the hedge delay.
+        long        min_delay_ms = 5;    ///< Lower bound of the hedge delay, in milliseconds.
+        std::size_t min_samples  = 20;   ///< Latencies needed before the percentile is used.
+        double      budget_ratio = 0.05; ///< Average number of hedges allowed per request sent to a host.
+    }; // HttpHedgePolicy
+
+    /// \brief Shared pointer to a hedge policy; one policy may be used by many requests.
+    using HttpHedgePolicyPtr = std::shared_ptr<HttpHedgePolicy>;
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_HEDGE_POLICY_HPP_INCLUDED
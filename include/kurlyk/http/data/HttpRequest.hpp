@@ -7,6 +7,10 @@
 
 namespace kurlyk {
 
+    class HttpRetryPolicy;
+    class HttpHedgePolicy;
+    class HttpCircuitBreakerPolicy;
+
     /// \class HttpRequest
     /// \brief Represents an HTTP request.
     ///
@@ -42,11 +46,23 @@ namespace kurlyk {
 
         long timeout         = 30;       ///< Request timeout in seconds.
         long connect_timeout = 10;       ///< Connection timeout in seconds.
+        std::chrono::steady_clock::time_point deadline{}; ///< Time after which the request is no longer sent or retried; unset if default-constructed.
+        long deadline_ms     = 0;        ///< Deadline relative to submission in milliseconds, used when `deadline` is unset; 0 means none.
         long general_rate_limit_id  = 0; ///< ID for general rate limiting.
         long specific_rate_limit_id = 0; ///< ID for specific rate limiting.
+        std::vector<long> rate_limit_ids; ///< Additional rate limit IDs applied together with the general and specific ones.
+        long rate_limit_weight      = 1; ///< Units of each rate limit budget consumed by the request.
+        RequestPriority priority = RequestPriority::RP_NORMAL; ///< Order in which requests waiting for the same rate limits are sent.
         std::set<long> valid_statuses = {200}; ///< Set of valid HTTP response status codes.
         long retry_attempts = 0;         ///< Number of retry attempts in case of failure.
         long retry_delay_ms = 0;         ///< Delay between retry attempts in milliseconds.
+        std::shared_ptr<HttpRetryPolicy> retry_policy; ///< Retry policy replacing retry_attempts and retry_delay_ms, if set.
+        std::shared_ptr<HttpHedgePolicy> hedge_policy; ///< Policy sending a second copy of a slow idempotent request, if set.
+        std::shared_ptr<HttpCircuitBreakerPolicy> circuit_breaker; ///< Policy failing the request fast while its host is failing, if set.
+        std::string shard_key;           ///< Key selecting the HTTP worker shard; if empty, the URL origin is used.
+        std::vector<std::string> tags;   ///< Tags grouping the request for kurlyk::cancel_requests_by_tag(), e.g. a strategy or symbol.
+        bool coalesce = false;           ///< Share the transfer of an identical request already in flight instead of sending a new one.
+        bool use_cache = false;          ///< Serve GET requests from the HTTP response cache and store their responses in it.
 
         bool clear_cookie_file = false;  ///< Flag to clear the cookie file at the start of the request.
 
@@ -212,6 +228,30 @@ namespace kurlyk {
             this->retry_delay_ms = retry_delay_ms;
         }
         
+        /// \brief Adds a rate limit applied to the request together with the general and specific ones.
+        /// \param limit_id ID of a limit created by kurlyk::create_rate_limit().
+        void add_rate_limit_id(long limit_id) {
+            rate_limit_ids.push_back(limit_id);
+        }
+
+        /// \brief Sets the weight of the request for rate limiting.
+        /// \param weight Units of each rate limit budget consumed by the request.
+        void set_rate_limit_weight(long weight) {
+            rate_limit_weight = weight;
+        }
+
+        /// \brief Sets the priority of the request while it waits for its rate limits.
+        /// \param value Priority class of the request.
+        void set_priority(RequestPriority value) {
+            priority = value;
+        }
+
+        /// \brief Sets the key used to route the request to an HTTP worker shard.
+        /// \param key Requests with the same key are executed by the same shard, in submission order.
+        void set_shard_key(const std::string& key) {
+            shard_key = key;
+        }
+
         /// \brief Adds a single valid HTTP status code.
         /// \param status The HTTP status code to add to the set of valid statuses.
         void add_valid_status(long status) {
@@ -259,6 +299,70 @@ namespace kurlyk {
             this->timeout = timeout;
         }
 
+        /// \brief Sets the retry policy, which replaces retry_attempts and retry_delay_ms.
+        /// \param policy Policy deciding whether and when the request is retried; nullptr restores the fixed retries.
+        void set_retry_policy(std::shared_ptr<HttpRetryPolicy> policy) {
+            retry_policy = std::move(policy);
+        }
+
+        /// \brief Sets the hedge policy of the request.
+        /// \param policy Policy deciding when a second copy of the request is sent; nullptr disables hedging.
+        void set_hedge_policy(std::shared_ptr<HttpHedgePolicy> policy) {
+            hedge_policy = std::move(policy);
+        }
+
+        /// \brief Sets the tags of the request, replacing the previous ones.
+        /// \param tags Tags grouping the request for cancellation.
+        void set_tags(std::vector<std::string> tags) {
+            this->tags = std::move(tags);
+        }
+
+        /// \brief Adds a tag to the request.
+        /// \param tag Tag grouping the request for cancellation.
+        void add_tag(const std::string& tag) {
+            tags.push_back(tag);
+        }
+
+        /// \brief Sets the circuit breaker policy of the request.
+        /// \param policy Policy deciding when requests to the host of the request fail fast; nullptr disables it.
+        void set_circuit_breaker(std::shared_ptr<HttpCircuitBreakerPolicy> policy) {
+            circuit_breaker = std::move(policy);
+        }
+
+        /// \brief Enables or disables single-flight coalescing of the request.
+        ///
+        /// A coalesced request with the same method, URL, headers, body, cookie, user agent and accept encoding
+        /// as a coalesced request already in flight does not start a transfer of its own; it receives a copy of
+        /// the responses of that transfer, which keeps the retry and rate-limit settings of the first request.
+        /// \param enable True to share in-flight transfers.
+        void set_coalesce(bool enable) {
+            coalesce = enable;
+        }
+
+        /// \brief Enables or disables the HTTP response cache for the request.
+        ///
+        /// A fresh cached response to a GET request is returned without a transfer; a stale one is revalidated
+        /// with `If-None-Match` / `If-Modified-Since`, and a `304 Not Modified` answer returns the cached body.
+        /// \param enable True to use the cache.
+        void set_use_cache(bool enable) {
+            use_cache = enable;
+        }
+
+        /// \brief Sets an absolute deadline for the request.
+        ///
+        /// A request still waiting for its rate limits or for a retry at the deadline is completed with
+        /// utils::ClientError::DeadlineExceeded without being sent, and no retry is scheduled past it.
+        /// \param time Time after which the request is no longer sent or retried.
+        void set_deadline(std::chrono::steady_clock::time_point time) {
+            deadline = time;
+        }
+
+        /// \brief Sets a deadline relative to the moment the request is submitted.
+        /// \param ms Milliseconds after submission after which the request is no longer sent or retried; 0 disables it.
+        void set_deadline_ms(long ms) {
+            deadline_ms = ms;
+        }
+
         /// \brief Sets the connection timeout.
         /// \param connect_timeout Connection timeout in seconds.
         void set_connect_timeout(long connect_timeout) {
@@ -0,0 +1,101 @@
+#pragma once
+#ifndef _KURLYK_HTTP_RETRY_POLICY_HPP_INCLUDED
+#define _KURLYK_HTTP_RETRY_POLICY_HPP_INCLUDED
+
+/// \file HttpRetryPolicy.hpp
+/// \brief Defines HttpRetryPolicy, which decides whether and when a failed HTTP request is retried.
+
+#include <cmath>
+#include <random>
+
+namespace kurlyk {
+
+    /// \class HttpRetryPolicy
+    /// \brief Retry policy with error classification, exponential backoff, jitter and a per-host retry budget.
+    ///
+    /// When a request has a policy (see HttpRequest::set_retry_policy()), it replaces the fixed
+    /// `retry_attempts` / `retry_delay_ms` behavior. A response with a status in `valid_statuses` is never
+    /// retried; otherwise the request is retried only if should_retry() accepts the error, fewer than
+    /// `max_attempts` attempts were made, the retry would start before the request deadline, and the
+    /// retry budget of the host allows it.
+    ///
+    /// The delay before attempt `n + 1` is `min(max_delay_ms, base_delay_ms * multiplier^(n - 1))`, of which
+    /// the fraction `jitter` is randomized so that clients do not retry in lockstep. A `Retry-After` header
+    /// raises the delay when `honor_retry_after` is set.
+    ///
+    /// The methods are virtual, so a derived policy can classify errors or compute delays differently.
+    class HttpRetryPolicy {
+    public:
+        long   max_attempts  = 3;      ///< Maximum number of attempts, including the first one.
+        long   base_delay_ms = 100;    ///< Delay before the first retry, in milliseconds.
+        long   max_delay_ms  = 10000;  ///< Upper bound of the delay, in milliseconds.
+        double multiplier    = 2.0;    ///< Growth factor of the delay between consecutive retries.
+        double jitter        = 1.0;    ///< Fraction of the delay that is randomized: 1.0 is "full jitter", 0.0 disables it.
+        bool   honor_retry_after = true; ///< Never retry earlier than the `Retry-After` response header allows.
+
+        /// \brief HTTP statuses that are retried.
+        std::set<long> retry_statuses = {408, 425, 429, 500, 502, 503, 504};
+
+        /// \brief libcurl errors that are retried; transient network failures by default.
+        std::set<CURLcode> retry_curl_errors = {
+            CURLE_COULDNT_RESOLVE_HOST,
+            CURLE_COULDNT_CONNECT,
+            CURLE_OPERATION_TIMEDOUT,
+            CURLE_SEND_ERROR,
+            CURLE_RECV_ERROR,
+            CURLE_GOT_NOTHING,
+            CURLE_PARTIAL_FILE,
+            CURLE_SSL_CONNECT_ERROR,
+            CURLE_HTTP2,
+            CURLE_HTTP2_STREAM
+        };
+
+        /// \brief Average number of retries allowed per request sent to a host; 0 disables the budget.
+        ///
+        /// Each completed first attempt deposits `retry_budget_ratio` tokens into the budget of its host and
+        /// each retry withdraws one, so during an outage retries stay a bounded fraction of the traffic.
+        double retry_budget_ratio = 0.2;
+        double retry_budget_min_per_second = 1.0; ///< Retries per second allowed to each host regardless of traffic.
+
+        virtual ~HttpRetryPolicy() = default;
+
+        /// \brief Classifies a failed attempt.
+        /// \param response Response of the attempt.
+        /// \param result libcurl result of the transfer.
+        /// \return True if the error is transient and the request may be retried.
+        virtual bool should_retry(const HttpResponse& response, CURLcode result) const {
+            if (result != CURLE_OK) return retry_curl_errors.count(result) != 0;
+            return retry_statuses.count(response.status_code) != 0;
+        }
+
+        /// \brief Computes the delay before the next attempt.
+        /// \param attempt Number of attempts made so far, starting at 1.
+        /// \param response Response of the last attempt.
+        /// \return Delay in milliseconds.
+        virtual long get_retry_delay_ms(long attempt, const HttpResponse& response) const {
+            double delay_ms = static_cast<double>(base_delay_ms) * std::pow(multiplier, static_cast<double>(std::max(attempt - 1, 0L)));
+            delay_ms = std::min(delay_ms, static_cast<double>(max_delay_ms));
+            if (jitter > 0.0) {
+                thread_local std::mt19937 generator{std::random_device{}()};
+                std::uniform_real_distribution<double> distribution(0.0, std::min(jitter, 1.0));
+                delay_ms -= delay_ms * distribution(generator);
+            }
+            long result = static_cast<long>(delay_ms);
+            if (honor_retry_after) {
+                const auto now = std::chrono::steady_clock::now();
+                RateLimitFeedback::time_point_t retry_time;
+                if (RateLimitFeedback::parse_retry_after(response.headers, now, retry_time) && retry_time > now) {
+                    const auto retry_after_ms = std::chrono::duration_cast<std::chrono::milliseconds>(retry_time - now).count();
+                    result = std::max(result, static_cast<long>(retry_after_ms));
+                }
+            }
+            return result;
+        }
+    }; // HttpRetryPolicy
+
+    /// \brief Shared pointer to a retry policy; one policy may be used by many requests.
+    using HttpRetryPolicyPtr = std::shared_ptr<HttpRetryPolicy>;
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_RETRY_POLICY_HPP_INCLUDED
@@ -0,0 +1,112 @@
+#pragma once
+#ifndef _KURLYK_HTTP_RATE_LIMIT_FEEDBACK_HPP_INCLUDED
+#define _KURLYK_HTTP_RATE_LIMIT_FEEDBACK_HPP_INCLUDED
+
+/// \file RateLimitFeedback.hpp
+/// \brief Defines RateLimitFeedback, the mapping of server rate limit headers onto a local rate limit.
+
+namespace kurlyk {
+
+    /// \class RateLimitFeedback
+    /// \brief Describes which response headers report the server-side state of a rate limit.
+    ///
+    /// When attached to a limit (see kurlyk::set_rate_limit_feedback()), every response of a request
+    /// using that limit updates it: the remaining quota replaces the locally counted one, so the limit
+    /// tightens or relaxes to match the server, and a response with one of `pause_statuses` pauses the
+    /// limit until the time given by `Retry-After` (or for one period if the header is missing).
+    class RateLimitFeedback {
+    public:
+        using time_point_t = std::chrono::steady_clock::time_point;
+
+        std::string remaining_header;     ///< Header with the remaining quota, e.g. "X-RateLimit-Remaining" or "X-Bapi-Limit-Status".
+        std::string used_header;          ///< Header with the consumed quota, e.g. "X-MBX-USED-WEIGHT-1M"; used when remaining_header is absent.
+        std::string reset_header;         ///< Header with the reset time of the server window, e.g. "X-RateLimit-Reset".
+        RateLimitResetFormat reset_format = RateLimitResetFormat::RL_RESET_DELTA_SECONDS; ///< Format of reset_header.
+        std::set<long> pause_statuses = {429}; ///< Status codes that pause the limit until `Retry-After`.
+
+        /// \brief Reads the remaining quota from response headers.
+        /// \param headers Response headers.
+        /// \param requests_per_period Budget of the local limit, used to convert `used_header`.
+        /// \param remaining Receives the remaining quota.
+        /// \return True if one of the quota headers is present and valid.
+        bool parse_remaining(const Headers& headers, long requests_per_period, long& remaining) const {
+            long value = 0;
+            if (!remaining_header.empty() && parse_long(headers, remaining_header, value)) {
+                remaining = value;
+                return true;
+            }
+            if (!used_header.empty() && parse_long(headers, used_header, value)) {
+                remaining = requests_per_period - value;
+                return true;
+            }
+            return false;
+        }
+
+        /// \brief Reads the reset time of the server window from response headers.
+        /// \param headers Response headers.
+        /// \param now Current time.
+        /// \param reset_time Receives the reset time.
+        /// \return True if the reset header is present and valid.
+        bool parse_reset_time(const Headers& headers, time_point_t now, time_point_t& reset_time) const {
+            long value = 0;
+            if (reset_header.empty() || !parse_long(headers, reset_header, value)) return false;
+            switch (reset_format) {
+            case RateLimitResetFormat::RL_RESET_DELTA_SECONDS:
+                reset_time = now + std::chrono::seconds(value);
+                return true;
+            case RateLimitResetFormat::RL_RESET_UNIX_SECONDS:
+                reset_time = from_unix_ms(static_cast<int64_t>(value) * 1000, now);
+                return true;
+            case RateLimitResetFormat::RL_RESET_UNIX_MS:
+                reset_time = from_unix_ms(value, now);
+                return true;
+            }
+            return false;
+        }
+
+        /// \brief Reads the `Retry-After` header, given either in seconds or as an HTTP date.
+        /// \param headers Response headers.
+        /// \param now Current time.
+        /// \param retry_time Receives the time after which requests may be sent again.
+        /// \return True if the header is present and valid.
+        static bool parse_retry_after(const Headers& headers, time_point_t now, time_point_t& retry_time) {
+            auto it = headers.find("Retry-After");
+            if (it == headers.end()) return false;
+            char* end = nullptr;
+            const long seconds = std::strtol(it->second.c_str(), &end, 10);
+            if (end != it->second.c_str() && *end == '\0') {
+                retry_time = now + std::chrono::seconds(std::max(seconds, 0L));
+                return true;
+            }
+#           if KURLYK_HTTP_SUPPORT
+            const time_t date = curl_getdate(it->second.c_str(), nullptr);
+            if (date < 0) return false;
+            retry_time = from_unix_ms(static_cast<int64_t>(date) * 1000, now);
+            return true;
+#           else
+            return false;
+#           endif
+        }
+
+    private:
+
+        /// \brief Parses an integer header value.
+        static bool parse_long(const Headers& headers, const std::string& name, long& value) {
+            auto it = headers.find(name);
+            if (it == headers.end() || it->second.empty()) return false;
+            char* end = nullptr;
+            value = std::strtol(it->second.c_str(), &end, 10);
+            return end != it->second.c_str();
+        }
+
+        /// \brief Converts a Unix time in milliseconds to a steady clock time point.
+        static time_point_t from_unix_ms(int64_t unix_ms, time_point_t now) {
+            const int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            return now + std::chrono::milliseconds(unix_ms - now_ms);
+        }
+    }; // RateLimitFeedback
+
+} // namespace kurlyk
+
+#endif // _KURLYK_HTTP_RATE_LIMIT_FEEDBACK_HPP_INCLUDED
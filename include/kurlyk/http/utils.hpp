@@ -12,9 +12,15 @@ namespace kurlyk {
     /// \brief Creates a rate limit with specified parameters.
     /// \param requests_per_period Maximum number of requests allowed within the specified period.
     /// \param period_ms Time period in milliseconds for the rate limit.
+    /// \param algorithm Algorithm enforcing the limit.
+    /// \param burst Requests allowed back to back by RateLimitAlgorithm::RL_GCRA.
     /// \return A unique identifier for the created rate limit.
-    inline long create_rate_limit(long requests_per_period, long period_ms) {
-        return HttpRequestManager::get_instance().create_rate_limit(requests_per_period, period_ms);
+    inline long create_rate_limit(
+            long requests_per_period,
+            long period_ms,
+            RateLimitAlgorithm algorithm = RateLimitAlgorithm::RL_FIXED_WINDOW,
+            long burst = 1) {
+        return HttpRequestManager::get_instance().create_rate_limit(requests_per_period, period_ms, algorithm, burst);
     }
 
     /// \brief Creates a rate limit based on Requests Per Minute (RPM).
@@ -40,12 +46,64 @@ namespace kurlyk {
         return HttpRequestManager::get_instance().remove_limit(limit_id);
     }
 
+    /// \brief Makes a rate limit follow the quota reported in server response headers.
+    ///
+    /// Every response of a request using the limit updates it: the remaining quota replaces the locally
+    /// counted one, and a response with one of `feedback.pause_statuses` pauses the limit until `Retry-After`.
+    /// \param limit_id The unique identifier of the rate limit.
+    /// \param feedback Mapping of response headers onto the limit.
+    /// \return True if the feedback was set, or false if the rate limit ID was not found.
+    inline bool set_rate_limit_feedback(long limit_id, RateLimitFeedback feedback) {
+        return HttpRequestManager::get_instance().set_rate_limit_feedback(limit_id, std::move(feedback));
+    }
+
+    /// \brief Stops a rate limit from following server response headers.
+    /// \param limit_id The unique identifier of the rate limit.
+    /// \return True if the feedback was removed, or false if none was set.
+    inline bool remove_rate_limit_feedback(long limit_id) {
+        return HttpRequestManager::get_instance().remove_rate_limit_feedback(limit_id);
+    }
+
+    /// \brief Sets the size limit of the HTTP response cache.
+    /// \param max_bytes Maximum total size of the cached responses; least recently used ones are evicted.
+    inline void set_http_cache_size(std::size_t max_bytes) {
+        HttpRequestManager::get_instance().set_response_cache_size(max_bytes);
+    }
+
+    /// \brief Keeps HTTP response cache entries on disk so they survive restarts.
+    ///
+    /// Entries are appended to memory-mapped segment files in `directory`; the oldest segment is deleted
+    /// when the files exceed `max_bytes`. After a restart, stale entries are revalidated instead of refetched.
+    /// Only one process at a time can use a directory.
+    /// \param directory Directory for the segment files; an empty string disables the disk tier.
+    /// \param max_bytes Maximum total size of the segment files.
+    /// \return True if the disk tier was opened or disabled, false if the directory could not be used,
+    /// e.g. because another process holds its lock.
+    inline bool set_http_disk_cache(
+            const std::string& directory,
+            std::size_t max_bytes = HttpDiskCache::DEFAULT_MAX_BYTES) {
+        return HttpRequestManager::get_instance().set_response_disk_cache(directory, max_bytes);
+    }
+
+    /// \brief Removes all responses from the HTTP response cache, including the ones on disk.
+    inline void clear_http_cache() {
+        HttpRequestManager::get_instance().clear_response_cache();
+    }
+
     /// \brief Generates a new unique request ID.
     /// \return A new unique request ID.
     inline uint64_t generate_request_id() {
         return HttpRequestManager::get_instance().generate_request_id();
     }
 
+    /// \brief Reloads the default CA bundle used by requests without `ca_file`.
+    /// \param path Path to the new bundle in UTF-8; if empty, the current bundle file is re-read.
+    /// \return True if the bundle was loaded, or false if the file could not be read (the previous bundle is kept).
+    /// \note Requests already in progress keep the bundle they were started with.
+    inline bool reload_ca_bundle(const std::string& path = std::string()) {
+        return HttpCaBundle::get_instance().reload(path);
+    }
+
     /// \brief Cancels a request by its unique identifier.
     /// \param request_id The unique identifier of the request to cancel.
     /// \param callback An optional callback function to execute after cancellation.
@@ -79,6 +137,28 @@ namespace kurlyk {
         return future;
     }
 
+    /// \brief Cancels every request in flight with a tag.
+    /// \param tag Tag set with HttpRequest::add_tag() or HttpClient::set_tags().
+    /// \param callback An optional callback function to execute after cancellation.
+    inline void cancel_requests_by_tag(const std::string& tag, std::function<void()> callback) {
+        HttpRequestManager::get_instance().cancel_requests_by_tag(tag, std::move(callback));
+        ::kurlyk::core::NetworkWorker::get_instance().notify();
+    }
+
+    /// \brief Cancels every request in flight with a tag and returns a future.
+    /// \param tag Tag set with HttpRequest::add_tag() or HttpClient::set_tags().
+    /// \return A `std::future<void>` that becomes ready when the cancellation process is complete.
+    inline std::future<void> cancel_requests_by_tag(const std::string& tag) {
+        auto promise = std::make_shared<std::promise<void>>();
+        auto future = promise->get_future();
+        cancel_requests_by_tag(tag, [promise](){
+            try {
+                promise->set_value();
+            } catch (...) {}
+        });
+        return future;
+    }
+
     /// \brief Sends an HTTP request with callback.
     /// \param request_ptr The HTTP request object with the request details.
     /// \param callback The callback function to be called upon request completion.
@@ -0,0 +1,28 @@
+#pragma once
+#ifndef _KURLYK_METRICS_HPP_INCLUDED
+#define _KURLYK_METRICS_HPP_INCLUDED
+
+/// \file metrics.hpp
+/// \brief Aggregates the metrics registry, metric types and the Prometheus serializer.
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+#include "metrics/Counter.hpp"
+#include "metrics/Gauge.hpp"
+#include "metrics/Histogram.hpp"
+#include "metrics/MetricsRegistry.hpp"
+#include "metrics/BuiltinMetrics.hpp"
+#include "metrics/prometheus.hpp"
+
+#endif // _KURLYK_METRICS_HPP_INCLUDED
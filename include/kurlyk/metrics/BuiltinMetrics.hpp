@@ -0,0 +1,88 @@
+#pragma once
+#ifndef _KURLYK_METRICS_BUILTIN_METRICS_HPP_INCLUDED
+#define _KURLYK_METRICS_BUILTIN_METRICS_HPP_INCLUDED
+
+/// \file BuiltinMetrics.hpp
+/// \brief Declares the metrics updated by the library itself.
+
+namespace kurlyk::metrics {
+
+    /// \struct BuiltinMetrics
+    /// \brief References to the metrics maintained by the network worker, HTTP and WebSocket modules.
+    ///
+    /// The metrics are registered in MetricsRegistry on first use, so they appear in snapshots and
+    /// in the Prometheus output alongside user-defined metrics.
+    struct BuiltinMetrics {
+        Histogram&  worker_loop_duration;   ///< Duration of a NetworkWorker processing iteration.
+
+        Counter&    http_requests;          ///< HTTP requests submitted.
+        Counter&    http_responses;         ///< HTTP requests completed with a final response.
+        Counter&    http_failures;          ///< HTTP requests completed with a transport or HTTP error.
+        Gauge&      http_pending;           ///< HTTP requests waiting in rate-limit queues.
+        Gauge&      http_active;            ///< HTTP requests being transferred.
+        Gauge&      http_retry_waiting;     ///< Failed HTTP requests waiting for their retry delay.
+        Counter&    http_retries;           ///< HTTP retry attempts scheduled.
+        Counter&    http_cancellations;     ///< HTTP requests cancelled by the user.
+        Counter&    http_throttled;         ///< Times a pending queue was blocked by a rate limit.
+        Counter&    http_deadline_exceeded; ///< HTTP requests dropped because their deadline passed before dispatch.
+        Counter&    http_retry_budget_exhausted; ///< HTTP retries skipped because the retry budget of the host was empty.
+        Counter&    http_hedges;            ///< Hedged copies of slow HTTP requests sent.
+        Counter&    http_hedge_wins;        ///< Hedged HTTP requests completed by the hedged copy.
+        Counter&    http_coalesced;         ///< HTTP requests attached to an identical transfer already in flight.
+        Counter&    http_cache_hits;        ///< HTTP requests answered from the response cache without a transfer.
+        Counter&    http_cache_revalidations; ///< Cached HTTP responses confirmed by a 304 Not Modified.
+        Counter&    http_cache_misses;      ///< Cacheable HTTP requests sent without a usable cached response.
+        Counter&    http_circuit_opened;    ///< Times the circuit breaker of a host opened.
+        Counter&    http_circuit_rejected;  ///< HTTP requests failed fast because the circuit of their host was open.
+        Histogram&  http_queue_wait;        ///< Time from queuing to dispatch, including rate-limit delays.
+        Histogram&  http_request_duration;  ///< libcurl total time of completed HTTP transfers.
+
+        Counter&    ws_messages_received;   ///< WebSocket messages received.
+        Counter&    ws_bytes_received;      ///< WebSocket payload bytes received.
+        Counter&    ws_messages_sent;       ///< WebSocket messages sent.
+        Counter&    ws_bytes_sent;          ///< WebSocket payload bytes sent.
+        Counter&    ws_reconnects;          ///< WebSocket reconnection attempts.
+
+        /// \brief Registers the built-in metrics.
+        /// \param registry Registry to register them in.
+        explicit BuiltinMetrics(MetricsRegistry& registry)
+            : worker_loop_duration(registry.histogram("kurlyk_worker_loop_duration_seconds", "Duration of a network worker processing iteration.")),
+              http_requests(registry.counter("kurlyk_http_requests_total", "HTTP requests submitted.")),
+              http_responses(registry.counter("kurlyk_http_responses_total", "HTTP requests completed with a final response.")),
+              http_failures(registry.counter("kurlyk_http_failures_total", "HTTP requests completed with a transport or HTTP error.")),
+              http_pending(registry.gauge("kurlyk_http_pending_requests", "HTTP requests waiting in rate-limit queues.")),
+              http_active(registry.gauge("kurlyk_http_active_requests", "HTTP requests being transferred.")),
+              http_retry_waiting(registry.gauge("kurlyk_http_retry_waiting_requests", "Failed HTTP requests waiting for their retry delay.")),
+              http_retries(registry.counter("kurlyk_http_retries_total", "HTTP retry attempts scheduled.")),
+              http_cancellations(registry.counter("kurlyk_http_cancellations_total", "HTTP requests cancelled by the user.")),
+              http_throttled(registry.counter("kurlyk_http_rate_limit_throttled_total", "Times a pending HTTP queue was blocked by a rate limit.")),
+              http_deadline_exceeded(registry.counter("kurlyk_http_deadline_exceeded_total", "HTTP requests dropped because their deadline passed before dispatch.")),
+              http_retry_budget_exhausted(registry.counter("kurlyk_http_retry_budget_exhausted_total", "HTTP retries skipped because the retry budget of the host was empty.")),
+              http_hedges(registry.counter("kurlyk_http_hedges_total", "Hedged copies of slow HTTP requests sent.")),
+              http_hedge_wins(registry.counter("kurlyk_http_hedge_wins_total", "Hedged HTTP requests completed by the hedged copy.")),
+              http_coalesced(registry.counter("kurlyk_http_coalesced_total", "HTTP requests attached to an identical transfer already in flight.")),
+              http_cache_hits(registry.counter("kurlyk_http_cache_hits_total", "HTTP requests answered from the response cache without a transfer.")),
+              http_cache_revalidations(registry.counter("kurlyk_http_cache_revalidations_total", "Cached HTTP responses confirmed by a 304 Not Modified.")),
+              http_cache_misses(registry.counter("kurlyk_http_cache_misses_total", "Cacheable HTTP requests sent without a usable cached response.")),
+              http_circuit_opened(registry.counter("kurlyk_http_circuit_opened_total", "Times the circuit breaker of a host opened.")),
+              http_circuit_rejected(registry.counter("kurlyk_http_circuit_rejected_total", "HTTP requests failed fast because the circuit breaker of their host was open.")),
+              http_queue_wait(registry.histogram("kurlyk_http_queue_wait_seconds", "Time from queuing an HTTP request to its dispatch.")),
+              http_request_duration(registry.histogram("kurlyk_http_request_duration_seconds", "Total time of completed HTTP transfers.")),
+              ws_messages_received(registry.counter("kurlyk_ws_messages_received_total", "WebSocket messages received.")),
+              ws_bytes_received(registry.counter("kurlyk_ws_received_bytes_total", "WebSocket payload bytes received.")),
+              ws_messages_sent(registry.counter("kurlyk_ws_messages_sent_total", "WebSocket messages sent.")),
+              ws_bytes_sent(registry.counter("kurlyk_ws_sent_bytes_total", "WebSocket payload bytes sent.")),
+              ws_reconnects(registry.counter("kurlyk_ws_reconnects_total", "WebSocket reconnection attempts.")) {
+        }
+    }; // BuiltinMetrics
+
+    /// \brief Returns the metrics maintained by the library.
+    /// \return Reference to the built-in metrics.
+    inline BuiltinMetrics& builtin() {
+        static BuiltinMetrics* metrics = new BuiltinMetrics(MetricsRegistry::get_instance());
+        return *metrics;
+    }
+
+} // namespace kurlyk::metrics
+
+#endif // _KURLYK_METRICS_BUILTIN_METRICS_HPP_INCLUDED
@@ -0,0 +1,35 @@
+#pragma once
+#ifndef _KURLYK_METRICS_COUNTER_HPP_INCLUDED
+#define _KURLYK_METRICS_COUNTER_HPP_INCLUDED
+
+/// \file Counter.hpp
+/// \brief Defines a monotonically increasing metric.
+
+namespace kurlyk::metrics {
+
+    /// \class Counter
+    /// \brief Monotonically increasing value, such as a number of requests.
+    ///
+    /// Updates are single relaxed atomic operations and are safe from any thread.
+    class Counter {
+    public:
+
+        /// \brief Increases the counter.
+        /// \param value Amount to add.
+        void inc(uint64_t value = 1) noexcept {
+            m_value.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        /// \brief Returns the current value.
+        /// \return Counter value.
+        uint64_t value() const noexcept {
+            return m_value.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<uint64_t> m_value = ATOMIC_VAR_INIT(0); ///< Current value.
+    }; // Counter
+
+} // namespace kurlyk::metrics
+
+#endif // _KURLYK_METRICS_COUNTER_HPP_INCLUDED
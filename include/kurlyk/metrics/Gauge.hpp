@@ -0,0 +1,47 @@
+#pragma once
+#ifndef _KURLYK_METRICS_GAUGE_HPP_INCLUDED
+#define _KURLYK_METRICS_GAUGE_HPP_INCLUDED
+
+/// \file Gauge.hpp
+/// \brief Defines a metric that can go up and down.
+
+namespace kurlyk::metrics {
+
+    /// \class Gauge
+    /// \brief Value that can go up and down, such as a queue depth.
+    ///
+    /// Updates are single relaxed atomic operations and are safe from any thread.
+    class Gauge {
+    public:
+
+        /// \brief Sets the gauge to a value.
+        /// \param value New value.
+        void set(int64_t value) noexcept {
+            m_value.store(value, std::memory_order_relaxed);
+        }
+
+        /// \brief Increases the gauge.
+        /// \param value Amount to add.
+        void inc(int64_t value = 1) noexcept {
+            m_value.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        /// \brief Decreases the gauge.
+        /// \param value Amount to subtract.
+        void dec(int64_t value = 1) noexcept {
+            m_value.fetch_sub(value, std::memory_order_relaxed);
+        }
+
+        /// \brief Returns the current value.
+        /// \return Gauge value.
+        int64_t value() const noexcept {
+            return m_value.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<int64_t> m_value = ATOMIC_VAR_INIT(0); ///< Current value.
+    }; // Gauge
+
+} // namespace kurlyk::metrics
+
+#endif // _KURLYK_METRICS_GAUGE_HPP_INCLUDED
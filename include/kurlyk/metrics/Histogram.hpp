@@ -0,0 +1,89 @@
+#pragma once
+#ifndef _KURLYK_METRICS_HISTOGRAM_HPP_INCLUDED
+#define _KURLYK_METRICS_HISTOGRAM_HPP_INCLUDED
+
+/// \file Histogram.hpp
+/// \brief Defines a metric counting observations in fixed buckets.
+
+namespace kurlyk::metrics {
+
+    /// \class Histogram
+    /// \brief Distribution of observed values, such as latencies in seconds.
+    ///
+    /// Bucket bounds are fixed at construction. Observing a value costs a short linear search
+    /// and two relaxed atomic updates, so it is safe and cheap from any thread.
+    class Histogram {
+    public:
+
+        /// \brief Returns the default bucket bounds for latencies in seconds (0.5 ms to 10 s).
+        /// \return Upper bounds of the buckets in ascending order.
+        static const std::vector<double>& default_buckets() {
+            static const std::vector<double> buckets = {
+                0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0
+            };
+            return buckets;
+        }
+
+        /// \brief Constructs a histogram with the specified bucket bounds.
+        /// \param bounds Upper bounds of the buckets in ascending order; an implicit +Inf bucket is added.
+        explicit Histogram(std::vector<double> bounds = default_buckets())
+            : m_bounds(std::move(bounds)),
+              m_counts(new std::atomic<uint64_t>[m_bounds.size() + 1]) {
+            for (std::size_t i = 0; i <= m_bounds.size(); ++i) {
+                m_counts[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        Histogram(const Histogram&) = delete;
+        Histogram& operator=(const Histogram&) = delete;
+
+        /// \brief Records an observation.
+        /// \param value Observed value.
+        void observe(double value) noexcept {
+            std::size_t index = 0;
+            while (index < m_bounds.size() && value > m_bounds[index]) ++index;
+            m_counts[index].fetch_add(1, std::memory_order_relaxed);
+            double sum = m_sum.load(std::memory_order_relaxed);
+            while (!m_sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {}
+        }
+
+        /// \brief Records a duration in seconds.
+        /// \param duration Observed duration.
+        template<class Rep, class Period>
+        void observe(std::chrono::duration<Rep, Period> duration) noexcept {
+            observe(std::chrono::duration_cast<std::chrono::duration<double>>(duration).count());
+        }
+
+        /// \brief Returns the upper bounds of the buckets, without the +Inf bucket.
+        /// \return Bucket bounds.
+        const std::vector<double>& bounds() const noexcept {
+            return m_bounds;
+        }
+
+        /// \brief Returns the cumulative number of observations for every bucket, including +Inf.
+        /// \return Cumulative counts; the last element is the total number of observations.
+        std::vector<uint64_t> cumulative_counts() const {
+            std::vector<uint64_t> counts(m_bounds.size() + 1);
+            uint64_t total = 0;
+            for (std::size_t i = 0; i <= m_bounds.size(); ++i) {
+                total += m_counts[i].load(std::memory_order_relaxed);
+                counts[i] = total;
+            }
+            return counts;
+        }
+
+        /// \brief Returns the sum of all observed values.
+        /// \return Sum of observations.
+        double sum() const noexcept {
+            return m_sum.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::vector<double>                         m_bounds;                     ///< Upper bounds of the buckets.
+        std::unique_ptr<std::atomic<uint64_t>[]>    m_counts;                     ///< Observations per bucket, including +Inf.
+        std::atomic<double>                         m_sum = ATOMIC_VAR_INIT(0.0); ///< Sum of all observed values.
+    }; // Histogram
+
+} // namespace kurlyk::metrics
+
+#endif // _KURLYK_METRICS_HISTOGRAM_HPP_INCLUDED
@@ -0,0 +1,169 @@
+#pragma once
+#ifndef _KURLYK_METRICS_REGISTRY_HPP_INCLUDED
+#define _KURLYK_METRICS_REGISTRY_HPP_INCLUDED
+
+/// \file MetricsRegistry.hpp
+/// \brief Defines the registry of named metrics and its snapshot types.
+
+namespace kurlyk::metrics {
+
+    /// \enum MetricType
+    /// \brief Kind of a metric family.
+    enum class MetricType {
+        Counter,    ///< Monotonically increasing value.
+        Gauge,      ///< Value that can go up and down.
+        Histogram   ///< Distribution of observations in buckets.
+    };
+
+    /// \struct MetricSample
+    /// \brief Point-in-time value of a single metric.
+    struct MetricSample {
+        std::string             name;       ///< Metric name, e.g. `kurlyk_http_retries_total`.
+        std::string             labels;     ///< Label set without braces, e.g. `method="GET"`; empty if none.
+        std::string             help;       ///< Description of the metric family.
+        MetricType              type = MetricType::Counter; ///< Kind of the metric.
+        double                  value = 0;  ///< Value of a counter or gauge.
+        std::vector<double>     bounds;     ///< Histogram bucket upper bounds, without +Inf.
+        std::vector<uint64_t>   counts;     ///< Cumulative histogram bucket counts, including +Inf.
+        double                  sum = 0;    ///< Sum of histogram observations.
+    };
+
+    /// \class MetricsRegistry
+    /// \brief Owns named metrics and produces snapshots of their values.
+    ///
+    /// Looking up a metric takes a mutex, so callers should keep the returned reference; references
+    /// stay valid for the lifetime of the program. Updating a metric never takes the mutex.
+    class MetricsRegistry {
+    public:
+
+        /// \brief Get the singleton instance of MetricsRegistry.
+        /// \return Reference to the singleton instance.
+        static MetricsRegistry& get_instance() {
+            static MetricsRegistry* instance = new MetricsRegistry();
+            return *instance;
+        }
+
+        /// \brief Returns a counter, creating it on first use.
+        /// \param name Metric name.
+        /// \param help Description used when the metric is created.
+        /// \param labels Label set without braces, e.g. `method="GET"`.
+        /// \return Reference to the counter.
+        /// \throws std::invalid_argument If the name is already used by a metric of another type.
+        Counter& counter(const std::string& name, const std::string& help = std::string(), const std::string& labels = std::string()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return get_metric(get_family(name, help, MetricType::Counter).counters, labels);
+        }
+
+        /// \brief Returns a gauge, creating it on first use.
+        /// \param name Metric name.
+        /// \param help Description used when the metric is created.
+        /// \param labels Label set without braces.
+        /// \return Reference to the gauge.
+        /// \throws std::invalid_argument If the name is already used by a metric of another type.
+        Gauge& gauge(const std::string& name, const std::string& help = std::string(), const std::string& labels = std::string()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return get_metric(get_family(name, help, MetricType::Gauge).gauges, labels);
+        }
+
+        /// \brief Returns a histogram, creating it on first use.
+        /// \param name Metric name.
+        /// \param help Description used when the metric is created.
+        /// \param labels Label set without braces.
+        /// \param bounds Bucket upper bounds used when the metric is created.
+        /// \return Reference to the histogram.
+        /// \throws std::invalid_argument If the name is already used by a metric of another type.
+        Histogram& histogram(
+                const std::string& name,
+                const std::string& help = std::string(),
+                const std::string& labels = std::string(),
+                const std::vector<double>& bounds = Histogram::default_buckets()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto& histograms = get_family(name, help, MetricType::Histogram).histograms;
+            auto it = histograms.find(labels);
+            if (it == histograms.end()) {
+                it = histograms.emplace(labels, std::unique_ptr<Histogram>(new Histogram(bounds))).first;
+            }
+            return *it->second;
+        }
+
+        /// \brief Captures the current values of all metrics.
+        /// \return Samples ordered by name and labels.
+        std::vector<MetricSample> snapshot() const {
+            std::vector<MetricSample> samples;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& item : m_families) {
+                const Family& family = item.second;
+                MetricSample sample;
+                sample.name = item.first;
+                sample.help = family.help;
+                sample.type = family.type;
+                for (const auto& metric : family.counters) {
+                    sample.labels = metric.first;
+                    sample.value = static_cast<double>(metric.second->value());
+                    samples.push_back(sample);
+                }
+                for (const auto& metric : family.gauges) {
+                    sample.labels = metric.first;
+                    sample.value = static_cast<double>(metric.second->value());
+                    samples.push_back(sample);
+                }
+                for (const auto& metric : family.histograms) {
+                    sample.labels = metric.first;
+                    sample.bounds = metric.second->bounds();
+                    sample.counts = metric.second->cumulative_counts();
+                    sample.sum = metric.second->sum();
+                    samples.push_back(sample);
+                }
+            }
+            return samples;
+        }
+
+    private:
+
+        /// \struct Family
+        /// \brief Metrics sharing a name, keyed by their label sets.
+        struct Family {
+            std::string                                         help;       ///< Description of the family.
+            MetricType                                          type;       ///< Kind of the metrics.
+            std::map<std::string, std::unique_ptr<Counter>>     counters;   ///< Counters by label set.
+            std::map<std::string, std::unique_ptr<Gauge>>       gauges;     ///< Gauges by label set.
+            std::map<std::string, std::unique_ptr<Histogram>>   histograms; ///< Histograms by label set.
+        };
+
+        mutable std::mutex              m_mutex;    ///< Mutex protecting m_families.
+        std::map<std::string, Family>   m_families; ///< Metric families by name.
+
+        MetricsRegistry() = default;
+        MetricsRegistry(const MetricsRegistry&) = delete;
+        MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+        /// \brief Returns a family, creating it on first use. Must be called with m_mutex held.
+        Family& get_family(const std::string& name, const std::string& help, MetricType type) {
+            auto it = m_families.find(name);
+            if (it == m_families.end()) {
+                Family family;
+                family.help = help;
+                family.type = type;
+                it = m_families.emplace(name, std::move(family)).first;
+            } else
+            if (it->second.type != type) {
+                throw std::invalid_argument("Metric '" + name + "' is already registered with another type");
+            }
+            return it->second;
+        }
+
+        /// \brief Returns a metric of a family, creating it on first use. Must be called with m_mutex held.
+        template<class T>
+        static T& get_metric(std::map<std::string, std::unique_ptr<T>>& metrics, const std::string& labels) {
+            auto it = metrics.find(labels);
+            if (it == metrics.end()) {
+                it = metrics.emplace(labels, std::unique_ptr<T>(new T())).first;
+            }
+            return *it->second;
+        }
+
+    }; // MetricsRegistry
+
+} // namespace kurlyk::metrics
+
+#endif // _KURLYK_METRICS_REGISTRY_HPP_INCLUDED
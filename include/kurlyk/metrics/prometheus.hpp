@@ -0,0 +1,70 @@
+#pragma once
+#ifndef _KURLYK_METRICS_PROMETHEUS_HPP_INCLUDED
+#define _KURLYK_METRICS_PROMETHEUS_HPP_INCLUDED
+
+/// \file prometheus.hpp
+/// \brief Serializes metric snapshots to the Prometheus text exposition format.
+
+namespace kurlyk::metrics {
+
+    /// \brief Formats a number for the Prometheus text format.
+    /// \param value Value to format.
+    /// \return Decimal representation, or `+Inf` / `-Inf` / `NaN`.
+    inline std::string format_prometheus_value(double value) {
+        if (value != value) return "NaN";
+        if (value == std::numeric_limits<double>::infinity()) return "+Inf";
+        if (value == -std::numeric_limits<double>::infinity()) return "-Inf";
+        std::ostringstream stream;
+        stream.imbue(std::locale::classic());
+        stream << std::setprecision(15) << value;
+        return stream.str();
+    }
+
+    /// \brief Serializes samples to the Prometheus text exposition format (version 0.0.4).
+    /// \param samples Samples, grouped by name as returned by MetricsRegistry::snapshot().
+    /// \return Text suitable for an HTTP `/metrics` endpoint.
+    inline std::string to_prometheus(const std::vector<MetricSample>& samples) {
+        std::string out;
+        const std::string* last_name = nullptr;
+        for (const auto& sample : samples) {
+            if (!last_name || *last_name != sample.name) {
+                if (!sample.help.empty()) {
+                    out += "# HELP " + sample.name + " " + sample.help + "\n";
+                }
+                out += "# TYPE " + sample.name + " ";
+                switch (sample.type) {
+                case MetricType::Counter:   out += "counter\n"; break;
+                case MetricType::Gauge:     out += "gauge\n"; break;
+                case MetricType::Histogram: out += "histogram\n"; break;
+                };
+                last_name = &sample.name;
+            }
+
+            const std::string labels = sample.labels.empty() ? std::string() : "{" + sample.labels + "}";
+            if (sample.type != MetricType::Histogram) {
+                out += sample.name + labels + " " + format_prometheus_value(sample.value) + "\n";
+                continue;
+            }
+
+            const std::string prefix = sample.labels.empty() ? std::string() : sample.labels + ",";
+            for (std::size_t i = 0; i < sample.counts.size(); ++i) {
+                const double bound = i < sample.bounds.size() ? sample.bounds[i] : std::numeric_limits<double>::infinity();
+                out += sample.name + "_bucket{" + prefix + "le=\"" + format_prometheus_value(bound) + "\"} " +
+                    std::to_string(sample.counts[i]) + "\n";
+            }
+            out += sample.name + "_sum" + labels + " " + format_prometheus_value(sample.sum) + "\n";
+            out += sample.name + "_count" + labels + " " +
+                std::to_string(sample.counts.empty() ? 0 : sample.counts.back()) + "\n";
+        }
+        return out;
+    }
+
+    /// \brief Serializes all metrics of the registry to the Prometheus text exposition format.
+    /// \return Text suitable for an HTTP `/metrics` endpoint.
+    inline std::string to_prometheus() {
+        return to_prometheus(MetricsRegistry::get_instance().snapshot());
+    }
+
+} // namespace kurlyk::metrics
+
+#endif // _KURLYK_METRICS_PROMETHEUS_HPP_INCLUDED
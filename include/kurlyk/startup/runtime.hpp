@@ -45,6 +45,15 @@ namespace kurlyk {
         ::kurlyk::core::NetworkWorker::get_instance().add_error_handler(std::move(handler));
     }
 
+    /// \brief Sets the executor running HTTP completion and WebSocket event callbacks.
+    ///
+    /// Callbacks of one HTTP client or WebSocket connection keep their order. Pass nullptr to run
+    /// callbacks on the network thread again.
+    /// \param executor Executor, for example a core::CallbackThreadPool.
+    inline void set_callback_executor(std::shared_ptr<::kurlyk::core::ICallbackExecutor> executor) {
+        ::kurlyk::core::NetworkWorker::get_instance().set_callback_executor(std::move(executor));
+    }
+
 } // namespace kurlyk
 
 #endif // _KURLYK_STARTUP_RUNTIME_HPP_INCLUDED
@@ -0,0 +1,29 @@
+#pragma once
+#ifndef _KURLYK_TRACING_HPP_INCLUDED
+#define _KURLYK_TRACING_HPP_INCLUDED
+
+/// \file tracing.hpp
+/// \brief Aggregates request lifecycle tracing and defines the tracing macros.
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+
+#include "tracing/Tracer.hpp"
+
+/// \def KURLYK_TRACE_STAGE
+/// \brief Records the stage of a request that ends now and starts the next one.
+///
+/// Expands to nothing unless KURLYK_ENABLE_TRACING is enabled; the arguments are not evaluated then.
+/// \param context HttpRequestContext of the request.
+/// \param name Stage name as a string literal.
+#if KURLYK_ENABLE_TRACING
+#   define KURLYK_TRACE_STAGE(context, name) (context).trace_stage(name)
+#else
+#   define KURLYK_TRACE_STAGE(context, name) ((void)0)
+#endif
+
+#endif // _KURLYK_TRACING_HPP_INCLUDED
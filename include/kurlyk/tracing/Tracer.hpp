@@ -0,0 +1,146 @@
+#pragma once
+#ifndef _KURLYK_TRACING_TRACER_HPP_INCLUDED
+#define _KURLYK_TRACING_TRACER_HPP_INCLUDED
+
+/// \file Tracer.hpp
+/// \brief Defines the ring buffer of request lifecycle spans and its Chrome trace export.
+
+namespace kurlyk::tracing {
+
+    /// \struct TraceSpan
+    /// \brief Time spent by a request in one stage of its lifecycle.
+    struct TraceSpan {
+        using time_point_t = std::chrono::steady_clock::time_point;
+
+        const char*     name = "";      ///< Stage name; must point to a string literal.
+        uint64_t        trace_id = 0;   ///< Identifier of the traced request submission.
+        time_point_t    start;          ///< Start of the stage.
+        time_point_t    end;            ///< End of the stage.
+        std::size_t     thread_hash = 0;///< Hash of the thread that recorded the span.
+    };
+
+    /// \class Tracer
+    /// \brief Keeps the most recent lifecycle spans in a fixed-size ring buffer.
+    ///
+    /// Recording a span copies a few words under a mutex and never allocates once the buffer
+    /// is full, so tracing can stay enabled under load. The oldest spans are overwritten.
+    class Tracer {
+    public:
+        using time_point_t = TraceSpan::time_point_t;
+
+        /// \brief Get the singleton instance of Tracer.
+        /// \return Reference to the singleton instance.
+        static Tracer& get_instance() {
+            static Tracer* instance = new Tracer(KURLYK_TRACE_BUFFER_SIZE);
+            return *instance;
+        }
+
+        /// \brief Generates an identifier for a new traced request submission.
+        /// \return Identifier, never 0.
+        uint64_t generate_trace_id() {
+            return m_trace_id_counter++;
+        }
+
+        /// \brief Records a span.
+        /// \param name Stage name; must point to a string literal.
+        /// \param trace_id Identifier of the traced request submission.
+        /// \param start Start of the stage.
+        /// \param end End of the stage.
+        void record(const char* name, uint64_t trace_id, time_point_t start, time_point_t end) {
+            TraceSpan span;
+            span.name = name;
+            span.trace_id = trace_id;
+            span.start = start;
+            span.end = end;
+            span.thread_hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_spans.size() < m_capacity) {
+                m_spans.push_back(span);
+                return;
+            }
+            if (m_spans.empty()) return;
+            m_spans[m_next] = span;
+            m_next = (m_next + 1) % m_spans.size();
+        }
+
+        /// \brief Returns the recorded spans, oldest first.
+        /// \return Copy of the ring buffer contents.
+        std::vector<TraceSpan> snapshot() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::vector<TraceSpan> spans;
+            spans.reserve(m_spans.size());
+            spans.insert(spans.end(), m_spans.begin() + m_next, m_spans.end());
+            spans.insert(spans.end(), m_spans.begin(), m_spans.begin() + m_next);
+            return spans;
+        }
+
+        /// \brief Removes all recorded spans.
+        void clear() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_spans.clear();
+            m_next = 0;
+        }
+
+        /// \brief Serializes the recorded spans to the Chrome trace event format.
+        ///
+        /// Every traced submission is shown as its own track (`tid` is the trace ID), so the stages
+        /// of a request appear side by side in `chrome://tracing` or Perfetto.
+        /// \return JSON document with a `traceEvents` array of complete (`"ph":"X"`) events.
+        std::string to_chrome_trace_json() const {
+            using namespace std::chrono;
+            const auto spans = snapshot();
+            std::string out = "{\"traceEvents\":[";
+            bool first = true;
+            for (const auto& span : spans) {
+                if (!first) out += ",";
+                first = false;
+                const long long ts = duration_cast<microseconds>(span.start - m_epoch).count();
+                const long long dur = duration_cast<microseconds>(span.end - span.start).count();
+                out += "{\"name\":\"";
+                out += span.name;
+                out += "\",\"cat\":\"kurlyk\",\"ph\":\"X\",\"pid\":1,\"tid\":" + std::to_string(span.trace_id) +
+                    ",\"ts\":" + std::to_string(ts) +
+                    ",\"dur\":" + std::to_string(dur < 0 ? 0 : dur) +
+                    ",\"args\":{\"thread\":" + std::to_string(span.thread_hash) + "}}";
+            }
+            out += "],\"displayTimeUnit\":\"ms\"}";
+            return out;
+        }
+
+    private:
+        mutable std::mutex      m_mutex;            ///< Mutex protecting the ring buffer.
+        std::vector<TraceSpan>  m_spans;            ///< Ring buffer of spans.
+        std::size_t             m_capacity;         ///< Maximum number of spans kept.
+        std::size_t             m_next = 0;         ///< Index of the oldest span once the buffer is full.
+        time_point_t            m_epoch;            ///< Time origin of exported timestamps.
+        std::atomic<uint64_t>   m_trace_id_counter = ATOMIC_VAR_INIT(1); ///< Counter for trace IDs.
+
+        /// \brief Constructs a tracer with the specified buffer capacity.
+        /// \param capacity Maximum number of spans kept.
+        explicit Tracer(std::size_t capacity)
+            : m_capacity(capacity), m_epoch(std::chrono::steady_clock::now()) {
+        }
+
+        Tracer(const Tracer&) = delete;
+        Tracer& operator=(const Tracer&) = delete;
+
+    }; // Tracer
+
+    /// \struct TraceDelivery
+    /// \brief Traced response being passed to the callbacks of its request on the current thread.
+    struct TraceDelivery {
+        uint64_t trace_id = 0;   ///< Trace ID of the request, or 0 outside a traced delivery.
+        bool     posted = false; ///< Set once the user callback has been posted to the callback executor.
+    };
+
+    /// \brief Returns the traced delivery of the current thread.
+    /// \return Reference to the thread-local delivery state.
+    inline TraceDelivery& current_delivery() {
+        thread_local TraceDelivery delivery;
+        return delivery;
+    }
+
+} // namespace kurlyk::tracing
+
+#endif // _KURLYK_TRACING_TRACER_HPP_INCLUDED
@@ -26,6 +26,34 @@ namespace kurlyk {
         RL_SPECIFIC  ///< Applies to specific client/request.
     };
 
+    /// \enum RateLimitAlgorithm
+    /// \brief Algorithms used to enforce a rate limit.
+    enum class RateLimitAlgorithm {
+        RL_FIXED_WINDOW, ///< Counts requests in consecutive windows; up to twice the limit may pass around a window boundary.
+        RL_GCRA          ///< Generic cell rate algorithm (token bucket); spaces requests evenly with a configurable burst.
+    };
+
+    /// \enum RequestPriority
+    /// \brief Priority classes of queued HTTP requests.
+    ///
+    /// When a rate limit frees capacity, the waiting request of the highest class goes first.
+    /// Requests of lower classes are promoted while they wait (see KURLYK_HTTP_PRIORITY_AGING_MS),
+    /// up to RP_HIGH, so they are never starved indefinitely.
+    enum class RequestPriority {
+        RP_LOW = 0,  ///< Background requests, e.g. bulk market data polls.
+        RP_NORMAL,   ///< Default priority.
+        RP_HIGH,     ///< Latency-sensitive requests.
+        RP_CRITICAL  ///< Requests that must go first, e.g. order cancellations; never overtaken by aged requests.
+    };
+
+    /// \enum RateLimitResetFormat
+    /// \brief Formats of the header reporting when a server-side rate limit resets.
+    enum class RateLimitResetFormat {
+        RL_RESET_DELTA_SECONDS,  ///< Seconds until the reset, e.g. `X-RateLimit-Reset: 30`.
+        RL_RESET_UNIX_SECONDS,   ///< Unix time of the reset in seconds.
+        RL_RESET_UNIX_MS         ///< Unix time of the reset in milliseconds, e.g. `X-Bapi-Limit-Reset-Timestamp`.
+    };
+
     /// \enum WebSocketEventType
     /// \brief Types of WebSocket events.
     enum class WebSocketEventType {
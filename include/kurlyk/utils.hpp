@@ -28,6 +28,8 @@
 #include "utils/HttpErrorCategory.hpp"
 
 #include "utils/EventQueue.hpp"
+#include "utils/MpscQueue.hpp"
+#include "utils/RateLimitState.hpp"
 #include "utils/CaseInsensitiveMultimap.hpp"
 
 #ifdef _WIN32
@@ -53,6 +55,10 @@
 #include "utils/user_agent_utils.hpp"
 #include "utils/print_utils.hpp"
 #include "utils/path_utils.hpp"
+#include "utils/file_utils.hpp"
+#include "utils/FileLock.hpp"
+#include "utils/MappedFile.hpp"
+#include "utils/sha256.hpp"
 #include "utils/encoding_utils.hpp"
 #include "utils/string_utils.hpp"
 
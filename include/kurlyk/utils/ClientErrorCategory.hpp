@@ -15,6 +15,8 @@ namespace kurlyk::utils {
         ClientNotInitialized,       ///< Operation attempted before client was properly initialized.
         InvalidConfiguration,       ///< Provided configuration is incomplete or invalid.
         NotConnected,               ///< Operation requires an active connection but none exists.
+        DeadlineExceeded,           ///< Request deadline passed before the request could be sent.
+        CircuitOpen,                ///< Request failed fast because the circuit breaker of its host is open.
     };
 
     /// \class ClientErrorCategory
@@ -37,6 +39,10 @@ namespace kurlyk::utils {
                     return "Invalid or missing client configuration";
                 case ClientError::NotConnected:
                     return "Operation failed: client is not connected";
+                case ClientError::DeadlineExceeded:
+                    return "Request deadline exceeded before it was sent";
+                case ClientError::CircuitOpen:
+                    return "Request rejected: circuit breaker of the host is open";
                 default:
                     return "Unknown HTTP client error";
             }
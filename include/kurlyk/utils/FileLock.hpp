@@ -0,0 +1,92 @@
+#pragma once
+#ifndef _KURLYK_UTILS_FILE_LOCK_HPP_INCLUDED
+#define _KURLYK_UTILS_FILE_LOCK_HPP_INCLUDED
+
+/// \file FileLock.hpp
+/// \brief Defines FileLock, an exclusive advisory lock on a file shared between processes.
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/file.h>
+#endif
+
+namespace kurlyk::utils {
+
+    /// \class FileLock
+    /// \brief Holds an exclusive lock on a file until destroyed.
+    ///
+    /// The lock is taken without waiting, so a second holder, in this or another process, fails instead of
+    /// blocking. The operating system releases the lock if the process exits. The file is created if it
+    /// does not exist, readable and writable by its owner only on POSIX systems.
+    class FileLock {
+    public:
+
+        FileLock() = default;
+
+        ~FileLock() {
+            unlock();
+        }
+
+        FileLock(const FileLock&) = delete;
+        FileLock& operator=(const FileLock&) = delete;
+
+        /// \brief Opens a file and locks it.
+        /// \param path Path of the file, in UTF-8.
+        /// \return True if the lock was taken; false if the file could not be opened or is locked elsewhere.
+        bool lock(const std::string& path) {
+            unlock();
+#           if defined(_WIN32)
+            m_file = CreateFileW(
+                utf8_to_wide(path).c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE) return false;
+            OVERLAPPED overlapped = {};
+            if (!LockFileEx(m_file, LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY, 0, 1, 0, &overlapped)) {
+                CloseHandle(m_file);
+                m_file = INVALID_HANDLE_VALUE;
+                return false;
+            }
+#           else
+            m_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0600);
+            if (m_fd < 0) return false;
+            if (flock(m_fd, LOCK_EX | LOCK_NB) != 0) {
+                ::close(m_fd);
+                m_fd = -1;
+                return false;
+            }
+#           endif
+            return true;
+        }
+
+        /// \brief Releases the lock and closes the file.
+        void unlock() {
+#           if defined(_WIN32)
+            if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+            m_file = INVALID_HANDLE_VALUE;
+#           else
+            if (m_fd >= 0) ::close(m_fd);
+            m_fd = -1;
+#           endif
+        }
+
+        /// \brief Checks whether the lock is held.
+        /// \return True if lock() succeeded and unlock() was not called since.
+        bool is_locked() const noexcept {
+#           if defined(_WIN32)
+            return m_file != INVALID_HANDLE_VALUE;
+#           else
+            return m_fd >= 0;
+#           endif
+        }
+
+    private:
+#       if defined(_WIN32)
+        HANDLE      m_file = INVALID_HANDLE_VALUE; ///< Handle of the locked file.
+#       else
+        int         m_fd = -1;                     ///< Descriptor of the locked file.
+#       endif
+    }; // FileLock
+
+} // namespace kurlyk::utils
+
+#endif // _KURLYK_UTILS_FILE_LOCK_HPP_INCLUDED
@@ -0,0 +1,130 @@
+#pragma once
+#ifndef _KURLYK_UTILS_MAPPED_FILE_HPP_INCLUDED
+#define _KURLYK_UTILS_MAPPED_FILE_HPP_INCLUDED
+
+/// \file MappedFile.hpp
+/// \brief Defines MappedFile, a file of fixed size mapped into memory for reading and writing.
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
+namespace kurlyk::utils {
+
+    /// \class MappedFile
+    /// \brief Maps a whole file into memory with read and write access.
+    ///
+    /// Writes to the mapping reach the file without explicit I/O calls. The file is created if it does not
+    /// exist, readable and writable by its owner only on POSIX systems, and extended to the requested size
+    /// if it is shorter.
+    class MappedFile {
+    public:
+
+        MappedFile() = default;
+
+        ~MappedFile() {
+            close();
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /// \brief Opens and maps a file.
+        /// \param path Path of the file, in UTF-8.
+        /// \param size Size of the mapping in bytes; the file is extended to it if needed.
+        /// \return True if the file was mapped.
+        bool open(const std::string& path, std::size_t size) {
+            close();
+            if (!size) return false;
+#           if defined(_WIN32)
+            m_file = CreateFileW(
+                utf8_to_wide(path).c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE) return false;
+            const auto size64 = static_cast<unsigned long long>(size);
+            m_mapping = CreateFileMappingW(
+                m_file, nullptr, PAGE_READWRITE,
+                static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64 & 0xFFFFFFFFULL), nullptr);
+            if (!m_mapping) {
+                close();
+                return false;
+            }
+            m_data = static_cast<char*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, size));
+            if (!m_data) {
+                close();
+                return false;
+            }
+#           else
+            m_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0600);
+            if (m_fd < 0) return false;
+            struct stat info;
+            if (fstat(m_fd, &info) != 0 ||
+                (static_cast<std::size_t>(info.st_size) < size && ftruncate(m_fd, static_cast<off_t>(size)) != 0)) {
+                close();
+                return false;
+            }
+            void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+            if (data == MAP_FAILED) {
+                close();
+                return false;
+            }
+            m_data = static_cast<char*>(data);
+#           endif
+            m_size = size;
+            return true;
+        }
+
+        /// \brief Unmaps and closes the file.
+        void close() {
+#           if defined(_WIN32)
+            if (m_data) UnmapViewOfFile(m_data);
+            if (m_mapping) CloseHandle(m_mapping);
+            if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+            m_mapping = nullptr;
+            m_file = INVALID_HANDLE_VALUE;
+#           else
+            if (m_data) munmap(m_data, m_size);
+            if (m_fd >= 0) ::close(m_fd);
+            m_fd = -1;
+#           endif
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+        /// \brief Starts writing modified pages to the file without waiting for completion.
+        void flush_async() {
+            if (!m_data) return;
+#           if defined(_WIN32)
+            FlushViewOfFile(m_data, 0);
+#           else
+            msync(m_data, m_size, MS_ASYNC);
+#           endif
+        }
+
+        /// \brief Returns the mapped memory.
+        /// \return Pointer to the first byte, or nullptr if the file is not mapped.
+        char* data() const noexcept { return m_data; }
+
+        /// \brief Returns the size of the mapping.
+        /// \return Size in bytes.
+        std::size_t size() const noexcept { return m_size; }
+
+        /// \brief Checks whether the file is mapped.
+        /// \return True if the mapping is valid.
+        bool is_open() const noexcept { return m_data != nullptr; }
+
+    private:
+        char*       m_data = nullptr; ///< Mapped memory.
+        std::size_t m_size = 0;       ///< Size of the mapping.
+#       if defined(_WIN32)
+        HANDLE      m_file = INVALID_HANDLE_VALUE; ///< File handle.
+        HANDLE      m_mapping = nullptr;           ///< File mapping handle.
+#       else
+        int         m_fd = -1;        ///< File descriptor.
+#       endif
+    }; // MappedFile
+
+} // namespace kurlyk::utils
+
+#endif // _KURLYK_UTILS_MAPPED_FILE_HPP_INCLUDED
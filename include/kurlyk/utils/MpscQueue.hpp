@@ -0,0 +1,101 @@
+#pragma once
+#ifndef _KURLYK_MPSC_QUEUE_HPP_INCLUDED
+#define _KURLYK_MPSC_QUEUE_HPP_INCLUDED
+
+/// \file MpscQueue.hpp
+/// \brief Defines an intrusive lock-free multi-producer/single-consumer queue.
+
+#include <atomic>
+#include <memory>
+
+namespace kurlyk::utils {
+
+    /// \struct MpscQueueNode
+    /// \brief Link embedded in every element stored in an MpscQueue.
+    struct MpscQueueNode {
+        std::atomic<MpscQueueNode*> mpsc_next = ATOMIC_VAR_INIT(nullptr); ///< Next node in the queue.
+
+        MpscQueueNode() = default;
+        MpscQueueNode(const MpscQueueNode&) : mpsc_next(nullptr) {}
+        MpscQueueNode& operator=(const MpscQueueNode&) { return *this; }
+    };
+
+    /// \class MpscQueue
+    /// \brief Intrusive lock-free multi-producer/single-consumer queue (Vyukov's algorithm).
+    ///
+    /// Any thread may call push(); it costs one atomic exchange and never blocks or allocates.
+    /// Only one thread at a time may call pop(). Elements are owned by the queue while queued,
+    /// and any elements left in it are deleted on destruction.
+    /// \tparam T Element type; must derive from MpscQueueNode.
+    template<class T>
+    class MpscQueue {
+    public:
+
+        MpscQueue() : m_head(&m_stub), m_tail(&m_stub) {}
+
+        ~MpscQueue() {
+            while (pop()) {}
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        /// \brief Adds an element to the queue. Safe to call from any thread.
+        /// \param item Element to enqueue; ignored if null.
+        void push(std::unique_ptr<T> item) noexcept {
+            if (!item) return;
+            m_size.fetch_add(1, std::memory_order_relaxed);
+            push_node(item.release());
+        }
+
+        /// \brief Removes the oldest element. Must only be called by the consumer thread.
+        /// \return The element, or nullptr if the queue is empty or a producer has not finished linking its element yet.
+        std::unique_ptr<T> pop() noexcept {
+            MpscQueueNode* tail = m_tail;
+            MpscQueueNode* next = tail->mpsc_next.load(std::memory_order_acquire);
+            if (tail == &m_stub) {
+                if (!next) return nullptr;
+                m_tail = next;
+                tail = next;
+                next = next->mpsc_next.load(std::memory_order_acquire);
+            }
+            if (!next) {
+                if (tail != m_head.load(std::memory_order_acquire)) return nullptr;
+                push_node(&m_stub);
+                next = tail->mpsc_next.load(std::memory_order_acquire);
+                if (!next) return nullptr;
+            }
+            m_tail = next;
+            m_size.fetch_sub(1, std::memory_order_relaxed);
+            return std::unique_ptr<T>(static_cast<T*>(tail));
+        }
+
+        /// \brief Returns the number of queued elements, including ones still being linked by producers.
+        /// \return Approximate number of elements.
+        std::size_t size() const noexcept {
+            return m_size.load(std::memory_order_relaxed);
+        }
+
+        /// \brief Checks whether the queue is empty.
+        /// \return True if no elements are queued.
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+    private:
+        MpscQueueNode               m_stub;                      ///< Sentinel node; never returned by pop().
+        std::atomic<MpscQueueNode*> m_head;                      ///< Most recently pushed node (producers side).
+        MpscQueueNode*              m_tail;                      ///< Oldest node (consumer side).
+        std::atomic<std::size_t>    m_size = ATOMIC_VAR_INIT(0); ///< Number of queued elements.
+
+        /// \brief Links a node at the head of the queue.
+        void push_node(MpscQueueNode* node) noexcept {
+            node->mpsc_next.store(nullptr, std::memory_order_relaxed);
+            MpscQueueNode* prev = m_head.exchange(node, std::memory_order_acq_rel);
+            prev->mpsc_next.store(node, std::memory_order_release);
+        }
+    };
+
+} // namespace kurlyk::utils
+
+#endif // _KURLYK_MPSC_QUEUE_HPP_INCLUDED
@@ -0,0 +1,172 @@
+#pragma once
+#ifndef _KURLYK_UTILS_RATE_LIMIT_STATE_HPP_INCLUDED
+#define _KURLYK_UTILS_RATE_LIMIT_STATE_HPP_INCLUDED
+
+/// \file RateLimitState.hpp
+/// \brief Defines the state of a single rate limit shared by the HTTP and WebSocket rate limiters.
+
+namespace kurlyk::utils {
+
+    /// \class RateLimitState
+    /// \brief Tracks a single rate limit using a fixed window or the generic cell rate algorithm.
+    ///
+    /// With RL_GCRA the limit keeps a theoretical arrival time (TAT). Each request advances it by
+    /// the emission interval `period / requests_per_period`, and a request is allowed once
+    /// `now >= TAT - (burst - 1) * interval`. With a burst of 1 requests are evenly spaced and no
+    /// window of length `period` ever contains more than `requests_per_period` requests; a larger
+    /// burst lets up to `burst` requests pass back to back after an idle period, at the cost of up
+    /// to `burst - 1` extra requests in a window.
+    ///
+    /// Every request carries a weight (1 by default) and consumes that many units of the budget:
+    /// a fixed window admits requests while the consumed weight fits in `requests_per_period`,
+    /// and RL_GCRA advances the TAT by `weight * interval`. Weights larger than the budget are
+    /// charged the full budget so that such requests are delayed rather than blocked forever.
+    ///
+    /// The state can also be corrected from outside: set_remaining() replaces the local count with
+    /// the quota reported by a server, and pause_until() blocks the limit until a given time.
+    ///
+    /// The class is not thread-safe; the owning limiter serializes access.
+    class RateLimitState {
+    public:
+        using clock_t      = std::chrono::steady_clock;
+        using time_point_t = clock_t::time_point;
+        using duration_t   = clock_t::duration;
+
+        long                requests_per_period = 0; ///< Maximum requests allowed per period; 0 means unlimited.
+        long                period_ms = 0;           ///< Duration of the period in milliseconds.
+        RateLimitAlgorithm  algorithm = RateLimitAlgorithm::RL_FIXED_WINDOW; ///< Algorithm enforcing the limit.
+        long                burst = 1;               ///< Requests allowed back to back by RL_GCRA; at least 1.
+
+        RateLimitState() = default;
+
+        /// \brief Constructs the state of a rate limit.
+        /// \param requests_per_period Maximum number of requests allowed within the period. 0 means no limit.
+        /// \param period_ms Duration of the period in milliseconds.
+        /// \param algorithm Algorithm enforcing the limit.
+        /// \param burst Requests allowed back to back by RL_GCRA; values below 1 are treated as 1.
+        /// \param now Current time.
+        RateLimitState(
+                long requests_per_period,
+                long period_ms,
+                RateLimitAlgorithm algorithm = RateLimitAlgorithm::RL_FIXED_WINDOW,
+                long burst = 1,
+                time_point_t now = clock_t::now())
+            : requests_per_period(requests_per_period),
+              period_ms(period_ms),
+              algorithm(algorithm),
+              burst(std::max(burst, 1L)),
+              m_start_time(now),
+              m_tat(now) {
+        }
+
+        /// \brief Returns the earliest time at which a request of the given weight is allowed.
+        /// \param now Current time.
+        /// \param weight Units of the budget the request consumes; values below 1 are treated as 1.
+        /// \return `now` if the request is allowed immediately, otherwise the exact future instant;
+        /// never earlier than the end of a pause.
+        time_point_t next_allowed_time(time_point_t now, long weight = 1) const {
+            if (is_unlimited()) return std::max(m_paused_until, now);
+            weight = clamp_weight(weight);
+            time_point_t allowed_time = now;
+            if (algorithm == RateLimitAlgorithm::RL_GCRA) {
+                allowed_time = m_tat - emission_interval() * (std::max(burst, weight) - weight);
+            } else
+            if (m_count > 0 && m_count + weight > requests_per_period) {
+                allowed_time = m_start_time + std::chrono::milliseconds(period_ms);
+            }
+            return std::max({allowed_time, m_paused_until, now});
+        }
+
+        /// \brief Returns the time left until a request of the given weight is allowed.
+        /// \param now Current time.
+        /// \param weight Units of the budget the request consumes.
+        /// \return Zero if the request is allowed immediately.
+        duration_t time_until_allowed(time_point_t now, long weight = 1) const {
+            return next_allowed_time(now, weight) - now;
+        }
+
+        /// \brief Checks whether a request is allowed without recording it.
+        /// \param now Current time.
+        /// \param weight Units of the budget the request consumes.
+        /// \return True if the request is allowed.
+        bool check(time_point_t now, long weight = 1) const {
+            return next_allowed_time(now, weight) <= now;
+        }
+
+        /// \brief Blocks the limit until the specified time.
+        /// \param until Time before which no request is allowed; an earlier pause is never shortened.
+        void pause_until(time_point_t until) {
+            m_paused_until = std::max(m_paused_until, until);
+        }
+
+        /// \brief Replaces the locally counted usage with the quota remaining on the server.
+        ///
+        /// With RL_FIXED_WINDOW the current window is aligned to the server window if its reset time is known.
+        /// With RL_GCRA up to `min(remaining, burst)` requests become available at once. If nothing remains,
+        /// the limit is paused until the reset time.
+        /// \param remaining Units of the budget the server still allows.
+        /// \param reset_time Time at which the server window resets, or `time_point_t()` if unknown.
+        /// \param now Current time.
+        void set_remaining(long remaining, time_point_t reset_time, time_point_t now) {
+            if (is_unlimited()) return;
+            remaining = std::min(std::max(remaining, 0L), requests_per_period);
+            if (remaining == 0 && reset_time > now) pause_until(reset_time);
+            if (algorithm == RateLimitAlgorithm::RL_GCRA) {
+                m_tat = now + emission_interval() * (burst - std::min(remaining, burst));
+                return;
+            }
+            if (reset_time > now) {
+                m_start_time = std::min(now, reset_time - std::chrono::milliseconds(period_ms));
+            } else
+            if (now - m_start_time >= std::chrono::milliseconds(period_ms)) {
+                m_start_time = now;
+            }
+            m_count = requests_per_period - remaining;
+        }
+
+        /// \brief Records a request. Call only after check() has returned true for the same weight.
+        /// \param now Current time.
+        /// \param weight Units of the budget the request consumes.
+        void consume(time_point_t now, long weight = 1) {
+            if (is_unlimited()) return;
+            weight = clamp_weight(weight);
+            if (algorithm == RateLimitAlgorithm::RL_GCRA) {
+                m_tat = std::max(m_tat, now) + emission_interval() * weight;
+                return;
+            }
+            if (now - m_start_time >= std::chrono::milliseconds(period_ms)) {
+                m_start_time = now;
+                m_count = 0;
+            }
+            m_count += weight;
+        }
+
+    private:
+        long            m_count = 0;    ///< Weight consumed in the current window (RL_FIXED_WINDOW).
+        time_point_t    m_start_time;   ///< Start of the current window (RL_FIXED_WINDOW).
+        time_point_t    m_tat;          ///< Theoretical arrival time of the next request (RL_GCRA).
+        time_point_t    m_paused_until; ///< Time before which no request is allowed, set by pause_until().
+
+        /// \brief Checks whether the limit never blocks requests.
+        bool is_unlimited() const {
+            return requests_per_period <= 0 || period_ms <= 0;
+        }
+
+        /// \brief Clamps a request weight to the range [1, requests_per_period].
+        ///
+        /// A request heavier than the whole budget would otherwise never be allowed; it is
+        /// charged the full budget instead.
+        long clamp_weight(long weight) const {
+            return std::min(std::max(weight, 1L), requests_per_period);
+        }
+
+        /// \brief Returns the interval between two evenly spaced requests.
+        duration_t emission_interval() const {
+            return std::chrono::duration_cast<duration_t>(std::chrono::milliseconds(period_ms)) / requests_per_period;
+        }
+
+    }; // RateLimitState
+
+} // namespace kurlyk::utils
+
+#endif // _KURLYK_UTILS_RATE_LIMIT_STATE_HPP_INCLUDED
@@ -0,0 +1,103 @@
+#pragma once
+#ifndef _KURLYK_UTILS_FILE_UTILS_HPP_INCLUDED
+#define _KURLYK_UTILS_FILE_UTILS_HPP_INCLUDED
+
+/// \file file_utils.hpp
+/// \brief Provides directory and file operations on UTF-8 paths without requiring std::filesystem.
+
+namespace kurlyk::utils {
+
+#   if defined(_WIN32)
+    /// \brief Converts a UTF-8 string to a wide string for the Win32 file APIs.
+    /// \param utf8 The UTF-8 encoded string.
+    /// \return The UTF-16 string, or an empty string if the input is not valid UTF-8.
+    inline std::wstring utf8_to_wide(const std::string& utf8) {
+        if (utf8.empty()) return std::wstring();
+        const int size = MultiByteToWideChar(CP_UTF8, 0, utf8.data(), static_cast<int>(utf8.size()), nullptr, 0);
+        if (size <= 0) return std::wstring();
+        std::wstring wide(static_cast<std::size_t>(size), L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, utf8.data(), static_cast<int>(utf8.size()), &wide[0], size);
+        return wide;
+    }
+
+    /// \brief Converts a wide string returned by the Win32 file APIs to UTF-8.
+    /// \param wide The UTF-16 string.
+    /// \return The UTF-8 string.
+    inline std::string wide_to_utf8(const std::wstring& wide) {
+        if (wide.empty()) return std::string();
+        const int size = WideCharToMultiByte(CP_UTF8, 0, wide.data(), static_cast<int>(wide.size()), nullptr, 0, nullptr, nullptr);
+        if (size <= 0) return std::string();
+        std::string utf8(static_cast<std::size_t>(size), '\0');
+        WideCharToMultiByte(CP_UTF8, 0, wide.data(), static_cast<int>(wide.size()), &utf8[0], size, nullptr, nullptr);
+        return utf8;
+    }
+#   endif
+
+    /// \brief Creates a directory and its missing parents.
+    ///
+    /// Directories created by the call are accessible to their owner only on POSIX systems.
+    /// \param path Path of the directory, in UTF-8.
+    /// \return True if the directory exists afterwards.
+    inline bool create_private_directories(const std::string& path) {
+        if (path.empty()) return false;
+        std::size_t pos = 0;
+        for (;;) {
+            pos = path.find_first_of("\\/", pos + 1);
+            const std::string part = path.substr(0, pos);
+#           if defined(_WIN32)
+            // Skip drive letters such as "C:".
+            if (!(part.size() == 2 && part[1] == ':')) _wmkdir(utf8_to_wide(part).c_str());
+#           else
+            mkdir(part.c_str(), 0700);
+#           endif
+            if (pos == std::string::npos) break;
+        }
+#       if defined(_WIN32)
+        const DWORD attributes = GetFileAttributesW(utf8_to_wide(path).c_str());
+        return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY);
+#       else
+        struct stat info;
+        return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+#       endif
+    }
+
+    /// \brief Lists the names of the entries of a directory.
+    /// \param path Path of the directory, in UTF-8.
+    /// \return Names of the entries in UTF-8, without "." and "..", or an empty list on error.
+    inline std::vector<std::string> list_directory(const std::string& path) {
+        std::vector<std::string> names;
+#       if defined(_WIN32)
+        WIN32_FIND_DATAW data;
+        HANDLE handle = FindFirstFileW(utf8_to_wide(path + "\\*").c_str(), &data);
+        if (handle == INVALID_HANDLE_VALUE) return names;
+        do {
+            const std::string name = wide_to_utf8(data.cFileName);
+            if (name != "." && name != "..") names.push_back(name);
+        } while (FindNextFileW(handle, &data));
+        FindClose(handle);
+#       else
+        DIR* dir = opendir(path.c_str());
+        if (!dir) return names;
+        while (struct dirent* entry = readdir(dir)) {
+            const std::string name = entry->d_name;
+            if (name != "." && name != "..") names.push_back(name);
+        }
+        closedir(dir);
+#       endif
+        return names;
+    }
+
+    /// \brief Deletes a file.
+    /// \param path Path of the file, in UTF-8.
+    /// \return True if the file was deleted.
+    inline bool remove_file(const std::string& path) {
+#       if defined(_WIN32)
+        return DeleteFileW(utf8_to_wide(path).c_str()) != 0;
+#       else
+        return unlink(path.c_str()) == 0;
+#       endif
+    }
+
+} // namespace kurlyk::utils
+
+#endif // _KURLYK_UTILS_FILE_UTILS_HPP_INCLUDED
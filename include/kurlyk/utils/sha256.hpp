@@ -0,0 +1,89 @@
+#pragma once
+#ifndef _KURLYK_UTILS_SHA256_HPP_INCLUDED
+#define _KURLYK_UTILS_SHA256_HPP_INCLUDED
+
+/// \file sha256.hpp
+/// \brief Provides a SHA-256 implementation (FIPS 180-4) that does not depend on a crypto library.
+
+namespace kurlyk::utils {
+
+    /// \brief Size of a SHA-256 digest in bytes.
+    static const std::size_t SHA256_DIGEST_SIZE = 32;
+
+    /// \brief Computes the SHA-256 digest of a string.
+    /// \param data Bytes to hash.
+    /// \return SHA256_DIGEST_SIZE raw (not hex-encoded) bytes of the digest.
+    inline std::string sha256(const std::string& data) {
+        static const uint32_t k[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+        };
+        uint32_t state[8] = {
+            0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+        };
+        auto rotr = [](uint32_t x, int n) { return (x >> n) | (x << (32 - n)); };
+
+        // Pad to a multiple of 64 bytes: 0x80, zeros, then the length in bits as a big-endian 64-bit integer.
+        std::string message = data;
+        const uint64_t bit_length = static_cast<uint64_t>(data.size()) * 8;
+        message.push_back(static_cast<char>(0x80));
+        while (message.size() % 64 != 56) message.push_back('\0');
+        for (int i = 7; i >= 0; --i) {
+            message.push_back(static_cast<char>((bit_length >> (i * 8)) & 0xFF));
+        }
+
+        uint32_t w[64];
+        for (std::size_t block = 0; block < message.size(); block += 64) {
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(message.data() + block);
+            for (int i = 0; i < 16; ++i) {
+                w[i] = (static_cast<uint32_t>(bytes[i * 4]) << 24) |
+                       (static_cast<uint32_t>(bytes[i * 4 + 1]) << 16) |
+                       (static_cast<uint32_t>(bytes[i * 4 + 2]) << 8) |
+                       static_cast<uint32_t>(bytes[i * 4 + 3]);
+            }
+            for (int i = 16; i < 64; ++i) {
+                const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+
+            uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+            uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+            for (int i = 0; i < 64; ++i) {
+                const uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+                const uint32_t ch = (e & f) ^ (~e & g);
+                const uint32_t t1 = h + s1 + ch + k[i] + w[i];
+                const uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+                const uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+                const uint32_t t2 = s0 + maj;
+                h = g;
+                g = f;
+                f = e;
+                e = d + t1;
+                d = c;
+                c = b;
+                b = a;
+                a = t1 + t2;
+            }
+            state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+            state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+        }
+
+        std::string digest(SHA256_DIGEST_SIZE, '\0');
+        for (std::size_t i = 0; i < 8; ++i) {
+            for (std::size_t j = 0; j < 4; ++j) {
+                digest[i * 4 + j] = static_cast<char>((state[i] >> (24 - j * 8)) & 0xFF);
+            }
+        }
+        return digest;
+    }
+
+} // namespace kurlyk::utils
+
+#endif // _KURLYK_UTILS_SHA256_HPP_INCLUDED
@@ -21,6 +21,25 @@ namespace kurlyk::utils {
         return protocol;
     }
 
+    /// \brief Extracts the origin (scheme, host and port) from a URL.
+    /// \param url The URL string.
+    /// \return The origin in lower case, e.g. "https://api.example.com:8443", without user info, path, query or fragment.
+    inline std::string extract_origin(const std::string& url) {
+        std::size_t authority_start = url.find("://");
+        authority_start = (authority_start == std::string::npos) ? 0 : authority_start + 3;
+        std::size_t authority_end = url.find_first_of("/?#", authority_start);
+        if (authority_end == std::string::npos) authority_end = url.length();
+
+        std::size_t host_start = url.rfind('@', authority_end);
+        host_start = (host_start == std::string::npos || host_start < authority_start) ? authority_start : host_start + 1;
+
+        std::string origin = url.substr(0, authority_start) + url.substr(host_start, authority_end - host_start);
+        std::transform(origin.begin(), origin.end(), origin.begin(), [](unsigned char ch) {
+            return static_cast<char>(std::tolower(ch));
+        });
+        return origin;
+    }
+
     /// \brief Removes the first occurrence of "wss://" or "ws://" from the given URL.
     /// \param url The URL from which to remove the substring.
     /// \return std::string The modified URL with the first occurrence of "wss://" or "ws://" removed.
@@ -204,6 +204,34 @@ namespace kurlyk {
             return m_client->send_message(message, rate_limit_id, std::move(callback));
         }
 
+        /// \brief Sends a message that consumes several units of the rate limit budgets.
+        /// \param message The content of the message to be sent.
+        /// \param rate_limit_id The ID of the rate limit to apply to this message.
+        /// \param weight Units of the general and specific rate limit budgets consumed by the message.
+        /// \param callback An optional callback to execute after sending the message.
+        /// \return True if the message was successfully queued, false otherwise.
+        bool send_message(
+                const std::string &message,
+                long rate_limit_id,
+                long weight,
+                std::function<void(const std::error_code&)> callback = nullptr) {
+            return m_client->send_message(message, rate_limit_id, weight, std::move(callback));
+        }
+
+        /// \brief Sends a message limited by several rate limits at once.
+        /// \param message The content of the message to be sent.
+        /// \param rate_limit_ids IDs of the rate limits applied together with the general limit; they are checked and consumed atomically.
+        /// \param weight Units of each rate limit budget consumed by the message.
+        /// \param callback An optional callback to execute after sending the message.
+        /// \return True if the message was successfully queued, false otherwise.
+        bool send_message(
+                const std::string &message,
+                const std::vector<long>& rate_limit_ids,
+                long weight = 1,
+                std::function<void(const std::error_code&)> callback = nullptr) {
+            return m_client->send_message(message, rate_limit_ids, weight, std::move(callback));
+        }
+
         /// \brief Sends a close request to the WebSocket server.
         /// \param status The status code for the close request (default: 1000).
         /// \param reason Optional reason for closing the connection.
@@ -404,10 +432,16 @@ namespace kurlyk {
         ///
         /// \param requests_per_period The maximum number of messages allowed within the specified period.
         /// \param period_ms The time period in milliseconds during which the request limit applies.
+        /// \param algorithm Algorithm enforcing the limit.
+        /// \param burst Messages allowed back to back by RateLimitAlgorithm::RL_GCRA.
         /// \return The index of the added rate limit configuration.
-        long add_rate_limit(long requests_per_period, long period_ms) {
+        long add_rate_limit(
+                long requests_per_period,
+                long period_ms,
+                RateLimitAlgorithm algorithm = RateLimitAlgorithm::RL_FIXED_WINDOW,
+                long burst = 1) {
             init_config();
-            return m_config->add_rate_limit(requests_per_period, period_ms);
+            return m_config->add_rate_limit(requests_per_period, period_ms, algorithm, burst);
         }
 
         /// \brief Adds a rate limit based on Requests Per Minute (RPM).
@@ -66,6 +66,19 @@ namespace kurlyk {
             return false;
         }
 
+        /// \brief Returns how long the worker may sleep before the clients must be processed again.
+        /// \return The smallest wait timeout among all clients, or `duration_t::max()` if there are none.
+        duration_t get_wait_timeout() const override {
+            duration_t timeout = duration_t::max();
+            std::lock_guard<std::mutex> lock(m_client_list_mutex);
+            for (auto &&client_weak_ptr : m_client_list) {
+                if (auto client_ptr = client_weak_ptr.lock()) {
+                    timeout = std::min(timeout, client_ptr->get_wait_timeout());
+                }
+            }
+            return timeout;
+        }
+
         /// \brief Creates and returns a new WebSocket client instance based on the platform defined by compilation flags.
         /// \return A shared pointer to the created IWebSocketClient instance.
         std::shared_ptr<IWebSocketClient> create_client() {
@@ -103,13 +103,54 @@ namespace kurlyk {
                 const std::string &message,
                 long rate_limit_id,
                 std::function<void(const std::error_code& ec)> callback = nullptr) override final {
+            return send_message(message, rate_limit_id, 1, std::move(callback));
+        }
+
+        /// \brief Send a message that consumes several units of the rate limit budgets.
+        /// \param message The message to send.
+        /// \param rate_limit_id The rate limit type to apply.
+        /// \param weight Units of the general and specific rate limit budgets consumed by the message.
+        /// \param callback The callback to be invoked after sending.
+        /// \return True if the message was successfully queued, false otherwise.
+        bool send_message(
+                const std::string &message,
+                long rate_limit_id,
+                long weight,
+                std::function<void(const std::error_code& ec)> callback = nullptr) override final {
             if (message.empty() || !is_connected()) return false;
-            std::lock_guard<std::mutex> lock(m_message_queue_mutex);
+            std::unique_lock<std::mutex> lock(m_message_queue_mutex);
 #           if __cplusplus >= 201402L
-            m_message_queue.push_back(std::make_shared<WebSocketSendInfo>(message, rate_limit_id, false, 0, std::move(callback)));
+            m_message_queue.push_back(std::make_shared<WebSocketSendInfo>(message, rate_limit_id, false, 0, std::move(callback), weight));
 #           else
-            m_message_queue.push_back(std::shared_ptr<WebSocketSendInfo>(new WebSocketSendInfo(message, rate_limit_id, false, 0, std::move(callback))));
+            m_message_queue.push_back(std::shared_ptr<WebSocketSendInfo>(new WebSocketSendInfo(message, rate_limit_id, false, 0, std::move(callback), weight)));
 #           endif
+            lock.unlock();
+            if (m_on_event_notify) m_on_event_notify();
+            return true;
+        }
+
+        /// \brief Send a message limited by several rate limits at once.
+        /// \param message The message to send.
+        /// \param rate_limit_ids IDs of the rate limits applied together with the general limit.
+        /// \param weight Units of each rate limit budget consumed by the message.
+        /// \param callback The callback to be invoked after sending.
+        /// \return True if the message was successfully queued, false otherwise.
+        bool send_message(
+                const std::string &message,
+                const std::vector<long>& rate_limit_ids,
+                long weight = 1,
+                std::function<void(const std::error_code& ec)> callback = nullptr) override final {
+            if (message.empty() || !is_connected()) return false;
+#           if __cplusplus >= 201402L
+            auto send_info = std::make_shared<WebSocketSendInfo>(message, 0, false, 0, std::move(callback), weight);
+#           else
+            auto send_info = std::shared_ptr<WebSocketSendInfo>(new WebSocketSendInfo(message, 0, false, 0, std::move(callback), weight));
+#           endif
+            send_info->rate_limit_ids = rate_limit_ids;
+            std::unique_lock<std::mutex> lock(m_message_queue_mutex);
+            m_message_queue.push_back(std::move(send_info));
+            lock.unlock();
+            if (m_on_event_notify) m_on_event_notify();
             return true;
         }
 
@@ -123,12 +164,14 @@ namespace kurlyk {
                 const std::string &reason = std::string(),
                 std::function<void(const std::error_code& ec)> callback = nullptr) override final {
             if (!is_connected()) return false;
-            std::lock_guard<std::mutex> lock(m_message_queue_mutex);
+            std::unique_lock<std::mutex> lock(m_message_queue_mutex);
 #           if __cplusplus >= 201402L
             m_message_queue.push_back(std::make_shared<WebSocketSendInfo>(reason, 0, true, status, std::move(callback)));
 #           else
             m_message_queue.push_back(std::shared_ptr<WebSocketSendInfo>(new WebSocketSendInfo(reason, 0, true, status, std::move(callback))));
 #           endif
+            lock.unlock();
+            if (m_on_event_notify) m_on_event_notify();
             return true;
         }
 
@@ -143,6 +186,34 @@ namespace kurlyk {
             process_send_callback_queue();
         }
 
+        /// \brief Returns how long the network worker may sleep before this client must be processed again.
+        ///
+        /// Accounts for queued FSM events, pending send callbacks and rate-limited messages waiting
+        /// in the send queue. The reconnection delay is tracked by a NetworkWorker timer.
+        /// \return Time until the next deadline, or `duration::max()` if only a notification can produce new work.
+        std::chrono::steady_clock::duration get_wait_timeout() const override final {
+            using duration_t = std::chrono::steady_clock::duration;
+            if (m_fsm_event_queue.has_events()) return duration_t::zero();
+
+            std::unique_lock<std::mutex> callback_lock(m_send_callback_queue_mutex);
+            if (!m_send_callback_queue.empty()) return duration_t::zero();
+            callback_lock.unlock();
+
+            // While the reconnect timer is pending, the worker is woken by the timer itself.
+            if (m_fsm_state == FsmState::RECONNECTING &&
+                (!m_reconnect_timer_id || m_reconnect_due)) return duration_t::zero();
+
+            duration_t timeout = duration_t::max();
+
+            std::lock_guard<std::mutex> lock(m_message_queue_mutex);
+            for (const auto& send_info : m_message_queue) {
+                timeout = std::min(timeout, m_rate_limiter.time_until_next_allowed(
+                    send_info->rate_limit_id, send_info->rate_limit_ids, send_info->weight));
+                if (timeout == duration_t::zero()) break;
+            }
+            return timeout;
+        }
+
         /// \brief Shuts down the WebSocket client, disconnecting and clearing all pending events.
         /// Initiates a disconnect event and processes any remaining events until the client stops running.
         void shutdown() override final {
@@ -239,8 +310,10 @@ namespace kurlyk {
         void add_send_callback(
                 const std::error_code& error_code,
                 const std::function<void(const std::error_code& ec)> &callback) {
-            std::lock_guard<std::mutex> lock(m_send_callback_queue_mutex);
+            std::unique_lock<std::mutex> lock(m_send_callback_queue_mutex);
             m_send_callback_queue.push_back(std::make_pair(error_code, callback));
+            lock.unlock();
+            if (m_on_event_notify) m_on_event_notify();
         }
 
         /// \brief Adds an FSM event to the event queue and triggers the notify handler.
@@ -339,17 +412,19 @@ namespace kurlyk {
         std::atomic<bool>                       m_is_connected = ATOMIC_VAR_INIT(false);///< Atomic flag indicating if the client is connected.
 
         WebSocketRateLimiter                    m_rate_limiter;             ///< Rate limiter for controlling the frequency of message sending.
-        std::chrono::steady_clock::time_point   m_close_time;               ///< Timestamp of the last WebSocket close event, used for reconnection timing.
+        std::chrono::steady_clock::time_point   m_close_time;               ///< Timestamp of the last WebSocket close event.
+        core::TimerQueue::timer_id_t            m_reconnect_timer_id = 0;   ///< NetworkWorker timer signalling the end of the reconnection delay, or 0.
+        std::atomic<bool>                       m_reconnect_due = ATOMIC_VAR_INIT(false); ///< Set by the reconnect timer when the reconnection delay has passed.
 
         mutable std::mutex                      m_event_queue_mutex;        ///< Mutex for synchronizing access to the event queue.
         using event_data_ptr_t  = std::unique_ptr<WebSocketEventData>;      ///< Alias for unique pointers to WebSocketEventData.
         mutable std::list<event_data_ptr_t>     m_event_queue;              ///< Queue holding pending WebSocket events.
 
-        std::mutex                              m_message_queue_mutex;      ///< Mutex for synchronizing access to the message queue.
+        mutable std::mutex                      m_message_queue_mutex;      ///< Mutex for synchronizing access to the message queue.
         using send_info_ptr_t   = std::shared_ptr<WebSocketSendInfo>;       ///< Alias for shared pointers to WebSocketSendInfo.
         std::list<send_info_ptr_t>              m_message_queue;            ///< Queue holding messages to be sent over the WebSocket.
 
-        std::mutex                              m_send_callback_queue_mutex;///< Mutex for synchronizing access to the send callback queue.
+        mutable std::mutex                      m_send_callback_queue_mutex;///< Mutex for synchronizing access to the send callback queue.
         using send_callback_t   = std::pair<std::error_code, std::function<void(const std::error_code& ec)>>; ///< Alias for callback pairs with error codes.
         std::list<send_callback_t>              m_send_callback_queue;      ///< Queue holding send callbacks with their respective error codes.
 
@@ -444,6 +519,7 @@ namespace kurlyk {
                 m_close_time = std::chrono::steady_clock::now();
                 m_is_running = true;
                 m_fsm_state = FsmState::RECONNECTING;
+                schedule_reconnect();
                 break;
             case FsmEvent::RequestDisconnect: {
                 deinit_websocket();
@@ -522,6 +598,7 @@ namespace kurlyk {
                     m_close_time = std::chrono::steady_clock::now();
                     m_is_running = true;
                     m_fsm_state = FsmState::RECONNECTING;
+                    schedule_reconnect();
                     break;
                 case FsmEvent::UpdateConfig:
                     deinit_websocket();
@@ -566,11 +643,13 @@ namespace kurlyk {
                 auto event = m_fsm_event_queue.pop_event();
                 switch (event.event_type) {
                 case FsmEvent::RequestDisconnect:
+                    cancel_reconnect();
                     m_is_running = false;
                     if (event.callback) event.callback(true);
                     m_fsm_state = FsmState::INIT;
                     break;
                 case FsmEvent::UpdateConfig:
+                    cancel_reconnect();
                     m_config = std::move(event.config_data);
                     if (!m_config) {
                         handle_error_event(utils::make_error_code(utils::ClientError::InvalidConfiguration));
@@ -602,6 +681,7 @@ namespace kurlyk {
             }
 
             if (!m_config) {
+                cancel_reconnect();
                 handle_error_event(utils::make_error_code(utils::ClientError::InvalidConfiguration));
                 m_fsm_state = FsmState::STOPPED;
                 return;
@@ -610,14 +690,18 @@ namespace kurlyk {
             if (m_config->reconnect) {
                 if (m_config->reconnect_attempts &&
                     m_reconnect_attempt >= m_config->reconnect_attempts) {
+                    cancel_reconnect();
                     m_is_running = false;
                     m_fsm_state = FsmState::INIT;
                     return;
                 }
 
-                auto now = std::chrono::steady_clock::now();
-                auto duration = std::chrono::duration_cast<std::chrono::seconds>(now - m_close_time);
-                if (duration.count() >= m_config->reconnect_delay) {
+                if (m_reconnect_due) {
+                    m_reconnect_due = false;
+                    m_reconnect_timer_id = 0;
+#                   if KURLYK_ENABLE_METRICS
+                    metrics::builtin().ws_reconnects.inc();
+#                   endif
                     if (!init_websocket()) {
                         handle_error_event(utils::make_error_code(utils::ClientError::InvalidConfiguration));
                         m_fsm_state = FsmState::STOPPED;
@@ -629,10 +713,36 @@ namespace kurlyk {
                 return;
             }
 
+            cancel_reconnect();
             m_is_running = false;
             m_fsm_state = FsmState::INIT;
         }
 
+        /// \brief Schedules the end of the reconnection delay on the NetworkWorker timer queue.
+        ///
+        /// The timer only raises `m_reconnect_due`; the reconnection itself runs in process_state_reconnecting().
+        void schedule_reconnect() {
+            cancel_reconnect();
+            const long delay_s = m_config ? m_config->reconnect_delay : 0;
+            std::weak_ptr<BaseWebSocketClient> weak_self = weak_from_this();
+            m_reconnect_timer_id = core::NetworkWorker::get_instance().add_timer(
+                    std::chrono::seconds(std::max(delay_s, 0L)),
+                    [weak_self]() {
+                auto self = weak_self.lock();
+                if (!self) return;
+                self->m_reconnect_due = true;
+            });
+        }
+
+        /// \brief Cancels a pending reconnect timer.
+        void cancel_reconnect() {
+            if (m_reconnect_timer_id) {
+                core::NetworkWorker::get_instance().cancel_timer(m_reconnect_timer_id);
+                m_reconnect_timer_id = 0;
+            }
+            m_reconnect_due = false;
+        }
+
         /// \brief Processes the STOPPED state in the FSM.
         void process_state_stopped() {
             if (!m_fsm_event_queue.has_events()) return;
@@ -692,11 +802,19 @@ namespace kurlyk {
             if (m_message_queue.empty()) return;
 
             std::list<send_info_ptr_t> message_queue;
+            std::set<long> blocked_limits; // Keeps lighter messages from overtaking a throttled one.
             auto it = m_message_queue.begin();
             while (it != m_message_queue.end()) {
                 auto& send_info = *it;
                 // Check if the message is allowed by the rate limiter.
-                if (!m_rate_limiter.allow_request(send_info->rate_limit_id)) {
+                bool is_blocked = blocked_limits.count(send_info->rate_limit_id) != 0;
+                for (long id : send_info->rate_limit_ids) {
+                    is_blocked = is_blocked || blocked_limits.count(id) != 0;
+                }
+                if (is_blocked ||
+                    !m_rate_limiter.allow_request(send_info->rate_limit_id, send_info->rate_limit_ids, send_info->weight)) {
+                    blocked_limits.insert(send_info->rate_limit_id);
+                    blocked_limits.insert(send_info->rate_limit_ids.begin(), send_info->rate_limit_ids.end());
                     ++it;
                     continue;
                 }
@@ -708,6 +826,10 @@ namespace kurlyk {
 
             for (auto &send_info : message_queue) {
                 if (!send_info->is_send_close) {
+#                   if KURLYK_ENABLE_METRICS
+                    metrics::builtin().ws_messages_sent.inc();
+                    metrics::builtin().ws_bytes_sent.inc(send_info->message.size());
+#                   endif
                     send_message(send_info);
                     continue;
                 }
@@ -724,11 +846,41 @@ namespace kurlyk {
             auto send_callback_queue = std::move(m_send_callback_queue);
             m_send_callback_queue.clear();
 
+            auto executor = core::NetworkWorker::get_instance().get_callback_executor();
             for (auto &item : send_callback_queue) {
-                item.second(item.first);
+                if (!executor) {
+                    item.second(item.first);
+                    continue;
+                }
+                auto callback = item.second;
+                auto error_code = item.first;
+                executor->post(get_callback_key(), [callback, error_code]() {
+                    callback(error_code);
+                });
             }
         }
 
+        /// \brief Returns the key ordering this client's callbacks on the callback executor.
+        /// \return Address of the client.
+        uint64_t get_callback_key() const {
+            return static_cast<uint64_t>(reinterpret_cast<std::uintptr_t>(this));
+        }
+
+        /// \brief Invokes the event handler, on the callback executor if one is set.
+        /// \param event Event to pass to the handler.
+        void dispatch_event(std::unique_ptr<WebSocketEventData> event) {
+            auto executor = core::NetworkWorker::get_instance().get_callback_executor();
+            if (!executor) {
+                m_on_event(std::move(event));
+                return;
+            }
+            auto handler = m_on_event;
+            auto shared_event = std::make_shared<std::unique_ptr<WebSocketEventData>>(std::move(event));
+            executor->post(get_callback_key(), [handler, shared_event]() {
+                handler(std::move(*shared_event));
+            });
+        }
+
         /// \brief Handles the event when the WebSocket connection is opened.
         /// Sets the connection state to connected and triggers the event handler, if set.
         /// Otherwise, stores the event in the event queue.
@@ -737,7 +889,7 @@ namespace kurlyk {
             if (!m_is_connected) {
                 m_is_connected = true;
                 if (m_on_event) {
-                    m_on_event(std::move(event));
+                    dispatch_event(std::move(event));
                 } else {
                     std::lock_guard<std::mutex> lock(m_event_queue_mutex);
                     m_event_queue.push_back(std::move(event));
@@ -756,7 +908,7 @@ namespace kurlyk {
             if (m_is_connected) {
                 m_is_connected = false;
                 if (m_on_event) {
-                    m_on_event(std::move(event));
+                    dispatch_event(std::move(event));
                 } else {
                     std::lock_guard<std::mutex> lock(m_event_queue_mutex);
                     m_event_queue.push_back(std::move(event));
@@ -769,7 +921,7 @@ namespace kurlyk {
         /// \param event Unique pointer to the WebSocket error event data.
         void handle_error_event(std::unique_ptr<WebSocketEventData> event) {
             if (m_on_event) {
-                m_on_event(std::move(event));
+                dispatch_event(std::move(event));
                 return;
             }
             std::lock_guard<std::mutex> lock(m_event_queue_mutex);
@@ -786,8 +938,12 @@ namespace kurlyk {
         /// If an event handler exists, it directly processes the message event.
         /// \param event Unique pointer to the WebSocket message event data.
         void handle_message_event(std::unique_ptr<WebSocketEventData> event) {
+#           if KURLYK_ENABLE_METRICS
+            metrics::builtin().ws_messages_received.inc();
+            metrics::builtin().ws_bytes_received.inc(event->message.size());
+#           endif
             if (m_on_event) {
-                m_on_event(std::move(event));
+                dispatch_event(std::move(event));
                 return;
             }
             std::lock_guard<std::mutex> lock(m_event_queue_mutex);
@@ -63,6 +63,10 @@ namespace kurlyk {
         /// \return A unique pointer to a `WebSocketEventData` object representing an event, or nullptr if no events are available.
         virtual std::unique_ptr<WebSocketEventData> receive_event() const = 0;
 
+        /// \brief Returns how long the network worker may sleep before this client must be processed again.
+        /// \return Time until the next deadline, or `duration::max()` if only a notification can produce new work.
+        virtual std::chrono::steady_clock::duration get_wait_timeout() const = 0;
+
         /// \brief Processes internal operations such as event handling and state updates.
         ///
         /// This function should be called periodically to ensure timely processing of internal state changes,
@@ -40,6 +40,30 @@ namespace kurlyk {
                 long rate_limit_id = 0,
                 std::function<void(const std::error_code&)> callback = nullptr) = 0;
 
+        /// \brief Sends a WebSocket message that consumes several units of the rate limit budgets.
+        /// \param message The content of the message to be sent.
+        /// \param rate_limit_id The ID of the rate limit to apply to this message.
+        /// \param weight Units of the general and specific rate limit budgets consumed by the message.
+        /// \param callback Optional callback to execute once the message is sent, providing an error code if any issues occur.
+        /// \return True if the message was accepted for sending, false otherwise.
+        virtual bool send_message(
+                const std::string &message,
+                long rate_limit_id,
+                long weight,
+                std::function<void(const std::error_code&)> callback = nullptr) = 0;
+
+        /// \brief Sends a WebSocket message limited by several rate limits at once.
+        /// \param message The content of the message to be sent.
+        /// \param rate_limit_ids IDs of the rate limits applied together with the general limit; they are checked and consumed atomically.
+        /// \param weight Units of each rate limit budget consumed by the message.
+        /// \param callback Optional callback to execute once the message is sent, providing an error code if any issues occur.
+        /// \return True if the message was accepted for sending, false otherwise.
+        virtual bool send_message(
+                const std::string &message,
+                const std::vector<long>& rate_limit_ids,
+                long weight = 1,
+                std::function<void(const std::error_code&)> callback = nullptr) = 0;
+
         /// \brief Sends a close request to the WebSocket server.
         /// \param status The status code for the close request, default is 1000 (normal closure).
         /// \param reason Optional reason for closing the connection.
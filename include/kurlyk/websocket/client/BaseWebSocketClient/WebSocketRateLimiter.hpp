@@ -10,6 +10,7 @@ namespace kurlyk {
     /// \class WebSocketRateLimiter
     /// \brief Manages rate limiting for WebSocket requests based on predefined limits.
     /// The limiter applies a general rate limit (id 0) to all requests by default.
+    /// Each limit uses the algorithm selected in its WebSocketConfig::RateLimitData.
     class WebSocketRateLimiter {
     public:
         using time_point_t = std::chrono::steady_clock::time_point;
@@ -18,98 +19,109 @@ namespace kurlyk {
         /// \param rate_limits A vector of rate limit configurations for different request categories.
         void set_limit(const std::vector<WebSocketConfig::RateLimitData>& rate_limits) {
             std::lock_guard<std::mutex> lock(m_mutex);
-            m_limit_data.resize(rate_limits.size());
-            for (size_t i = 0; i < rate_limits.size(); ++i) {
-                m_limit_data[i].requests_per_period = rate_limits[i].requests_per_period;
-                m_limit_data[i].period_ms = rate_limits[i].period_ms;
-                m_limit_data[i].start_time = std::chrono::steady_clock::now();
+            const auto now = std::chrono::steady_clock::now();
+            m_limit_data.clear();
+            m_limit_data.reserve(rate_limits.size());
+            for (const auto& rate_limit : rate_limits) {
+                m_limit_data.emplace_back(
+                    rate_limit.requests_per_period,
+                    rate_limit.period_ms,
+                    rate_limit.algorithm,
+                    rate_limit.burst,
+                    now);
             }
         }
 
         /// \brief Checks if a request is allowed under the specified rate limit.
         /// \param rate_limit_id The ID of the rate limit category to apply.
+        /// \param weight Units of each limit's budget the request consumes.
         /// \return true if the request is allowed, false if the request exceeds the limit.
-        /*
-        bool allow_request(long rate_limit_id) {
-            if (rate_limit_id < 0) return true;  // No rate limit if ID is negative
-            std::lock_guard<std::mutex> lock(m_mutex);
-            if (rate_limit_id >= static_cast<long>(m_limit_data.size())) return true; // Out of bounds, allow by default
-            // Apply both the general limit (id 0) and the specific limit if applicable
-            return allow_request_impl(0) && (rate_limit_id == 0 || allow_request_impl(rate_limit_id));
+        bool allow_request(long rate_limit_id, long weight = 1) {
+            return allow_request(rate_limit_id, std::vector<long>(), weight);
         }
-        */
-        bool allow_request(long rate_limit_id) {
+
+        /// \brief Checks if a request is allowed under the general limit and all of the specified rate limits.
+        ///
+        /// The limits are checked and updated atomically: either every limit records the request, or none does.
+        /// IDs out of range are ignored and repeated IDs are counted once.
+        /// \param rate_limit_id The ID of the rate limit category to apply. A negative value disables rate limiting.
+        /// \param extra_rate_limit_ids IDs of additional rate limits applied together with rate_limit_id.
+        /// \param weight Units of each limit's budget the request consumes.
+        /// \return true if the request is allowed, false if the request exceeds one of the limits.
+        bool allow_request(long rate_limit_id, const std::vector<long>& extra_rate_limit_ids, long weight = 1) {
             if (rate_limit_id < 0) return true;  // No rate limit if ID is negative
             std::lock_guard<std::mutex> lock(m_mutex);
-            if (rate_limit_id >= static_cast<long>(m_limit_data.size())) return true; // Out of bounds, allow by default
-
-            // First check all applicable limits without updating counts
-            bool general_limit_allowed = check_limit(0);
-            bool specific_limit_allowed = (rate_limit_id == 0) || check_limit(rate_limit_id);
-
-            if (general_limit_allowed && specific_limit_allowed) {
-                // All limits allow the request, now update counts
-                update_limit(0);
-                if (rate_limit_id != 0) {
-                    update_limit(rate_limit_id);
-                }
-                return true;
-            }
-
-            // Request is not allowed under one or more limits
-            return false;
+            if (m_limit_data.empty()) return true;
+
+            // First check all applicable limits without updating them
+            const auto now = std::chrono::steady_clock::now();
+            bool allowed = true;
+            for_each_limit(m_limit_data, rate_limit_id, extra_rate_limit_ids, [&](utils::RateLimitState& limit) {
+                allowed = allowed && limit.check(now, weight);
+            });
+            if (!allowed) return false;
+
+            // All limits allow the request, now update them
+            for_each_limit(m_limit_data, rate_limit_id, extra_rate_limit_ids, [&](utils::RateLimitState& limit) {
+                limit.consume(now, weight);
+            });
+            return true;
         }
 
-    private:
-
-        /// \struct LimitData
-        struct LimitData {
-            long requests_per_period = 0; ///< Maximum requests allowed per period.
-            long period_ms = 0;           ///< Duration of the rate limit period in milliseconds.
-            long count = 0;               ///< Number of requests made in the current period.
-            time_point_t start_time = std::chrono::steady_clock::now(); ///< Start time of the current rate limit period.
-
-            LimitData() = default;
-        };
-
-        std::mutex m_mutex;                     ///< Mutex to protect shared data.
-        std::vector<LimitData> m_limit_data;    ///< Vector storing rate limit configurations.
-
-        /// \brief Checks if a request is allowed under the specified rate limit without updating the count.
-        /// \param rate_limit_id The ID of the rate limit to apply.
-        /// \return true if the request is allowed, false if the request exceeds the limit.
-        bool check_limit(long rate_limit_id) {
-            LimitData& limit_data = m_limit_data[rate_limit_id];
-            auto now = std::chrono::steady_clock::now();
-            auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(now - limit_data.start_time);
-
-            // If period has elapsed, the count will reset upon update
-            if (elapsed_time.count() >= limit_data.period_ms) {
-                return true; // Period elapsed, limit can be reset
-            }
-
-            // Check if under limit or if no limit is set (0 requests per period means unlimited)
-            if (limit_data.count < limit_data.requests_per_period ||
-                limit_data.requests_per_period == 0) {
-                return true;
-            }
-            return false;
+        /// \brief Returns the earliest time at which a request is allowed under the specified rate limits.
+        ///
+        /// Takes into account the general limit (id 0) and the specified limits, mirroring allow_request().
+        /// \param rate_limit_id The ID of the rate limit category to apply.
+        /// \param extra_rate_limit_ids IDs of additional rate limits applied together with rate_limit_id.
+        /// \param weight Units of each limit's budget the request consumes.
+        /// \return The current time if the request is allowed now, otherwise the exact future instant.
+        time_point_t next_allowed_time(
+                long rate_limit_id,
+                const std::vector<long>& extra_rate_limit_ids = std::vector<long>(),
+                long weight = 1) const {
+            const auto now = std::chrono::steady_clock::now();
+            if (rate_limit_id < 0) return now;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            time_point_t allowed_time = now;
+            for_each_limit(m_limit_data, rate_limit_id, extra_rate_limit_ids, [&](const utils::RateLimitState& limit) {
+                allowed_time = std::max(allowed_time, limit.next_allowed_time(now, weight));
+            });
+            return allowed_time;
         }
 
-        /// \brief Updates the request count for the specified rate limit ID.
-        /// \param rate_limit_id The ID of the rate limit to apply.
-        void update_limit(long rate_limit_id) {
-            LimitData& limit_data = m_limit_data[rate_limit_id];
-            auto now = std::chrono::steady_clock::now();
-            auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(now - limit_data.start_time);
+        /// \brief Calculates the delay until a request is allowed under the specified rate limits.
+        ///
+        /// Takes into account the general limit (id 0) and the specified limits, mirroring allow_request().
+        /// \param rate_limit_id The ID of the rate limit category to apply.
+        /// \param extra_rate_limit_ids IDs of additional rate limits applied together with rate_limit_id.
+        /// \param weight Units of each limit's budget the request consumes.
+        /// \return Duration to wait before the request is allowed. Zero if it is already allowed.
+        std::chrono::steady_clock::duration time_until_next_allowed(
+                long rate_limit_id,
+                const std::vector<long>& extra_rate_limit_ids = std::vector<long>(),
+                long weight = 1) const {
+            const auto delay = next_allowed_time(rate_limit_id, extra_rate_limit_ids, weight) - std::chrono::steady_clock::now();
+            return std::max(delay, std::chrono::steady_clock::duration::zero());
+        }
 
-            // Reset count if period has elapsed
-            if (elapsed_time.count() >= limit_data.period_ms) {
-                limit_data.start_time = now;
-                limit_data.count = 0;
+    private:
+        mutable std::mutex m_mutex;                     ///< Mutex to protect shared data.
+        std::vector<utils::RateLimitState> m_limit_data;///< Vector storing rate limit states.
+
+        /// \brief Invokes a function for the general limit and each distinct, valid limit among the specified ones.
+        /// Must be called with m_mutex held.
+        template<class Limits, class F>
+        static void for_each_limit(Limits& limits, long rate_limit_id, const std::vector<long>& extra_rate_limit_ids, F&& f) {
+            const long size = static_cast<long>(limits.size());
+            if (size == 0) return;
+            f(limits[0]);
+            if (rate_limit_id > 0 && rate_limit_id < size) f(limits[rate_limit_id]);
+            for (auto it = extra_rate_limit_ids.begin(); it != extra_rate_limit_ids.end(); ++it) {
+                const long id = *it;
+                if (id <= 0 || id >= size || id == rate_limit_id) continue;
+                if (std::find(extra_rate_limit_ids.begin(), it, id) != it) continue;
+                f(limits[id]);
             }
-
-            ++limit_data.count;
         }
     };
 
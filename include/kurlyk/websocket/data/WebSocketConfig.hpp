@@ -35,9 +35,16 @@ namespace kurlyk {
         struct RateLimitData {
             long requests_per_period; ///< Maximum number of requests allowed per period.
             long period_ms; ///< Time period in milliseconds for the request limit.
-
-            RateLimitData(long requests_per_period = 0, long period_ms = 0)
-                : requests_per_period(requests_per_period), period_ms(period_ms) {}
+            RateLimitAlgorithm algorithm; ///< Algorithm enforcing the limit.
+            long burst; ///< Requests allowed back to back by RateLimitAlgorithm::RL_GCRA.
+
+            RateLimitData(
+                    long requests_per_period = 0,
+                    long period_ms = 0,
+                    RateLimitAlgorithm algorithm = RateLimitAlgorithm::RL_FIXED_WINDOW,
+                    long burst = 1)
+                : requests_per_period(requests_per_period), period_ms(period_ms),
+                  algorithm(algorithm), burst(burst) {}
         };
 
         std::vector<RateLimitData> rate_limits; ///< List of rate limits applied to WebSocket messages.
@@ -204,9 +211,15 @@ namespace kurlyk {
         ///
         /// \param requests_per_period The maximum number of messages allowed within the specified period.
         /// \param period_ms The time period in milliseconds during which the request limit applies.
+        /// \param algorithm Algorithm enforcing the limit.
+        /// \param burst Messages allowed back to back by RateLimitAlgorithm::RL_GCRA.
         /// \return The index of the added rate limit configuration.
-        long add_rate_limit(long requests_per_period, long period_ms) {
-            rate_limits.emplace_back(requests_per_period, period_ms);
+        long add_rate_limit(
+                long requests_per_period,
+                long period_ms,
+                RateLimitAlgorithm algorithm = RateLimitAlgorithm::RL_FIXED_WINDOW,
+                long burst = 1) {
+            rate_limits.emplace_back(requests_per_period, period_ms, algorithm, burst);
             return rate_limits.size() - 1;
         }
 
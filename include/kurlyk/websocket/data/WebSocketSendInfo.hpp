@@ -13,8 +13,10 @@ namespace kurlyk {
     public:
         std::string message;        ///< Content of the WebSocket message to be sent.
         long rate_limit_id = 0;     ///< Rate limit ID applied to the message. A value of 0 implies the default rate limit or no limit if unspecified.
+        std::vector<long> rate_limit_ids; ///< Additional rate limit IDs applied together with rate_limit_id.
         bool is_send_close = false; ///< Indicates if this message is a close request.
         int status = 1000;          ///< Status code for the close request, default is normal closure (1000).
+        long weight = 1;            ///< Units of the rate limit budgets consumed by the message.
         std::function<void(const std::error_code&)> callback; ///< Callback invoked after sending, with error status.
 
         /// \brief Constructs a WebSocketSendInfo instance with the specified parameters.
@@ -23,16 +25,19 @@ namespace kurlyk {
         /// \param is_send_close True if the message is a close request, false otherwise.
         /// \param status Status code for the close request; default is 1000 (normal closure).
         /// \param callback Callback function to be called upon completion of the send operation.
+        /// \param weight Units of the general and specific rate limit budgets consumed by the message.
         WebSocketSendInfo(
                 std::string message,
                 long rate_limit_id = 0,
                 bool is_send_close = false,
                 int status = 1000,
-                std::function<void(const std::error_code&)> callback = nullptr) :
+                std::function<void(const std::error_code&)> callback = nullptr,
+                long weight = 1) :
             message(std::move(message)),
             rate_limit_id(rate_limit_id),
             is_send_close(is_send_close),
             status(status),
+            weight(weight),
             callback(std::move(callback)) {}
     };
 
@@ -0,0 +1,79 @@
+#include <kurlyk.hpp>
+#include "unit_test.hpp"
+
+using kurlyk::core::CallbackThreadPool;
+
+namespace {
+
+	void test_size() {
+		CallbackThreadPool pool(3);
+		KURLYK_CHECK(pool.size() == 3);
+		CallbackThreadPool hardware;
+		KURLYK_CHECK(hardware.size() >= 1);
+	}
+
+	void test_key_order() {
+		const std::size_t key_count = 16;
+		const int task_count = 2000;
+		std::vector<std::vector<int>> order(key_count);
+		std::vector<std::atomic<int>> running(key_count);
+		std::atomic<int> overlaps(0);
+		{
+			CallbackThreadPool pool(4);
+			for (int i = 0; i < task_count; ++i) {
+				for (std::size_t key = 0; key < key_count; ++key) {
+					pool.post(key, [&, key, i]() {
+						// Tasks of one key never run concurrently
+						if (running[key].fetch_add(1) != 0) ++overlaps;
+						order[key].push_back(i);
+						running[key].fetch_sub(1);
+					});
+				}
+			}
+			// The destructor runs the queued tasks
+		}
+		KURLYK_CHECK(overlaps == 0);
+		for (std::size_t key = 0; key < key_count; ++key) {
+			KURLYK_CHECK(order[key].size() == static_cast<std::size_t>(task_count));
+			KURLYK_CHECK(std::is_sorted(order[key].begin(), order[key].end()));
+		}
+	}
+
+	void test_slow_key() {
+		CallbackThreadPool pool(2);
+		std::mutex mutex;
+		std::condition_variable condition;
+		bool is_released = false;
+		std::atomic<bool> is_done(false);
+
+		// Find a key served by another thread than key 0
+		uint64_t other_key = 1;
+		while (std::hash<uint64_t>()(other_key) % pool.size() == std::hash<uint64_t>()(0) % pool.size()) ++other_key;
+
+		pool.post(0, [&]() {
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [&]() { return is_released; });
+		});
+		pool.post(other_key, [&]() { is_done = true; });
+
+		// A blocked callback does not delay keys of other threads
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (!is_done && std::chrono::steady_clock::now() < deadline) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		KURLYK_CHECK(is_done);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			is_released = true;
+		}
+		condition.notify_all();
+	}
+
+} // namespace
+
+int main() {
+	test_size();
+	test_key_order();
+	test_slow_key();
+	return kurlyk::unit_test::report("callback_thread_pool_test");
+}
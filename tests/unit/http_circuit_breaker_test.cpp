@@ -0,0 +1,158 @@
+#include <kurlyk.hpp>
+#include "unit_test.hpp"
+
+using kurlyk::HttpCircuitBreaker;
+using kurlyk::HttpCircuitBreakerPolicy;
+using kurlyk::HttpResponse;
+
+namespace {
+
+	using time_point_t = HttpCircuitBreaker::time_point_t;
+	using ms = std::chrono::milliseconds;
+
+	const time_point_t start = std::chrono::steady_clock::now();
+	const std::string host = "https://example.com";
+
+	HttpCircuitBreakerPolicy make_policy() {
+		HttpCircuitBreakerPolicy policy;
+		policy.failure_rate   = 0.5;
+		policy.min_requests   = 4;
+		policy.window_ms      = 1000;
+		policy.open_ms        = 500;
+		policy.probe_requests = 1;
+		return policy;
+	}
+
+	/// Opens the circuit of `host` at time `now`.
+	void open_circuit(HttpCircuitBreaker& breaker, const HttpCircuitBreakerPolicy& policy, time_point_t now) {
+		for (std::size_t i = 0; i < policy.min_requests; ++i) {
+			breaker.record(host, policy, true, now);
+		}
+	}
+
+	void test_is_failure() {
+		const auto policy = make_policy();
+		HttpResponse response;
+		response.status_code = 200;
+		KURLYK_CHECK(!policy.is_failure(response));
+		response.status_code = 503;
+		KURLYK_CHECK(policy.is_failure(response));
+		response.status_code = 404;
+		KURLYK_CHECK(!policy.is_failure(response));
+		response.error_code = kurlyk::utils::make_error_code(CURLE_COULDNT_CONNECT);
+		KURLYK_CHECK(policy.is_failure(response));
+	}
+
+	void test_open() {
+		const auto policy = make_policy();
+		HttpCircuitBreaker breaker;
+		KURLYK_CHECK(breaker.allow(host, policy, start));
+
+		// Fewer than min_requests responses never open the circuit
+		KURLYK_CHECK(!breaker.record(host, policy, true, start));
+		KURLYK_CHECK(!breaker.record(host, policy, true, start));
+		KURLYK_CHECK(!breaker.record(host, policy, true, start));
+		KURLYK_CHECK(breaker.allow(host, policy, start));
+
+		// Below the failure rate the circuit stays closed
+		HttpCircuitBreaker mixed;
+		KURLYK_CHECK(!mixed.record(host, policy, true, start));
+		KURLYK_CHECK(!mixed.record(host, policy, false, start));
+		KURLYK_CHECK(!mixed.record(host, policy, false, start));
+		KURLYK_CHECK(!mixed.record(host, policy, false, start));
+		KURLYK_CHECK(!mixed.record(host, policy, true, start));
+		KURLYK_CHECK(mixed.allow(host, policy, start));
+
+		// Reaching it opens the circuit of this host only
+		KURLYK_CHECK(mixed.record(host, policy, true, start));
+		KURLYK_CHECK(!mixed.allow(host, policy, start));
+		KURLYK_CHECK(mixed.allow("https://other.example.com", policy, start));
+
+		// Outcomes of requests sent before the circuit opened do not change it
+		KURLYK_CHECK(!mixed.record(host, policy, true, start + ms(1)));
+		KURLYK_CHECK(!mixed.record(host, policy, false, start + ms(1)));
+		KURLYK_CHECK(!mixed.allow(host, policy, start + ms(499)));
+	}
+
+	void test_window() {
+		const auto policy = make_policy();
+		HttpCircuitBreaker breaker;
+		KURLYK_CHECK(!breaker.record(host, policy, true, start));
+		KURLYK_CHECK(!breaker.record(host, policy, true, start));
+		KURLYK_CHECK(!breaker.record(host, policy, true, start));
+
+		// A new window starts the count over
+		KURLYK_CHECK(!breaker.record(host, policy, true, start + ms(1000)));
+		KURLYK_CHECK(breaker.allow(host, policy, start + ms(1000)));
+		KURLYK_CHECK(!breaker.record(host, policy, true, start + ms(1001)));
+		KURLYK_CHECK(!breaker.record(host, policy, true, start + ms(1002)));
+		KURLYK_CHECK(breaker.record(host, policy, true, start + ms(1003)));
+	}
+
+	void test_probe_success() {
+		auto policy = make_policy();
+		policy.probe_requests = 2;
+		HttpCircuitBreaker breaker;
+		open_circuit(breaker, policy, start);
+		KURLYK_CHECK(!breaker.allow(host, policy, start + ms(499)));
+
+		// Half-open: up to probe_requests requests are let through
+		const auto half_open = start + ms(500);
+		KURLYK_CHECK(breaker.allow(host, policy, half_open));
+		breaker.on_dispatch(host);
+		KURLYK_CHECK(breaker.allow(host, policy, half_open));
+		breaker.on_dispatch(host);
+		KURLYK_CHECK(!breaker.allow(host, policy, half_open));
+
+		// probe_requests successes close the circuit
+		KURLYK_CHECK(!breaker.record(host, policy, false, half_open + ms(10)));
+		KURLYK_CHECK(!breaker.allow(host, policy, half_open + ms(10)));
+		KURLYK_CHECK(!breaker.record(host, policy, false, half_open + ms(20)));
+		KURLYK_CHECK(breaker.allow(host, policy, half_open + ms(20)));
+		KURLYK_CHECK(breaker.allow(host, policy, half_open + ms(20)));
+	}
+
+	void test_probe_failure() {
+		const auto policy = make_policy();
+		HttpCircuitBreaker breaker;
+		open_circuit(breaker, policy, start);
+
+		const auto half_open = start + ms(500);
+		KURLYK_CHECK(breaker.allow(host, policy, half_open));
+		breaker.on_dispatch(host);
+
+		// A failed probe opens the circuit for another open_ms
+		KURLYK_CHECK(breaker.record(host, policy, true, half_open + ms(10)));
+		KURLYK_CHECK(!breaker.allow(host, policy, half_open + ms(509)));
+		KURLYK_CHECK(breaker.allow(host, policy, half_open + ms(510)));
+	}
+
+	void test_stale_probe() {
+		const auto policy = make_policy();
+		HttpCircuitBreaker breaker;
+		open_circuit(breaker, policy, start);
+
+		const auto half_open = start + ms(500);
+		KURLYK_CHECK(breaker.allow(host, policy, half_open));
+		breaker.on_dispatch(host);
+		KURLYK_CHECK(!breaker.allow(host, policy, half_open + ms(499)));
+
+		// The probe never completed, e.g. it was cancelled: a new one is admitted after open_ms
+		KURLYK_CHECK(breaker.allow(host, policy, half_open + ms(500)));
+		breaker.on_dispatch(host);
+		KURLYK_CHECK(!breaker.allow(host, policy, half_open + ms(501)));
+		KURLYK_CHECK(!breaker.record(host, policy, false, half_open + ms(600)));
+		KURLYK_CHECK(breaker.allow(host, policy, half_open + ms(600)));
+	}
+
+} // namespace
+
+int main() {
+	test_is_failure();
+	test_open();
+	test_window();
+	test_probe_success();
+	test_probe_failure();
+	test_stale_probe();
+	return kurlyk::unit_test::report("http_circuit_breaker_test");
+}
@@ -0,0 +1,106 @@
+#include <kurlyk.hpp>
+#include "unit_test.hpp"
+
+using kurlyk::HttpCoalesceGroup;
+using kurlyk::HttpResponse;
+using kurlyk::HttpResponsePtr;
+
+namespace {
+
+	/// Responses received by the callback of one waiter.
+	using received_t = std::vector<HttpResponsePtr>;
+
+	kurlyk::HttpResponseCallback make_waiter_callback(received_t& received) {
+		return [&received](HttpResponsePtr response) {
+			received.push_back(std::move(response));
+		};
+	}
+
+	HttpResponsePtr make_response(long status_code, const std::string& content, bool ready = true) {
+		HttpResponsePtr response(new HttpResponse());
+		response->status_code = status_code;
+		response->content = content;
+		response->ready = ready;
+		return response;
+	}
+
+	void test_delivery() {
+		auto group = std::make_shared<HttpCoalesceGroup>("key", 7);
+		KURLYK_CHECK(group->get_key() == "key");
+		KURLYK_CHECK(group->get_transfer_id() == 7);
+
+		received_t first, second;
+		KURLYK_CHECK(group->add_waiter(1, make_waiter_callback(first)));
+		KURLYK_CHECK(group->add_waiter(2, make_waiter_callback(second)));
+
+		std::vector<uint64_t> closed_ids;
+		auto callback = group->make_callback([&closed_ids](
+				const HttpCoalesceGroup&,
+				const std::list<HttpCoalesceGroup::Waiter>& waiters) {
+			for (const auto& waiter : waiters) closed_ids.push_back(waiter.request_id);
+		});
+
+		// Each waiter receives its own copy of every response
+		callback(make_response(0, "partial", false));
+		KURLYK_CHECK(closed_ids.empty());
+		callback(make_response(200, "body"));
+		KURLYK_CHECK((closed_ids == std::vector<uint64_t>{1, 2}));
+		KURLYK_CHECK(first.size() == 2 && second.size() == 2);
+		if (first.size() != 2 || second.size() != 2) return;
+		KURLYK_CHECK(!first[0]->ready && first[0]->content == "partial");
+		KURLYK_CHECK(first[1]->ready && first[1]->status_code == 200 && first[1]->content == "body");
+		KURLYK_CHECK(second[1]->ready && second[1]->content == "body");
+		KURLYK_CHECK(first[1].get() != second[1].get());
+
+		// The transfer has completed
+		received_t late;
+		KURLYK_CHECK(!group->add_waiter(3, make_waiter_callback(late)));
+		std::vector<HttpCoalesceGroup::Waiter> removed;
+		KURLYK_CHECK(!group->remove_waiters(std::set<uint64_t>{1}, removed));
+		KURLYK_CHECK(removed.empty());
+	}
+
+	void test_detach() {
+		auto group = std::make_shared<HttpCoalesceGroup>("key", 7);
+		received_t first, second;
+		group->add_waiter(1, make_waiter_callback(first));
+		group->add_waiter(2, make_waiter_callback(second));
+
+		// Detaching one waiter keeps the transfer
+		std::vector<HttpCoalesceGroup::Waiter> removed;
+		KURLYK_CHECK(!group->remove_waiters(std::set<uint64_t>{1, 99}, removed));
+		KURLYK_CHECK(removed.size() == 1 && removed[0].request_id == 1);
+		KURLYK_CHECK(!group->remove_waiters(std::set<uint64_t>{99}, removed));
+		KURLYK_CHECK(removed.size() == 1);
+
+		auto callback = group->make_callback(nullptr);
+		callback(make_response(200, "body"));
+		KURLYK_CHECK(first.empty());
+		KURLYK_CHECK(second.size() == 1);
+
+		// Detaching the last waiter abandons the transfer
+		auto abandoned = std::make_shared<HttpCoalesceGroup>("key", 8);
+		abandoned->add_waiter(1, make_waiter_callback(first));
+		removed.clear();
+		KURLYK_CHECK(abandoned->remove_waiters(std::set<uint64_t>{1}, removed));
+		KURLYK_CHECK(removed.size() == 1);
+		KURLYK_CHECK(!abandoned->add_waiter(2, make_waiter_callback(second)));
+
+		int closed = 0;
+		callback = abandoned->make_callback([&closed](
+				const HttpCoalesceGroup&,
+				const std::list<HttpCoalesceGroup::Waiter>& waiters) {
+			if (waiters.empty()) ++closed;
+		});
+		callback(make_response(499, ""));
+		KURLYK_CHECK(closed == 1);
+		KURLYK_CHECK(first.empty());
+	}
+
+} // namespace
+
+int main() {
+	test_delivery();
+	test_detach();
+	return kurlyk::unit_test::report("http_coalesce_group_test");
+}
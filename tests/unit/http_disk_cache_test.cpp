@@ -0,0 +1,239 @@
+#include <kurlyk.hpp>
+#include "unit_test.hpp"
+
+using kurlyk::HttpCacheEntry;
+using kurlyk::HttpDiskCache;
+
+namespace {
+
+	namespace fs = std::filesystem;
+
+	/// Creates an empty directory for a test and removes it when the test ends.
+	class TempDirectory {
+	public:
+		explicit TempDirectory(const std::string& name)
+			: m_path(fs::temp_directory_path() / ("kurlyk_" + name + "_" + std::to_string(
+				std::chrono::steady_clock::now().time_since_epoch().count()))) {
+			std::error_code ec;
+			fs::remove_all(m_path, ec);
+		}
+
+		~TempDirectory() {
+			std::error_code ec;
+			fs::remove_all(m_path, ec);
+		}
+
+		std::string path() const { return m_path.u8string(); }
+
+		/// Returns the concatenated contents of the segment files.
+		std::string read_all() const {
+			std::string data;
+			for (const auto& item : fs::directory_iterator(m_path)) {
+				std::ifstream file(item.path(), std::ios::binary);
+				data.append(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			}
+			return data;
+		}
+
+		/// Returns the number of segment files.
+		std::size_t count_files() const {
+			std::size_t count = 0;
+			for (const auto& item : fs::directory_iterator(m_path)) {
+				if (item.path().filename().string().compare(0, 8, "segment-") == 0) ++count;
+			}
+			return count;
+		}
+
+	private:
+		fs::path m_path;
+	};
+
+	const auto expires_at = std::chrono::system_clock::time_point(std::chrono::milliseconds(1893456000123));
+
+	HttpCacheEntry make_entry(const std::string& content) {
+		HttpCacheEntry entry;
+		entry.status_code = 200;
+		entry.headers.emplace("Content-Type", "text/plain");
+		entry.headers.emplace("ETag", "\"" + content.substr(0, 8) + "\"");
+		entry.content = content;
+		entry.expires_at = expires_at;
+		return entry;
+	}
+
+	void test_reopen() {
+		TempDirectory directory("reopen");
+		const std::string key = "GET https://example.com/a Cookie: session=secret-token";
+		{
+			HttpDiskCache cache(directory.path(), 1024 * 1024, 64 * 1024);
+			KURLYK_CHECK(cache.is_open());
+			KURLYK_CHECK(cache.find(key) == nullptr);
+			cache.store(key, make_entry("first"));
+			cache.store(key, make_entry("second"));
+			cache.store("other", make_entry("other"));
+			auto entry = cache.find(key);
+			KURLYK_CHECK(entry != nullptr && entry->content == "second");
+		}
+
+		// The fingerprint itself is never written
+		const std::string data = directory.read_all();
+		KURLYK_CHECK(data.find("secret-token") == std::string::npos);
+		KURLYK_CHECK(data.find("second") != std::string::npos);
+#		if !defined(_WIN32)
+		for (const auto& item : fs::directory_iterator(directory.path())) {
+			const auto perms = item.status().permissions();
+			KURLYK_CHECK((perms & (fs::perms::group_all | fs::perms::others_all)) == fs::perms::none);
+		}
+		KURLYK_CHECK((fs::status(directory.path()).permissions() & fs::perms::others_all) == fs::perms::none);
+#		endif
+
+		HttpDiskCache cache(directory.path(), 1024 * 1024, 64 * 1024);
+		auto entry = cache.find(key);
+		KURLYK_CHECK(entry != nullptr);
+		if (!entry) return;
+		KURLYK_CHECK(entry->status_code == 200);
+		KURLYK_CHECK(entry->content == "second");
+		KURLYK_CHECK(entry->etag == "\"second\"");
+		KURLYK_CHECK(entry->headers.count("content-type") == 1);
+		KURLYK_CHECK(entry->expires_at == expires_at);
+		KURLYK_CHECK(cache.find("other") != nullptr);
+	}
+
+	void test_erase() {
+		TempDirectory directory("erase");
+		{
+			HttpDiskCache cache(directory.path(), 1024 * 1024, 64 * 1024);
+			cache.store("a", make_entry("value-a"));
+			cache.store("b", make_entry("value-b"));
+			cache.erase("a");
+			cache.erase("missing");
+			KURLYK_CHECK(cache.find("a") == nullptr);
+		}
+
+		// The tombstone survives a restart
+		{
+			HttpDiskCache cache(directory.path(), 1024 * 1024, 64 * 1024);
+			KURLYK_CHECK(cache.find("a") == nullptr);
+			KURLYK_CHECK(cache.find("b") != nullptr);
+			cache.clear();
+			KURLYK_CHECK(cache.find("b") == nullptr);
+		}
+
+		HttpDiskCache cache(directory.path(), 1024 * 1024, 64 * 1024);
+		KURLYK_CHECK(cache.find("b") == nullptr);
+	}
+
+	void test_rollover() {
+		TempDirectory directory("rollover");
+		const std::string content(1500, 'x');
+		{
+			// Two segments of 4 KiB hold at most four records of this size
+			HttpDiskCache cache(directory.path(), 8 * 1024, 4 * 1024);
+			for (int i = 0; i < 10; ++i) {
+				cache.store("key-" + std::to_string(i), make_entry(content));
+			}
+			KURLYK_CHECK(directory.count_files() == 2);
+			KURLYK_CHECK(cache.find("key-0") == nullptr);
+			KURLYK_CHECK(cache.find("key-5") == nullptr);
+			KURLYK_CHECK(cache.find("key-6") != nullptr);
+			KURLYK_CHECK(cache.find("key-9") != nullptr);
+
+			// Larger than a segment
+			cache.store("large", make_entry(std::string(8 * 1024, 'y')));
+			KURLYK_CHECK(cache.find("large") == nullptr);
+		}
+
+		HttpDiskCache cache(directory.path(), 8 * 1024, 4 * 1024);
+		KURLYK_CHECK(cache.find("key-5") == nullptr);
+		for (int i = 6; i < 10; ++i) {
+			auto entry = cache.find("key-" + std::to_string(i));
+			KURLYK_CHECK(entry != nullptr && entry->content == content);
+		}
+	}
+
+	void test_torn_record() {
+		TempDirectory directory("torn");
+		{
+			HttpDiskCache cache(directory.path(), 1024 * 1024, 64 * 1024);
+			cache.store("a", make_entry("value-a"));
+			cache.store("b", make_entry("value-b"));
+		}
+
+		// Corrupt the body of the second record, as if the process died while writing it
+		for (const auto& item : fs::directory_iterator(directory.path())) {
+			std::fstream file(item.path(), std::ios::binary | std::ios::in | std::ios::out);
+			std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			const std::size_t pos = data.find("value-b");
+			if (pos == std::string::npos) continue;
+			file.seekp(static_cast<std::streamoff>(pos));
+			file.put('V');
+		}
+
+		{
+			HttpDiskCache cache(directory.path(), 1024 * 1024, 64 * 1024);
+			KURLYK_CHECK(cache.find("a") != nullptr);
+			KURLYK_CHECK(cache.find("b") == nullptr);
+
+			// New records overwrite the invalid one
+			cache.store("c", make_entry("value-c"));
+		}
+
+		HttpDiskCache cache(directory.path(), 1024 * 1024, 64 * 1024);
+		KURLYK_CHECK(cache.find("a") != nullptr);
+		KURLYK_CHECK(cache.find("b") == nullptr);
+		KURLYK_CHECK(cache.find("c") != nullptr);
+	}
+
+	void test_lock() {
+		TempDirectory directory("lock");
+		{
+			HttpDiskCache cache(directory.path(), 1024 * 1024, 64 * 1024);
+			KURLYK_CHECK(cache.is_open());
+			cache.store("a", make_entry("value-a"));
+
+			// A second store on the same directory neither reads nor writes
+			HttpDiskCache second(directory.path(), 1024 * 1024, 64 * 1024);
+			KURLYK_CHECK(!second.is_open());
+			KURLYK_CHECK(second.find("a") == nullptr);
+			second.store("b", make_entry("value-b"));
+			second.clear();
+			KURLYK_CHECK(cache.find("a") != nullptr);
+		}
+
+		// The lock is released with the store
+		HttpDiskCache cache(directory.path(), 1024 * 1024, 64 * 1024);
+		KURLYK_CHECK(cache.is_open());
+		KURLYK_CHECK(cache.find("a") != nullptr);
+		KURLYK_CHECK(cache.find("b") == nullptr);
+	}
+
+	void test_sha256() {
+		auto hex = [](const std::string& digest) {
+			static const char digits[] = "0123456789abcdef";
+			std::string result;
+			for (unsigned char c : digest) {
+				result += digits[c >> 4];
+				result += digits[c & 0x0F];
+			}
+			return result;
+		};
+		KURLYK_CHECK(hex(kurlyk::utils::sha256("")) ==
+			"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+		KURLYK_CHECK(hex(kurlyk::utils::sha256("abc")) ==
+			"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+		KURLYK_CHECK(hex(kurlyk::utils::sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")) ==
+			"248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+		KURLYK_CHECK(hex(kurlyk::utils::sha256(std::string(1000, 'a'))) ==
+			"41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3");
+	}
+
+} // namespace
+
+int main() {
+	test_reopen();
+	test_erase();
+	test_rollover();
+	test_torn_record();
+	test_lock();
+	test_sha256();
+	return kurlyk::unit_test::report("http_disk_cache_test");
+}
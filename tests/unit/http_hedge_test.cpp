@@ -0,0 +1,129 @@
+#include <kurlyk.hpp>
+#include "unit_test.hpp"
+
+using kurlyk::HttpHedgeGroup;
+using kurlyk::HttpHostLatency;
+using kurlyk::HttpResponse;
+using kurlyk::HttpResponsePtr;
+
+namespace {
+
+	const std::string host = "https://example.com";
+
+	HttpResponsePtr make_response(long status_code, bool is_error = false, bool ready = true) {
+		HttpResponsePtr response(new HttpResponse());
+		response->status_code = status_code;
+		if (is_error) response->error_code = kurlyk::utils::make_error_code(CURLE_COULDNT_CONNECT);
+		response->ready = ready;
+		return response;
+	}
+
+	/// Result of a completed hedge group.
+	struct Finish {
+		int      count = 0;
+		bool     is_hedge_winner = false;
+		uint64_t cancel_id = 0;
+	};
+
+	std::shared_ptr<HttpHedgeGroup> make_group(std::vector<long>& statuses, Finish& finish) {
+		return std::make_shared<HttpHedgeGroup>(
+			[&statuses](HttpResponsePtr response) { statuses.push_back(response->status_code); },
+			host, 1, 2,
+			[&finish](const HttpHedgeGroup&, const HttpResponse&, bool is_hedge_winner, uint64_t cancel_id) {
+				++finish.count;
+				finish.is_hedge_winner = is_hedge_winner;
+				finish.cancel_id = cancel_id;
+			});
+	}
+
+	void test_percentile() {
+		HttpHostLatency latency;
+		long value = 0;
+		KURLYK_CHECK(!latency.get_percentile_ms(host, 0.95, 1, value));
+
+		for (int i = 1; i <= 100; ++i) {
+			latency.record(host, i / 1000.0);
+		}
+		latency.record(host, -1.0);
+		KURLYK_CHECK(!latency.get_percentile_ms(host, 0.95, 101, value));
+		KURLYK_CHECK(latency.get_percentile_ms(host, 0.95, 100, value));
+		KURLYK_CHECK(value == 96);
+		KURLYK_CHECK(latency.get_percentile_ms(host, 0.0, 1, value));
+		KURLYK_CHECK(value == 1);
+		KURLYK_CHECK(latency.get_percentile_ms(host, 2.0, 1, value));
+		KURLYK_CHECK(value == 100);
+		KURLYK_CHECK(!latency.get_percentile_ms("https://other.example.com", 0.5, 1, value));
+
+		// Only the last WINDOW_SIZE latencies are kept
+		for (std::size_t i = 0; i < HttpHostLatency::WINDOW_SIZE; ++i) {
+			latency.record(host, 1.0);
+		}
+		KURLYK_CHECK(latency.get_percentile_ms(host, 0.0, 1, value));
+		KURLYK_CHECK(value == 1000);
+	}
+
+	void test_primary_wins() {
+		std::vector<long> statuses;
+		Finish finish;
+		auto group = make_group(statuses, finish);
+		auto primary = group->make_callback(false);
+		auto hedge = group->make_callback(true);
+		KURLYK_CHECK(group->try_start_hedge());
+		KURLYK_CHECK(!group->try_start_hedge());
+
+		// Intermediate responses are forwarded for the primary copy only
+		primary(make_response(503, false, false));
+		hedge(make_response(503, false, false));
+		KURLYK_CHECK(statuses == std::vector<long>{503});
+
+		primary(make_response(200));
+		KURLYK_CHECK(group->is_done());
+		KURLYK_CHECK(finish.count == 1 && !finish.is_hedge_winner && finish.cancel_id == 2);
+
+		// The losing copy is dropped
+		hedge(make_response(200));
+		KURLYK_CHECK((statuses == std::vector<long>{503, 200}));
+		KURLYK_CHECK(finish.count == 1);
+	}
+
+	void test_hedge_wins() {
+		std::vector<long> statuses;
+		Finish finish;
+		auto group = make_group(statuses, finish);
+		auto primary = group->make_callback(false);
+		auto hedge = group->make_callback(true);
+		KURLYK_CHECK(group->try_start_hedge());
+
+		// An error does not complete the group while the other copy is in flight
+		primary(make_response(0, true));
+		KURLYK_CHECK(!group->is_done());
+		hedge(make_response(200));
+		KURLYK_CHECK(statuses == std::vector<long>{200});
+		KURLYK_CHECK(finish.count == 1 && finish.is_hedge_winner && finish.cancel_id == 0);
+	}
+
+	void test_not_hedged() {
+		std::vector<long> statuses;
+		Finish finish;
+		auto group = make_group(statuses, finish);
+		KURLYK_CHECK(group->get_dispatch_time() == HttpHedgeGroup::time_point_t());
+		const auto now = std::chrono::steady_clock::now();
+		group->set_dispatch_time(now);
+		KURLYK_CHECK(group->get_dispatch_time() == now);
+
+		// Without a hedged copy an error completes the group
+		group->make_callback(false)(make_response(0, true));
+		KURLYK_CHECK(statuses == std::vector<long>{0});
+		KURLYK_CHECK(finish.count == 1 && finish.cancel_id == 0);
+		KURLYK_CHECK(!group->try_start_hedge());
+	}
+
+} // namespace
+
+int main() {
+	test_percentile();
+	test_primary_wins();
+	test_hedge_wins();
+	test_not_hedged();
+	return kurlyk::unit_test::report("http_hedge_test");
+}
@@ -0,0 +1,119 @@
+#include <kurlyk.hpp>
+#include "unit_test.hpp"
+
+using kurlyk::HttpPriorityQueue;
+using kurlyk::HttpRequest;
+using kurlyk::HttpRequestContext;
+using kurlyk::RequestPriority;
+
+namespace {
+
+	const HttpPriorityQueue::time_point_t start = std::chrono::steady_clock::now();
+
+	HttpPriorityQueue::time_point_t at(long ms) {
+		return start + std::chrono::milliseconds(ms);
+	}
+
+	/// Creates a request context queued at the given time; the URL identifies it in checks.
+	HttpPriorityQueue::context_ptr_t make_context(const std::string& name, RequestPriority priority, long queued_ms) {
+		std::unique_ptr<HttpRequest> request(new HttpRequest());
+		request->url = name;
+		request->priority = priority;
+		HttpPriorityQueue::context_ptr_t context(new HttpRequestContext(std::move(request), nullptr));
+		context->start_time = at(queued_ms);
+		return context;
+	}
+
+	/// Pops every request at the given time and returns their names in order.
+	std::vector<std::string> drain(HttpPriorityQueue& queue, HttpPriorityQueue::time_point_t now) {
+		std::vector<std::string> names;
+		while (!queue.empty()) {
+			names.push_back(queue.top(now)->request->url);
+			queue.pop();
+		}
+		return names;
+	}
+
+	void test_classes() {
+		HttpPriorityQueue queue;
+		queue.push(make_context("low", RequestPriority::RP_LOW, 0));
+		queue.push(make_context("normal-1", RequestPriority::RP_NORMAL, 0));
+		queue.push(make_context("critical", RequestPriority::RP_CRITICAL, 0));
+		queue.push(make_context("high", RequestPriority::RP_HIGH, 0));
+		queue.push(make_context("normal-2", RequestPriority::RP_NORMAL, 0));
+		KURLYK_CHECK(queue.size() == 5);
+		KURLYK_CHECK((drain(queue, at(0)) == std::vector<std::string>{
+			"critical", "high", "normal-1", "normal-2", "low"}));
+		KURLYK_CHECK(queue.empty());
+	}
+
+	void test_aging() {
+		const long aging_ms = KURLYK_HTTP_PRIORITY_AGING_MS;
+		if (aging_ms <= 0) return;
+
+		// A low request that waited one period ties with normal ones and wins by age
+		HttpPriorityQueue queue;
+		queue.push(make_context("low", RequestPriority::RP_LOW, 0));
+		queue.push(make_context("normal", RequestPriority::RP_NORMAL, aging_ms));
+		KURLYK_CHECK(queue.top(at(aging_ms))->request->url == "low");
+
+		// Before a full period has passed it is not promoted
+		KURLYK_CHECK(queue.top(at(aging_ms - 1))->request->url == "normal");
+
+		// Requests are promoted at most to RP_HIGH and never overtake RP_CRITICAL
+		HttpPriorityQueue capped;
+		capped.push(make_context("old-low", RequestPriority::RP_LOW, 0));
+		capped.push(make_context("critical", RequestPriority::RP_CRITICAL, 10 * aging_ms));
+		capped.push(make_context("high", RequestPriority::RP_HIGH, 10 * aging_ms));
+		KURLYK_CHECK((drain(capped, at(10 * aging_ms)) == std::vector<std::string>{
+			"critical", "old-low", "high"}));
+	}
+
+	void test_erase() {
+		HttpPriorityQueue queue;
+		auto first = make_context("first", RequestPriority::RP_NORMAL, 0);
+		auto second = make_context("second", RequestPriority::RP_NORMAL, 1);
+		auto third = make_context("third", RequestPriority::RP_HIGH, 2);
+		const HttpRequestContext* first_ptr = first.get();
+		const HttpRequestContext* second_ptr = second.get();
+		const HttpRequestContext* third_ptr = third.get();
+		queue.push(std::move(first));
+		queue.push(std::move(second));
+		queue.push(std::move(third));
+
+		auto erased = queue.erase(second_ptr);
+		KURLYK_CHECK(erased && erased.get() == second_ptr);
+		KURLYK_CHECK(queue.size() == 2);
+		KURLYK_CHECK(!queue.erase(second_ptr));
+
+		// A popped request can no longer be erased
+		KURLYK_CHECK(queue.top(at(2)).get() == third_ptr);
+		queue.pop();
+		KURLYK_CHECK(!queue.erase(third_ptr));
+
+		KURLYK_CHECK(queue.erase(first_ptr));
+		KURLYK_CHECK(queue.empty());
+	}
+
+	void test_splice() {
+		HttpPriorityQueue queue;
+		queue.push(make_context("low", RequestPriority::RP_LOW, 0));
+		queue.push(make_context("critical", RequestPriority::RP_CRITICAL, 0));
+		queue.push(make_context("normal", RequestPriority::RP_NORMAL, 0));
+		std::list<HttpPriorityQueue::context_ptr_t> out;
+		queue.splice_to(out);
+		KURLYK_CHECK(queue.empty());
+		std::vector<std::string> names;
+		for (const auto& context : out) names.push_back(context->request->url);
+		KURLYK_CHECK((names == std::vector<std::string>{"critical", "normal", "low"}));
+	}
+
+} // namespace
+
+int main() {
+	test_classes();
+	test_aging();
+	test_erase();
+	test_splice();
+	return kurlyk::unit_test::report("http_priority_queue_test");
+}
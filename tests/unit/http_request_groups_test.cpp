@@ -0,0 +1,90 @@
+#include <kurlyk.hpp>
+#include "unit_test.hpp"
+
+using kurlyk::HttpRequestGroups;
+
+namespace {
+
+	/// Returns IDs from a sequence starting at 1000, like HttpRequestManager::generate_request_id().
+	std::function<uint64_t()> make_generator() {
+		auto next_id = std::make_shared<uint64_t>(1000);
+		return [next_id]() { return (*next_id)++; };
+	}
+
+	void test_groups() {
+		HttpRequestGroups groups;
+		const auto generate_id = make_generator();
+		groups.add(1, 10, {10}, {}, generate_id);
+		groups.add(2, 10, {10}, {}, generate_id);
+		groups.add(3, 20, {20}, {}, generate_id);
+
+		std::map<uint64_t, int> requests;
+		requests[10];
+		groups.expand(requests);
+		KURLYK_CHECK(requests.size() == 3);
+		KURLYK_CHECK(requests.count(1) && requests.count(2) && !requests.count(3));
+
+		KURLYK_CHECK(groups.get_order_keys(3) == std::vector<uint64_t>{20});
+		KURLYK_CHECK(groups.get_order_keys(10) == std::vector<uint64_t>{10});
+		KURLYK_CHECK(groups.get_order_keys(99) == std::vector<uint64_t>{99});
+
+		groups.remove(1);
+		groups.remove(2);
+		groups.remove(2);
+		requests.clear();
+		requests[10];
+		groups.expand(requests);
+		KURLYK_CHECK(requests.size() == 1);
+	}
+
+	void test_tags() {
+		HttpRequestGroups groups;
+		const auto generate_id = make_generator();
+		KURLYK_CHECK(groups.find_tag("btc") == 0);
+
+		groups.add(1, 10, {10}, {"btc", "orders"}, generate_id);
+		groups.add(2, 10, {10}, {"btc"}, generate_id);
+		const uint64_t btc_id = groups.find_tag("btc");
+		const uint64_t orders_id = groups.find_tag("orders");
+		KURLYK_CHECK(btc_id == 1000);
+		KURLYK_CHECK(orders_id == 1001);
+		KURLYK_CHECK(groups.get_tag_count() == 2);
+
+		std::map<uint64_t, int> requests;
+		requests[btc_id];
+		groups.expand(requests);
+		KURLYK_CHECK(requests.count(1) && requests.count(2));
+		KURLYK_CHECK(groups.get_order_keys(orders_id) == std::vector<uint64_t>{10});
+
+		// A tag keeps its ID while any of its requests is in flight
+		groups.remove(1);
+		KURLYK_CHECK(groups.find_tag("orders") == 0);
+		KURLYK_CHECK(groups.find_tag("btc") == btc_id);
+		groups.remove(2);
+		KURLYK_CHECK(groups.find_tag("btc") == 0);
+		KURLYK_CHECK(groups.get_tag_count() == 0);
+
+		// A tag used again gets a new ID
+		groups.add(3, 30, {}, {"btc"}, generate_id);
+		KURLYK_CHECK(groups.find_tag("btc") == 1002);
+		groups.remove(3);
+	}
+
+	void test_bounded() {
+		HttpRequestGroups groups;
+		const auto generate_id = make_generator();
+		for (uint64_t i = 1; i <= 1000; ++i) {
+			groups.add(i, i, {}, {"order-" + std::to_string(i)}, generate_id);
+			groups.remove(i);
+		}
+		KURLYK_CHECK(groups.get_tag_count() == 0);
+	}
+
+} // namespace
+
+int main() {
+	test_groups();
+	test_tags();
+	test_bounded();
+	return kurlyk::unit_test::report("http_request_groups_test");
+}
@@ -0,0 +1,203 @@
+#include <ctime>
+#include <kurlyk.hpp>
+#include "unit_test.hpp"
+
+using kurlyk::Headers;
+using kurlyk::HttpResponse;
+using kurlyk::HttpResponseCache;
+
+namespace {
+
+	using clock_t      = HttpResponseCache::clock_t;
+	using time_point_t = HttpResponseCache::time_point_t;
+
+	const time_point_t now = clock_t::from_time_t(clock_t::to_time_t(clock_t::now()));
+
+	/// Formats a time as an HTTP date.
+	std::string http_date(time_point_t time) {
+		const std::time_t seconds = clock_t::to_time_t(time);
+		char buffer[64];
+		std::tm tm_utc;
+#		if defined(_WIN32)
+		gmtime_s(&tm_utc, &seconds);
+#		else
+		gmtime_r(&seconds, &tm_utc);
+#		endif
+		std::strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &tm_utc);
+		return buffer;
+	}
+
+	HttpResponse make_response(const Headers& headers, const std::string& content = "body") {
+		HttpResponse response;
+		response.status_code = 200;
+		response.headers = headers;
+		response.content = content;
+		return response;
+	}
+
+	HttpResponseCache::entry_ptr_t make_entry(const std::string& cache_control, const std::string& etag = std::string()) {
+		Headers headers;
+		if (!cache_control.empty()) headers.emplace("Cache-Control", cache_control);
+		if (!etag.empty()) headers.emplace("ETag", etag);
+		return HttpResponseCache::make_entry(make_response(headers), now);
+	}
+
+	void test_directives() {
+		long value = 0;
+		KURLYK_CHECK(HttpResponseCache::has_directive("public, Max-Age=60", "max-age", &value));
+		KURLYK_CHECK(value == 60);
+		KURLYK_CHECK(HttpResponseCache::has_directive("max-age=\"30\"", "max-age", &value));
+		KURLYK_CHECK(value == 30);
+		KURLYK_CHECK(HttpResponseCache::has_directive("private, no-cache", "no-cache", &value));
+		KURLYK_CHECK(value == -1);
+		KURLYK_CHECK(!HttpResponseCache::has_directive("s-maxage=10", "max-age"));
+		KURLYK_CHECK(!HttpResponseCache::has_directive("no-cache-ext", "no-cache"));
+	}
+
+	void test_freshness() {
+		auto entry = make_entry("max-age=60");
+		KURLYK_CHECK(entry != nullptr);
+		KURLYK_CHECK(HttpResponseCache::is_fresh(*entry, now + std::chrono::seconds(59)));
+		KURLYK_CHECK(!HttpResponseCache::is_fresh(*entry, now + std::chrono::seconds(60)));
+
+		// The age reported by an upstream cache shortens the lifetime
+		Headers aged;
+		aged.emplace("Cache-Control", "max-age=60");
+		aged.emplace("Age", "50");
+		entry = HttpResponseCache::make_entry(make_response(aged), now);
+		KURLYK_CHECK(entry != nullptr);
+		KURLYK_CHECK(entry->expires_at == now + std::chrono::seconds(10));
+
+		// Expires is relative to the Date of the response
+		Headers expires;
+		expires.emplace("Date", http_date(now - std::chrono::seconds(100)));
+		expires.emplace("Expires", http_date(now - std::chrono::seconds(70)));
+		entry = HttpResponseCache::make_entry(make_response(expires), now);
+		KURLYK_CHECK(entry != nullptr);
+		KURLYK_CHECK(entry->expires_at == now + std::chrono::seconds(30));
+
+		// max-age takes precedence over Expires
+		expires.emplace("Cache-Control", "max-age=5");
+		entry = HttpResponseCache::make_entry(make_response(expires), now);
+		KURLYK_CHECK(entry != nullptr);
+		KURLYK_CHECK(entry->expires_at == now + std::chrono::seconds(5));
+
+		// Only Last-Modified: 10% of the age of the resource
+		Headers heuristic;
+		heuristic.emplace("Date", http_date(now));
+		heuristic.emplace("Last-Modified", http_date(now - std::chrono::seconds(1000)));
+		entry = HttpResponseCache::make_entry(make_response(heuristic), now);
+		KURLYK_CHECK(entry != nullptr);
+		KURLYK_CHECK(entry->expires_at == now + std::chrono::seconds(100));
+		KURLYK_CHECK(HttpResponseCache::has_validators(*entry));
+	}
+
+	void test_not_stored() {
+		KURLYK_CHECK(make_entry("no-store", "\"v1\"") == nullptr);
+		KURLYK_CHECK(make_entry("max-age=60, No-Store") == nullptr);
+
+		Headers vary;
+		vary.emplace("Cache-Control", "max-age=60");
+		vary.emplace("Vary", "*");
+		KURLYK_CHECK(HttpResponseCache::make_entry(make_response(vary), now) == nullptr);
+
+		// Neither fresh nor revalidatable
+		KURLYK_CHECK(make_entry("") == nullptr);
+		KURLYK_CHECK(make_entry("no-cache") == nullptr);
+
+		// no-cache is stored but always revalidated
+		auto entry = make_entry("no-cache", "\"v1\"");
+		KURLYK_CHECK(entry != nullptr);
+		KURLYK_CHECK(!HttpResponseCache::is_fresh(*entry, now));
+		KURLYK_CHECK(entry->etag == "\"v1\"");
+	}
+
+	void test_revalidate() {
+		Headers headers;
+		headers.emplace("Cache-Control", "no-cache");
+		headers.emplace("ETag", "\"v1\"");
+		headers.emplace("Content-Type", "text/plain");
+		auto entry = HttpResponseCache::make_entry(make_response(headers, "cached"), now);
+		KURLYK_CHECK(entry != nullptr);
+
+		// The 304 headers replace the stored ones, the rest and the body are kept
+		HttpResponse not_modified;
+		not_modified.status_code = 304;
+		not_modified.headers.emplace("cache-control", "max-age=60");
+		not_modified.headers.emplace("ETag", "\"v2\"");
+		auto updated = HttpResponseCache::revalidate(*entry, not_modified, now);
+		KURLYK_CHECK(updated != nullptr);
+		KURLYK_CHECK(updated->status_code == 200);
+		KURLYK_CHECK(updated->content == "cached");
+		KURLYK_CHECK(updated->etag == "\"v2\"");
+		KURLYK_CHECK(updated->headers.count("Cache-Control") == 1);
+		KURLYK_CHECK(HttpResponseCache::get_header(updated->headers, "Content-Type") == "text/plain");
+		KURLYK_CHECK(HttpResponseCache::is_fresh(*updated, now + std::chrono::seconds(30)));
+		KURLYK_CHECK(entry->etag == "\"v1\"");
+
+		HttpResponse no_store;
+		no_store.status_code = 304;
+		no_store.headers.emplace("Cache-Control", "no-store");
+		KURLYK_CHECK(HttpResponseCache::revalidate(*entry, no_store, now) == nullptr);
+
+		auto response = HttpResponseCache::make_response(*updated);
+		KURLYK_CHECK(response->ready);
+		KURLYK_CHECK(response->status_code == 200);
+		KURLYK_CHECK(response->content == "cached");
+	}
+
+	void test_lru() {
+		auto entry = make_entry("max-age=60");
+		KURLYK_CHECK(entry != nullptr);
+
+		HttpResponseCache probe;
+		probe.store("a", entry);
+		const std::size_t entry_size = probe.get_size_bytes();
+		KURLYK_CHECK(entry_size > 0);
+
+		HttpResponseCache cache(entry_size * 2);
+		cache.store("a", entry);
+		cache.store("b", entry);
+		KURLYK_CHECK(cache.get_size_bytes() == entry_size * 2);
+
+		// "a" becomes the most recently used, so "b" is evicted
+		KURLYK_CHECK(cache.find("a") == entry);
+		cache.store("c", entry);
+		KURLYK_CHECK(cache.find("a") != nullptr);
+		KURLYK_CHECK(cache.find("b") == nullptr);
+		KURLYK_CHECK(cache.find("c") != nullptr);
+
+		// Replacing an entry does not count it twice
+		cache.store("c", entry);
+		KURLYK_CHECK(cache.get_size_bytes() == entry_size * 2);
+
+		cache.erase("a");
+		KURLYK_CHECK(cache.find("a") == nullptr);
+		KURLYK_CHECK(cache.get_size_bytes() == entry_size);
+
+		// An entry larger than the cache is not stored
+		HttpResponseCache small(entry_size - 1);
+		small.store("a", entry);
+		KURLYK_CHECK(small.find("a") == nullptr);
+		KURLYK_CHECK(small.get_size_bytes() == 0);
+
+		cache.set_max_bytes(0);
+		KURLYK_CHECK(cache.find("c") == nullptr);
+		KURLYK_CHECK(cache.get_size_bytes() == 0);
+
+		cache.set_max_bytes(entry_size * 2);
+		cache.store("a", entry);
+		cache.clear();
+		KURLYK_CHECK(cache.find("a") == nullptr);
+	}
+
+} // namespace
+
+int main() {
+	test_directives();
+	test_freshness();
+	test_not_stored();
+	test_revalidate();
+	test_lru();
+	return kurlyk::unit_test::report("http_response_cache_test");
+}
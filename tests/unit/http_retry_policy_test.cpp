@@ -0,0 +1,121 @@
+#include <kurlyk.hpp>
+#include "unit_test.hpp"
+
+using kurlyk::HttpResponse;
+using kurlyk::HttpRetryBudget;
+using kurlyk::HttpRetryPolicy;
+
+namespace {
+
+	const std::string host = "https://example.com";
+
+	HttpRetryPolicy make_policy() {
+		HttpRetryPolicy policy;
+		policy.base_delay_ms = 100;
+		policy.max_delay_ms  = 1000;
+		policy.multiplier    = 2.0;
+		policy.jitter        = 0.0;
+		return policy;
+	}
+
+	void test_should_retry() {
+		const auto policy = make_policy();
+		HttpResponse response;
+		response.status_code = 503;
+		KURLYK_CHECK(policy.should_retry(response, CURLE_OK));
+		response.status_code = 404;
+		KURLYK_CHECK(!policy.should_retry(response, CURLE_OK));
+		KURLYK_CHECK(policy.should_retry(response, CURLE_COULDNT_CONNECT));
+		KURLYK_CHECK(!policy.should_retry(response, CURLE_SSL_CACERT_BADFILE));
+	}
+
+	void test_backoff() {
+		const auto policy = make_policy();
+		const HttpResponse response;
+		KURLYK_CHECK(policy.get_retry_delay_ms(0, response) == 100);
+		KURLYK_CHECK(policy.get_retry_delay_ms(1, response) == 100);
+		KURLYK_CHECK(policy.get_retry_delay_ms(2, response) == 200);
+		KURLYK_CHECK(policy.get_retry_delay_ms(4, response) == 800);
+
+		// The delay is capped by max_delay_ms
+		KURLYK_CHECK(policy.get_retry_delay_ms(5, response) == 1000);
+		KURLYK_CHECK(policy.get_retry_delay_ms(100, response) == 1000);
+	}
+
+	void test_jitter() {
+		auto policy = make_policy();
+		policy.jitter = 0.5;
+		const HttpResponse response;
+		for (int i = 0; i < 100; ++i) {
+			const long delay_ms = policy.get_retry_delay_ms(3, response);
+			KURLYK_CHECK(delay_ms >= 200 && delay_ms <= 400);
+		}
+
+		// Full jitter never exceeds the computed delay
+		policy.jitter = 1.0;
+		for (int i = 0; i < 100; ++i) {
+			const long delay_ms = policy.get_retry_delay_ms(3, response);
+			KURLYK_CHECK(delay_ms >= 0 && delay_ms <= 400);
+		}
+	}
+
+	void test_retry_after() {
+		auto policy = make_policy();
+		HttpResponse response;
+		response.headers.emplace("Retry-After", "2");
+
+		// Retry-After raises the delay but does not lower it
+		const long delay_ms = policy.get_retry_delay_ms(1, response);
+		KURLYK_CHECK(delay_ms > 1000 && delay_ms <= 2000);
+		response.headers.clear();
+		response.headers.emplace("Retry-After", "0");
+		KURLYK_CHECK(policy.get_retry_delay_ms(2, response) == 200);
+
+		policy.honor_retry_after = false;
+		response.headers.clear();
+		response.headers.emplace("Retry-After", "2");
+		KURLYK_CHECK(policy.get_retry_delay_ms(1, response) == 100);
+	}
+
+	void test_budget() {
+		HttpRetryBudget budget;
+
+		// A new bucket starts full: max(1, ratio * 10 + min_per_second) tokens
+		KURLYK_CHECK(budget.try_withdraw(host, 0.2, 0.0));
+		KURLYK_CHECK(budget.try_withdraw(host, 0.2, 0.0));
+		KURLYK_CHECK(!budget.try_withdraw(host, 0.2, 0.0));
+
+		// Five requests pay for one retry
+		for (int i = 0; i < 4; ++i) budget.deposit(host, 0.2, 0.0);
+		KURLYK_CHECK(!budget.try_withdraw(host, 0.2, 0.0));
+		budget.deposit(host, 0.2, 0.0);
+		KURLYK_CHECK(budget.try_withdraw(host, 0.2, 0.0));
+
+		// The balance is capped
+		for (int i = 0; i < 100; ++i) budget.deposit(host, 0.2, 0.0);
+		KURLYK_CHECK(budget.try_withdraw(host, 0.2, 0.0));
+		KURLYK_CHECK(budget.try_withdraw(host, 0.2, 0.0));
+		KURLYK_CHECK(!budget.try_withdraw(host, 0.2, 0.0));
+
+		// Hosts have separate buckets, and a zero ratio disables the budget
+		KURLYK_CHECK(budget.try_withdraw("https://other.example.com", 0.2, 0.0));
+		KURLYK_CHECK(budget.try_withdraw(host, 0.0, 0.0));
+
+		// The bucket refills over time
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		KURLYK_CHECK(budget.try_withdraw(host, 0.2, 1000.0));
+
+		budget.clear();
+		KURLYK_CHECK(budget.try_withdraw(host, 0.2, 0.0));
+	}
+
+} // namespace
+
+int main() {
+	test_should_retry();
+	test_backoff();
+	test_jitter();
+	test_retry_after();
+	test_budget();
+	return kurlyk::unit_test::report("http_retry_policy_test");
+}
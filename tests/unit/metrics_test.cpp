@@ -0,0 +1,105 @@
+#include <kurlyk.hpp>
+#include "unit_test.hpp"
+
+using kurlyk::metrics::MetricSample;
+using kurlyk::metrics::MetricType;
+using kurlyk::metrics::MetricsRegistry;
+
+namespace {
+
+	bool contains(const std::string& text, const std::string& line) {
+		return text.find(line) != std::string::npos;
+	}
+
+	void test_format_value() {
+		using kurlyk::metrics::format_prometheus_value;
+		KURLYK_CHECK(format_prometheus_value(0) == "0");
+		KURLYK_CHECK(format_prometheus_value(42) == "42");
+		KURLYK_CHECK(format_prometheus_value(0.25) == "0.25");
+		KURLYK_CHECK(format_prometheus_value(std::numeric_limits<double>::infinity()) == "+Inf");
+		KURLYK_CHECK(format_prometheus_value(-std::numeric_limits<double>::infinity()) == "-Inf");
+		KURLYK_CHECK(format_prometheus_value(std::numeric_limits<double>::quiet_NaN()) == "NaN");
+	}
+
+	void test_counter_and_gauge() {
+		std::vector<MetricSample> samples(3);
+		samples[0].name = "requests_total";
+		samples[0].help = "Requests sent";
+		samples[0].labels = "method=\"GET\"";
+		samples[0].value = 3;
+		samples[1] = samples[0];
+		samples[1].labels = "method=\"POST\"";
+		samples[1].value = 1;
+		samples[2].name = "queue_depth";
+		samples[2].type = MetricType::Gauge;
+		samples[2].value = -2;
+
+		// HELP and TYPE are written once per family; a missing help is omitted
+		KURLYK_CHECK(kurlyk::metrics::to_prometheus(samples) ==
+			"# HELP requests_total Requests sent\n"
+			"# TYPE requests_total counter\n"
+			"requests_total{method=\"GET\"} 3\n"
+			"requests_total{method=\"POST\"} 1\n"
+			"# TYPE queue_depth gauge\n"
+			"queue_depth -2\n");
+	}
+
+	void test_histogram() {
+		std::vector<MetricSample> samples(1);
+		samples[0].name = "latency_seconds";
+		samples[0].help = "Latency";
+		samples[0].type = MetricType::Histogram;
+		samples[0].labels = "host=\"a\"";
+		samples[0].bounds = {0.1, 1};
+		samples[0].counts = {1, 3, 4};
+		samples[0].sum = 7.5;
+
+		// Buckets are cumulative and end with +Inf; labels are merged with le
+		KURLYK_CHECK(kurlyk::metrics::to_prometheus(samples) ==
+			"# HELP latency_seconds Latency\n"
+			"# TYPE latency_seconds histogram\n"
+			"latency_seconds_bucket{host=\"a\",le=\"0.1\"} 1\n"
+			"latency_seconds_bucket{host=\"a\",le=\"1\"} 3\n"
+			"latency_seconds_bucket{host=\"a\",le=\"+Inf\"} 4\n"
+			"latency_seconds_sum{host=\"a\"} 7.5\n"
+			"latency_seconds_count{host=\"a\"} 4\n");
+	}
+
+	void test_registry() {
+		auto& registry = MetricsRegistry::get_instance();
+		registry.counter("unit_test_events_total", "Events").inc(2);
+		registry.counter("unit_test_events_total", "Events").inc();
+		registry.gauge("unit_test_level").set(7);
+		auto& histogram = registry.histogram("unit_test_duration_seconds", "Durations", "", {0.5, 2});
+		histogram.observe(0.25);
+		histogram.observe(1.0);
+		histogram.observe(std::chrono::seconds(3));
+
+		const std::string text = kurlyk::metrics::to_prometheus();
+		KURLYK_CHECK(contains(text, "# TYPE unit_test_events_total counter\nunit_test_events_total 3\n"));
+		KURLYK_CHECK(contains(text, "# TYPE unit_test_level gauge\nunit_test_level 7\n"));
+		KURLYK_CHECK(contains(text, "unit_test_duration_seconds_bucket{le=\"0.5\"} 1\n"));
+		KURLYK_CHECK(contains(text, "unit_test_duration_seconds_bucket{le=\"2\"} 2\n"));
+		KURLYK_CHECK(contains(text, "unit_test_duration_seconds_bucket{le=\"+Inf\"} 3\n"));
+		KURLYK_CHECK(contains(text, "unit_test_duration_seconds_sum 4.25\n"));
+		KURLYK_CHECK(contains(text, "unit_test_duration_seconds_count 3\n"));
+
+		// A name cannot be reused with another type
+		bool is_thrown = false;
+		try {
+			registry.gauge("unit_test_events_total");
+		} catch (const std::invalid_argument&) {
+			is_thrown = true;
+		}
+		KURLYK_CHECK(is_thrown);
+	}
+
+} // namespace
+
+int main() {
+	test_format_value();
+	test_counter_and_gauge();
+	test_histogram();
+	test_registry();
+	return kurlyk::unit_test::report("metrics_test");
+}
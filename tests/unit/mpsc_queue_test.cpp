@@ -0,0 +1,96 @@
+#include <kurlyk.hpp>
+#include "unit_test.hpp"
+
+using kurlyk::utils::MpscQueue;
+using kurlyk::utils::MpscQueueNode;
+
+namespace {
+
+	std::atomic<int> g_alive(0);
+
+	struct Item : MpscQueueNode {
+		int producer;
+		int value;
+
+		Item(int producer, int value) : producer(producer), value(value) { ++g_alive; }
+		~Item() { --g_alive; }
+	};
+
+} // namespace
+
+int main() {
+	// Single-threaded FIFO order, size and empty
+	{
+		MpscQueue<Item> queue;
+		KURLYK_CHECK(queue.empty());
+		KURLYK_CHECK(!queue.pop());
+
+		queue.push(nullptr);
+		KURLYK_CHECK(queue.empty());
+
+		for (int i = 0; i < 3; ++i) {
+			queue.push(std::unique_ptr<Item>(new Item(0, i)));
+		}
+		KURLYK_CHECK(queue.size() == 3);
+		for (int i = 0; i < 3; ++i) {
+			auto item = queue.pop();
+			KURLYK_CHECK(item && item->value == i);
+		}
+		KURLYK_CHECK(queue.empty());
+		KURLYK_CHECK(!queue.pop());
+
+		// The queue stays usable after being drained through the stub node
+		queue.push(std::unique_ptr<Item>(new Item(0, 7)));
+		auto item = queue.pop();
+		KURLYK_CHECK(item && item->value == 7);
+	}
+	KURLYK_CHECK(g_alive == 0);
+
+	// Elements left in the queue are deleted with it
+	{
+		MpscQueue<Item> queue;
+		for (int i = 0; i < 10; ++i) {
+			queue.push(std::unique_ptr<Item>(new Item(0, i)));
+		}
+		KURLYK_CHECK(g_alive == 10);
+	}
+	KURLYK_CHECK(g_alive == 0);
+
+	// Concurrent producers: every element arrives once, in per-producer order
+	{
+		const int producers = 4;
+		const int per_producer = 50000;
+		MpscQueue<Item> queue;
+		std::vector<std::thread> threads;
+		for (int p = 0; p < producers; ++p) {
+			threads.emplace_back([&queue, p] {
+				for (int i = 0; i < per_producer; ++i) {
+					queue.push(std::unique_ptr<Item>(new Item(p, i)));
+				}
+			});
+		}
+
+		std::vector<int> next(producers, 0);
+		int received = 0;
+		bool in_order = true;
+		while (received < producers * per_producer) {
+			auto item = queue.pop();
+			if (!item) {
+				std::this_thread::yield();
+				continue;
+			}
+			if (item->value != next[item->producer]) in_order = false;
+			next[item->producer] = item->value + 1;
+			++received;
+		}
+		for (auto& thread : threads) thread.join();
+
+		KURLYK_CHECK(in_order);
+		KURLYK_CHECK(received == producers * per_producer);
+		KURLYK_CHECK(queue.empty());
+		KURLYK_CHECK(!queue.pop());
+	}
+	KURLYK_CHECK(g_alive == 0);
+
+	return kurlyk::unit_test::report("mpsc_queue_test");
+}
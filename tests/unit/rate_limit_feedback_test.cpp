@@ -0,0 +1,128 @@
+#include <ctime>
+#include <kurlyk.hpp>
+#include "unit_test.hpp"
+
+using kurlyk::Headers;
+using kurlyk::RateLimitFeedback;
+using kurlyk::RateLimitResetFormat;
+
+namespace {
+
+	using time_point_t = RateLimitFeedback::time_point_t;
+
+	const time_point_t now = std::chrono::steady_clock::now();
+
+	/// Returns the Unix time in milliseconds corresponding to `now`.
+	int64_t unix_now_ms() {
+		return std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count();
+	}
+
+	/// Checks that a parsed time is within the tolerance of the expected offset from `now`.
+	bool is_near(time_point_t value, std::chrono::milliseconds offset) {
+		const auto error = value - (now + offset);
+		return error < std::chrono::seconds(2) && error > -std::chrono::seconds(2);
+	}
+
+	void test_remaining() {
+		RateLimitFeedback feedback;
+		feedback.remaining_header = "X-RateLimit-Remaining";
+		feedback.used_header = "X-MBX-USED-WEIGHT-1M";
+		long remaining = -1;
+
+		Headers none;
+		KURLYK_CHECK(!feedback.parse_remaining(none, 1200, remaining));
+
+		Headers used;
+		used.emplace("x-mbx-used-weight-1m", "200");
+		KURLYK_CHECK(feedback.parse_remaining(used, 1200, remaining));
+		KURLYK_CHECK(remaining == 1000);
+
+		// The remaining header takes precedence over the used one
+		Headers both = used;
+		both.emplace("X-RateLimit-Remaining", "7");
+		KURLYK_CHECK(feedback.parse_remaining(both, 1200, remaining));
+		KURLYK_CHECK(remaining == 7);
+
+		// Values that are not numbers are ignored
+		Headers invalid;
+		invalid.emplace("X-RateLimit-Remaining", "n/a");
+		remaining = -1;
+		KURLYK_CHECK(!feedback.parse_remaining(invalid, 1200, remaining));
+		Headers empty;
+		empty.emplace("X-RateLimit-Remaining", "");
+		KURLYK_CHECK(!feedback.parse_remaining(empty, 1200, remaining));
+		KURLYK_CHECK(remaining == -1);
+	}
+
+	void test_reset_time() {
+		RateLimitFeedback feedback;
+		time_point_t reset_time;
+		Headers headers;
+		KURLYK_CHECK(!feedback.parse_reset_time(headers, now, reset_time));
+
+		feedback.reset_header = "X-RateLimit-Reset";
+		KURLYK_CHECK(!feedback.parse_reset_time(headers, now, reset_time));
+
+		headers.emplace("X-RateLimit-Reset", "30");
+		feedback.reset_format = RateLimitResetFormat::RL_RESET_DELTA_SECONDS;
+		KURLYK_CHECK(feedback.parse_reset_time(headers, now, reset_time));
+		KURLYK_CHECK(reset_time == now + std::chrono::seconds(30));
+
+		Headers unix_seconds;
+		unix_seconds.emplace("X-RateLimit-Reset", std::to_string(unix_now_ms() / 1000 + 60));
+		feedback.reset_format = RateLimitResetFormat::RL_RESET_UNIX_SECONDS;
+		KURLYK_CHECK(feedback.parse_reset_time(unix_seconds, now, reset_time));
+		KURLYK_CHECK(is_near(reset_time, std::chrono::seconds(60)));
+
+		Headers unix_ms;
+		unix_ms.emplace("X-RateLimit-Reset", std::to_string(unix_now_ms() + 5000));
+		feedback.reset_format = RateLimitResetFormat::RL_RESET_UNIX_MS;
+		KURLYK_CHECK(feedback.parse_reset_time(unix_ms, now, reset_time));
+		KURLYK_CHECK(is_near(reset_time, std::chrono::seconds(5)));
+	}
+
+	void test_retry_after() {
+		time_point_t retry_time;
+		Headers none;
+		KURLYK_CHECK(!RateLimitFeedback::parse_retry_after(none, now, retry_time));
+
+		Headers seconds;
+		seconds.emplace("retry-after", "120");
+		KURLYK_CHECK(RateLimitFeedback::parse_retry_after(seconds, now, retry_time));
+		KURLYK_CHECK(retry_time == now + std::chrono::seconds(120));
+
+		// Negative delays do not move the time into the past
+		Headers negative;
+		negative.emplace("Retry-After", "-5");
+		KURLYK_CHECK(RateLimitFeedback::parse_retry_after(negative, now, retry_time));
+		KURLYK_CHECK(retry_time == now);
+
+		// HTTP date, 90 seconds from now
+		const std::time_t date = static_cast<std::time_t>(unix_now_ms() / 1000 + 90);
+		char buffer[64];
+		std::tm tm_utc;
+#		if defined(_WIN32)
+		gmtime_s(&tm_utc, &date);
+#		else
+		gmtime_r(&date, &tm_utc);
+#		endif
+		std::strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &tm_utc);
+		Headers http_date;
+		http_date.emplace("Retry-After", buffer);
+		KURLYK_CHECK(RateLimitFeedback::parse_retry_after(http_date, now, retry_time));
+		KURLYK_CHECK(is_near(retry_time, std::chrono::seconds(90)));
+
+		Headers invalid;
+		invalid.emplace("Retry-After", "soon");
+		KURLYK_CHECK(!RateLimitFeedback::parse_retry_after(invalid, now, retry_time));
+	}
+
+} // namespace
+
+int main() {
+	test_remaining();
+	test_reset_time();
+	test_retry_after();
+	return kurlyk::unit_test::report("rate_limit_feedback_test");
+}
@@ -0,0 +1,210 @@
+#include <kurlyk.hpp>
+#include "unit_test.hpp"
+
+using kurlyk::RateLimitAlgorithm;
+using kurlyk::utils::RateLimitState;
+
+namespace {
+
+	const RateLimitState::time_point_t start = RateLimitState::clock_t::now();
+
+	RateLimitState::time_point_t at(long ms) {
+		return start + std::chrono::milliseconds(ms);
+	}
+
+	/// Checks and consumes a request, as the rate limiters do.
+	bool try_consume(RateLimitState& state, RateLimitState::time_point_t now, long weight = 1) {
+		if (!state.check(now, weight)) return false;
+		state.consume(now, weight);
+		return true;
+	}
+
+	void test_unlimited() {
+		RateLimitState state(0, 1000, RateLimitAlgorithm::RL_FIXED_WINDOW, 1, start);
+		for (int i = 0; i < 1000; ++i) {
+			KURLYK_CHECK(try_consume(state, start));
+		}
+		KURLYK_CHECK(state.next_allowed_time(start) == start);
+	}
+
+	void test_fixed_window() {
+		RateLimitState state(3, 1000, RateLimitAlgorithm::RL_FIXED_WINDOW, 1, start);
+		KURLYK_CHECK(try_consume(state, at(0)));
+		KURLYK_CHECK(try_consume(state, at(10)));
+		KURLYK_CHECK(try_consume(state, at(20)));
+		KURLYK_CHECK(!state.check(at(30)));
+		KURLYK_CHECK(state.next_allowed_time(at(30)) == at(1000));
+		KURLYK_CHECK(state.time_until_allowed(at(400)) == std::chrono::milliseconds(600));
+		KURLYK_CHECK(!state.check(at(999)));
+
+		// A new window starts at the first request after the old one ends
+		KURLYK_CHECK(try_consume(state, at(1000)));
+		KURLYK_CHECK(try_consume(state, at(1500)));
+		KURLYK_CHECK(try_consume(state, at(1999)));
+		KURLYK_CHECK(!state.check(at(1999)));
+		KURLYK_CHECK(state.next_allowed_time(at(1999)) == at(2000));
+	}
+
+	void test_gcra_spacing() {
+		// 4 requests per 400 ms with a burst of 1: one request every 100 ms
+		RateLimitState state(4, 400, RateLimitAlgorithm::RL_GCRA, 1, start);
+		KURLYK_CHECK(try_consume(state, at(0)));
+		KURLYK_CHECK(!state.check(at(0)));
+		KURLYK_CHECK(state.next_allowed_time(at(0)) == at(100));
+		KURLYK_CHECK(!state.check(at(99)));
+		KURLYK_CHECK(try_consume(state, at(100)));
+		KURLYK_CHECK(state.next_allowed_time(at(150)) == at(200));
+
+		// Idle time is not banked beyond the burst
+		KURLYK_CHECK(try_consume(state, at(1000)));
+		KURLYK_CHECK(!state.check(at(1000)));
+		KURLYK_CHECK(state.next_allowed_time(at(1000)) == at(1100));
+
+		// Any window of 400 ms admits at most 4 requests
+		RateLimitState spaced(4, 400, RateLimitAlgorithm::RL_GCRA, 1, start);
+		int admitted = 0;
+		for (long ms = 0; ms < 400; ++ms) {
+			if (try_consume(spaced, at(ms))) ++admitted;
+		}
+		KURLYK_CHECK(admitted == 4);
+	}
+
+	void test_gcra_burst() {
+		// 10 requests per second with a burst of 3
+		RateLimitState state(10, 1000, RateLimitAlgorithm::RL_GCRA, 3, start);
+		KURLYK_CHECK(try_consume(state, at(0)));
+		KURLYK_CHECK(try_consume(state, at(0)));
+		KURLYK_CHECK(try_consume(state, at(0)));
+		KURLYK_CHECK(!state.check(at(0)));
+		KURLYK_CHECK(state.next_allowed_time(at(0)) == at(100));
+		KURLYK_CHECK(try_consume(state, at(100)));
+		KURLYK_CHECK(!state.check(at(100)));
+
+		// After an idle period the full burst is available again, but no more
+		KURLYK_CHECK(try_consume(state, at(5000)));
+		KURLYK_CHECK(try_consume(state, at(5000)));
+		KURLYK_CHECK(try_consume(state, at(5000)));
+		KURLYK_CHECK(!state.check(at(5000)));
+
+		// Burst values below 1 are treated as 1
+		RateLimitState no_burst(10, 1000, RateLimitAlgorithm::RL_GCRA, 0, start);
+		KURLYK_CHECK(no_burst.burst == 1);
+		KURLYK_CHECK(try_consume(no_burst, at(0)));
+		KURLYK_CHECK(!no_burst.check(at(0)));
+	}
+
+	void test_weights() {
+		// A fixed window admits requests while their total weight fits in the budget
+		RateLimitState window(10, 1000, RateLimitAlgorithm::RL_FIXED_WINDOW, 1, start);
+		KURLYK_CHECK(try_consume(window, at(0), 6));
+		KURLYK_CHECK(!window.check(at(0), 5));
+		KURLYK_CHECK(window.check(at(0), 4));
+		KURLYK_CHECK(try_consume(window, at(0), 4));
+		KURLYK_CHECK(!window.check(at(0), 1));
+		KURLYK_CHECK(window.next_allowed_time(at(0), 1) == at(1000));
+
+		// Weights below 1 count as 1
+		RateLimitState light(2, 1000, RateLimitAlgorithm::RL_FIXED_WINDOW, 1, start);
+		KURLYK_CHECK(try_consume(light, at(0), 0));
+		KURLYK_CHECK(try_consume(light, at(0), -5));
+		KURLYK_CHECK(!light.check(at(0), 0));
+
+		// A request heavier than the budget is charged the full budget instead of blocking forever
+		RateLimitState heavy(10, 1000, RateLimitAlgorithm::RL_FIXED_WINDOW, 1, start);
+		KURLYK_CHECK(try_consume(heavy, at(0), 50));
+		KURLYK_CHECK(!heavy.check(at(0), 1));
+		KURLYK_CHECK(try_consume(heavy, at(1000), 50));
+
+		// GCRA advances the TAT by weight * interval (10 per second: 100 ms per unit)
+		RateLimitState gcra(10, 1000, RateLimitAlgorithm::RL_GCRA, 5, start);
+		KURLYK_CHECK(try_consume(gcra, at(0), 5));
+		KURLYK_CHECK(gcra.next_allowed_time(at(0), 1) == at(100));
+		KURLYK_CHECK(gcra.next_allowed_time(at(0), 3) == at(300));
+		KURLYK_CHECK(gcra.next_allowed_time(at(0), 5) == at(500));
+
+		// A request heavier than the burst waits until the whole TAT has passed
+		KURLYK_CHECK(gcra.next_allowed_time(at(0), 8) == at(500));
+		KURLYK_CHECK(try_consume(gcra, at(500), 8));
+		KURLYK_CHECK(gcra.next_allowed_time(at(500), 1) == at(900));
+	}
+
+	void test_pause() {
+		// A pause blocks a GCRA limit even though its TAT allows the request
+		RateLimitState gcra(10, 1000, RateLimitAlgorithm::RL_GCRA, 1, start);
+		KURLYK_CHECK(try_consume(gcra, at(0)));
+		gcra.pause_until(at(2000));
+		KURLYK_CHECK(!gcra.check(at(100)));
+		KURLYK_CHECK(!gcra.check(at(1999)));
+		KURLYK_CHECK(gcra.next_allowed_time(at(100)) == at(2000));
+		KURLYK_CHECK(gcra.check(at(2000)));
+
+		// A pause of a full fixed window outlasts the window boundary
+		RateLimitState window(2, 1000, RateLimitAlgorithm::RL_FIXED_WINDOW, 1, start);
+		KURLYK_CHECK(try_consume(window, at(0)));
+		KURLYK_CHECK(try_consume(window, at(0)));
+		window.pause_until(at(3000));
+		KURLYK_CHECK(!window.check(at(1000)));
+		KURLYK_CHECK(!window.check(at(2999)));
+		KURLYK_CHECK(window.next_allowed_time(at(1000)) == at(3000));
+		KURLYK_CHECK(try_consume(window, at(3000)));
+
+		// A pause also blocks a fixed window with budget left, and an unlimited limit
+		RateLimitState idle(5, 1000, RateLimitAlgorithm::RL_FIXED_WINDOW, 1, start);
+		idle.pause_until(at(500));
+		KURLYK_CHECK(!idle.check(at(0)));
+		KURLYK_CHECK(idle.check(at(500)));
+		RateLimitState unlimited(0, 0, RateLimitAlgorithm::RL_FIXED_WINDOW, 1, start);
+		unlimited.pause_until(at(500));
+		KURLYK_CHECK(!unlimited.check(at(0)));
+		KURLYK_CHECK(unlimited.check(at(500)));
+
+		// An earlier pause is never shortened
+		idle.pause_until(at(5000));
+		idle.pause_until(at(1000));
+		KURLYK_CHECK(!idle.check(at(4999)));
+		KURLYK_CHECK(idle.check(at(5000)));
+	}
+
+	void test_set_remaining() {
+		// No remaining quota pauses the limit until the server window resets
+		RateLimitState gcra(10, 1000, RateLimitAlgorithm::RL_GCRA, 3, start);
+		gcra.set_remaining(0, at(1500), at(0));
+		KURLYK_CHECK(!gcra.check(at(1499)));
+		KURLYK_CHECK(gcra.check(at(1500)));
+
+		RateLimitState window(10, 1000, RateLimitAlgorithm::RL_FIXED_WINDOW, 1, start);
+		KURLYK_CHECK(try_consume(window, at(0)));
+		window.set_remaining(0, at(2500), at(100));
+		KURLYK_CHECK(!window.check(at(2000)));
+		KURLYK_CHECK(try_consume(window, at(2500)));
+
+		// A reported quota replaces the locally counted one in both directions
+		RateLimitState tighter(10, 1000, RateLimitAlgorithm::RL_FIXED_WINDOW, 1, start);
+		tighter.set_remaining(2, RateLimitState::time_point_t(), at(0));
+		KURLYK_CHECK(try_consume(tighter, at(0)));
+		KURLYK_CHECK(try_consume(tighter, at(0)));
+		KURLYK_CHECK(!tighter.check(at(0)));
+		tighter.set_remaining(5, RateLimitState::time_point_t(), at(10));
+		KURLYK_CHECK(try_consume(tighter, at(10), 5));
+		KURLYK_CHECK(!tighter.check(at(10)));
+
+		// With GCRA up to min(remaining, burst) requests become available at once
+		RateLimitState burst(10, 1000, RateLimitAlgorithm::RL_GCRA, 3, start);
+		burst.set_remaining(2, RateLimitState::time_point_t(), at(0));
+		KURLYK_CHECK(try_consume(burst, at(0)));
+		KURLYK_CHECK(try_consume(burst, at(0)));
+		KURLYK_CHECK(!burst.check(at(0)));
+	}
+
+} // namespace
+
+int main() {
+	test_unlimited();
+	test_fixed_window();
+	test_gcra_spacing();
+	test_gcra_burst();
+	test_weights();
+	test_pause();
+	test_set_remaining();
+	return kurlyk::unit_test::report("rate_limit_state_test");
+}
@@ -0,0 +1,34 @@
+Write-Host "Start script for unit tests" -ForegroundColor Magenta
+$ScriptDir = Split-Path -Parent $MyInvocation.MyCommand.Path # расположение самого скрипта
+$BuildDir  = Join-Path $ScriptDir "build"
+
+Write-Host "--- Configure ---" -ForegroundColor cyan
+cmake 	-S $ScriptDir `
+		-B $BuildDir `
+		-G "MinGW Makefiles" `
+		-DCMAKE_C_COMPILER=gcc `
+		-DCMAKE_CXX_COMPILER=g++ `
+		-Wno-dev
+			
+if ($LASTEXITCODE -ne 0) {
+	Write-Error "Configure failed"
+	exit $LASTEXITCODE
+}
+	
+Write-Host "--- Build ---" -ForegroundColor Cyan
+cmake --build "$BuildDir"
+
+if ($LASTEXITCODE -ne 0) {
+  Write-Error "Build failed"
+  exit $LASTEXITCODE
+}
+
+Write-Host "--- Run ---" -ForegroundColor Cyan
+ctest --test-dir "$BuildDir" --output-on-failure
+
+if ($LASTEXITCODE -ne 0) {
+  Write-Error "Unit tests failed"
+  exit $LASTEXITCODE
+}
+
+Write-Host "All unit tests passed." -ForegroundColor Green
@@ -0,0 +1,111 @@
+#include <kurlyk.hpp>
+#include "unit_test.hpp"
+
+using kurlyk::core::TimerQueue;
+
+int main() {
+	const auto start = TimerQueue::clock_t::now();
+	const auto at = [start](int ms) { return start + std::chrono::milliseconds(ms); };
+
+	// Empty queue
+	{
+		TimerQueue queue;
+		KURLYK_CHECK(queue.empty());
+		KURLYK_CHECK(queue.next_deadline() == TimerQueue::time_point_t::max());
+		KURLYK_CHECK(queue.time_until_next(start) == TimerQueue::duration_t::max());
+		KURLYK_CHECK(queue.process(at(1000)) == 0);
+	}
+
+	// Timers run in deadline order, and only once they expire
+	{
+		TimerQueue queue;
+		std::vector<int> order;
+		queue.add_timer(at(30), [&order] { order.push_back(30); });
+		queue.add_timer(at(10), [&order] { order.push_back(10); });
+		queue.add_timer(at(20), [&order] { order.push_back(20); });
+
+		KURLYK_CHECK(queue.next_deadline() == at(10));
+		KURLYK_CHECK(queue.time_until_next(at(4)) == std::chrono::milliseconds(6));
+		KURLYK_CHECK(queue.time_until_next(at(15)) == TimerQueue::duration_t::zero());
+
+		KURLYK_CHECK(queue.process(at(9)) == 0);
+		KURLYK_CHECK(queue.process(at(20)) == 2);
+		KURLYK_CHECK((order == std::vector<int>{10, 20}));
+		KURLYK_CHECK(queue.next_deadline() == at(30));
+
+		KURLYK_CHECK(queue.process(at(30)) == 1);
+		KURLYK_CHECK((order == std::vector<int>{10, 20, 30}));
+		KURLYK_CHECK(queue.empty());
+	}
+
+	// Timers with equal deadlines run in the order they were added
+	{
+		TimerQueue queue;
+		std::vector<int> order;
+		for (int i = 0; i < 5; ++i) {
+			queue.add_timer(at(10), [&order, i] { order.push_back(i); });
+		}
+		KURLYK_CHECK(queue.process(at(10)) == 5);
+		KURLYK_CHECK((order == std::vector<int>{0, 1, 2, 3, 4}));
+	}
+
+	// Cancelled timers never run and no longer define the next deadline
+	{
+		TimerQueue queue;
+		int calls = 0;
+		const auto first = queue.add_timer(at(10), [&calls] { ++calls; });
+		const auto second = queue.add_timer(at(20), [&calls] { ++calls; });
+		KURLYK_CHECK(first != 0 && second != 0 && first != second);
+
+		KURLYK_CHECK(queue.cancel_timer(first));
+		KURLYK_CHECK(!queue.cancel_timer(first));
+		KURLYK_CHECK(queue.next_deadline() == at(20));
+		KURLYK_CHECK(queue.process(at(100)) == 1);
+		KURLYK_CHECK(calls == 1);
+		KURLYK_CHECK(!queue.cancel_timer(second));
+	}
+
+	// Cancelling most of a large heap compacts it without losing live timers
+	{
+		TimerQueue queue;
+		std::vector<TimerQueue::timer_id_t> ids;
+		int calls = 0;
+		for (int i = 0; i < 200; ++i) {
+			ids.push_back(queue.add_timer(at(i), [&calls] { ++calls; }));
+		}
+		for (int i = 0; i < 200; ++i) {
+			if (i % 10 != 0) KURLYK_CHECK(queue.cancel_timer(ids[i]));
+		}
+		KURLYK_CHECK(queue.next_deadline() == at(0));
+		KURLYK_CHECK(queue.process(at(1000)) == 20);
+		KURLYK_CHECK(calls == 20);
+		KURLYK_CHECK(queue.empty());
+	}
+
+	// A callback may schedule a new timer; it runs on a later process() call
+	{
+		TimerQueue queue;
+		int calls = 0;
+		queue.add_timer(at(10), [&queue, &calls, &at] {
+			++calls;
+			queue.add_timer(at(5), [&calls] { ++calls; });
+		});
+		KURLYK_CHECK(queue.process(at(10)) == 1);
+		KURLYK_CHECK(calls == 1);
+		KURLYK_CHECK(queue.process(at(10)) == 1);
+		KURLYK_CHECK(calls == 2);
+	}
+
+	// clear() drops timers without running them
+	{
+		TimerQueue queue;
+		int calls = 0;
+		queue.add_timer(at(10), [&calls] { ++calls; });
+		queue.clear();
+		KURLYK_CHECK(queue.empty());
+		KURLYK_CHECK(queue.process(at(100)) == 0);
+		KURLYK_CHECK(calls == 0);
+	}
+
+	return kurlyk::unit_test::report("timer_queue_test");
+}
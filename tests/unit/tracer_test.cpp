@@ -0,0 +1,81 @@
+// A small ring buffer makes the wraparound easy to reach
+#define KURLYK_TRACE_BUFFER_SIZE 4
+
+#include <kurlyk.hpp>
+#include "unit_test.hpp"
+
+using kurlyk::tracing::TraceSpan;
+using kurlyk::tracing::Tracer;
+
+namespace {
+
+	void test_trace_id() {
+		auto& tracer = Tracer::get_instance();
+		const uint64_t first = tracer.generate_trace_id();
+		const uint64_t second = tracer.generate_trace_id();
+		KURLYK_CHECK(first != 0);
+		KURLYK_CHECK(second > first);
+	}
+
+	void test_ring_buffer() {
+		auto& tracer = Tracer::get_instance();
+		tracer.clear();
+		const auto now = std::chrono::steady_clock::now();
+		for (uint64_t id = 1; id <= 3; ++id) {
+			tracer.record("queued", id, now, now);
+		}
+		auto spans = tracer.snapshot();
+		KURLYK_CHECK(spans.size() == 3);
+		KURLYK_CHECK(spans.size() == 3 && spans[0].trace_id == 1 && spans[2].trace_id == 3);
+
+		// Once full, the oldest spans are overwritten and the snapshot stays ordered
+		for (uint64_t id = 4; id <= 10; ++id) {
+			tracer.record("queued", id, now, now);
+		}
+		spans = tracer.snapshot();
+		KURLYK_CHECK(spans.size() == KURLYK_TRACE_BUFFER_SIZE);
+		for (std::size_t i = 0; i < spans.size(); ++i) {
+			KURLYK_CHECK(spans[i].trace_id == 7 + i);
+		}
+
+		tracer.clear();
+		KURLYK_CHECK(tracer.snapshot().empty());
+	}
+
+	void test_chrome_trace_json() {
+		auto& tracer = Tracer::get_instance();
+		tracer.clear();
+		KURLYK_CHECK(tracer.to_chrome_trace_json() == "{\"traceEvents\":[],\"displayTimeUnit\":\"ms\"}");
+
+		const auto start = std::chrono::steady_clock::now();
+		tracer.record("dns", 5, start, start + std::chrono::microseconds(1500));
+		tracer.record("transfer", 5, start + std::chrono::microseconds(1500), start + std::chrono::milliseconds(3));
+
+		const auto spans = tracer.snapshot();
+		KURLYK_CHECK(spans.size() == 2);
+		if (spans.size() != 2) return;
+		KURLYK_CHECK(spans[0].thread_hash == std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+		// Timestamps are relative to the tracer creation, so only the event shape is compared
+		const std::string json = tracer.to_chrome_trace_json();
+		const std::string thread = std::to_string(spans[0].thread_hash);
+		KURLYK_CHECK(json.compare(0, 16, "{\"traceEvents\":[") == 0);
+		KURLYK_CHECK(json.find("{\"name\":\"dns\",\"cat\":\"kurlyk\",\"ph\":\"X\",\"pid\":1,\"tid\":5,\"ts\":") != std::string::npos);
+		KURLYK_CHECK(json.find(",\"dur\":1500,\"args\":{\"thread\":" + thread + "}},{\"name\":\"transfer\"") != std::string::npos);
+		KURLYK_CHECK(json.find(",\"dur\":1500,\"args\":{\"thread\":" + thread + "}}],\"displayTimeUnit\":\"ms\"}") != std::string::npos);
+
+		// A span ending before it starts has a zero duration
+		tracer.clear();
+		tracer.record("queued", 6, start + std::chrono::milliseconds(1), start);
+		KURLYK_CHECK(tracer.to_chrome_trace_json().find(",\"dur\":0,") != std::string::npos);
+		tracer.clear();
+	}
+
+} // namespace
+
+int main() {
+	test_trace_id();
+	test_ring_buffer();
+	test_chrome_trace_json();
+	return kurlyk::unit_test::report("tracer_test");
+}
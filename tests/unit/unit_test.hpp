@@ -0,0 +1,45 @@
+#pragma once
+#ifndef _KURLYK_UNIT_TEST_HPP_INCLUDED
+#define _KURLYK_UNIT_TEST_HPP_INCLUDED
+
+/// \file unit_test.hpp
+/// \brief Minimal assertion helpers shared by the unit tests.
+
+#include <iostream>
+
+namespace kurlyk::unit_test {
+
+    /// \brief Returns the number of failed checks so far.
+    inline int& failures() {
+        static int count = 0;
+        return count;
+    }
+
+    /// \brief Records a failed check if the condition is false.
+    /// \param condition Checked condition.
+    /// \param expression Text of the condition.
+    /// \param line Source line of the check.
+    inline void check(bool condition, const char* expression, int line) {
+        if (condition) return;
+        std::cerr << "Check failed at line " << line << ": " << expression << std::endl;
+        ++failures();
+    }
+
+    /// \brief Prints the result of the test.
+    /// \param name Name of the test.
+    /// \return Exit code of the test program.
+    inline int report(const char* name) {
+        if (failures() != 0) {
+            std::cerr << name << ": " << failures() << " check(s) failed" << std::endl;
+            return 1;
+        }
+        std::cout << name << ": all checks passed" << std::endl;
+        return 0;
+    }
+
+} // namespace kurlyk::unit_test
+
+/// \brief Checks a condition and reports the failed expression with its line.
+#define KURLYK_CHECK(condition) ::kurlyk::unit_test::check(static_cast<bool>(condition), #condition, __LINE__)
+
+#endif // _KURLYK_UNIT_TEST_HPP_INCLUDED